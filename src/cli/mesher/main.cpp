@@ -41,6 +41,7 @@
 /* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
 #include <cleaver/Cleaver.h>
 #include <cleaver/CleaverMesher.h>
+#include <cleaver/InterleavedVolume.h>
 #include <cleaver/InverseField.h>
 #include <cleaver/SizingFieldCreator.h>
 #include <cleaver/Timer.h>
@@ -50,6 +51,7 @@
 
 // STL Includes
 #include <exception>
+#include <stdexcept>
 #include <iostream>
 #include <vector>
 #include <sstream>
@@ -68,6 +70,13 @@ const std::string vtkPoly = "vtkPoly";
 const std::string vtkUSG = "vtkUSG";
 const std::string ply = "ply";
 
+const std::string morton = "morton";
+const std::string rcm = "rcm";
+
+const std::string float32 = "float32";
+const std::string float16 = "float16";
+const std::string int16 = "int16";
+
 const std::string kDefaultOutputPath = "./";
 const std::string kDefaultOutputName = "output";
 const cleaver::MeshFormat kDefaultOutputFormat = cleaver::Tetgen;
@@ -80,6 +89,7 @@ const double kDefaultLipschitz = 0.2;
 const double kDefaultFeatureScaling = 1.0;
 const int    kDefaultPadding = 0;
 const int    kDefaultMaxIterations = 1000;
+const unsigned int kDefaultThreads = 1;
 const double kDefaultSigma = 1.;
 
 // Entry Point
@@ -108,6 +118,15 @@ int main(int argc, char* argv[])
   std::string recording_input;
   bool strict = false;
   bool strip_exterior = false;
+  bool reorder_morton = false;
+  bool reorder_rcm = false;
+  bool parallel_warp = false;
+  bool interleave = false;
+  bool label_volume = false;
+  cleaver::FieldPrecision precision = cleaver::Float32;
+  bool deterministic = false;
+  unsigned int threads = kDefaultThreads;
+  size_t grain_size = 0;
   enum cleaver::MeshType element_sizing_method = cleaver::Adaptive;
   cleaver::MeshFormat output_format = kDefaultOutputFormat;
   double sigma = kDefaultSigma;
@@ -126,6 +145,8 @@ int main(int argc, char* argv[])
     std::string format_string;
     bool indicator_functions = false;
     bool show_version = false;
+    std::string reorder_string;
+    std::string precision_string;
 
     CLI::App app{ "Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library - mesher" };
     //po::options_description description("Command line flags");
@@ -133,23 +154,31 @@ int main(int argc, char* argv[])
     app.add_option("-s,--alpha_short", alpha_short, "alpha short value for constant element sizing method");
     app.add_option("-l,--alpha_long", alpha_long, "alpha long value for constant element sizing method");
     app.add_option("-b,--background_mesh", background_mesh, "input background mesh");
+    app.add_flag("--deterministic", deterministic, "guarantee bitwise identical output for any thread count (current stages already are)");
     app.add_option("-B,--blend_sigma", sigma, "blending function sigma for input(s) to remove alias artifacts");
     app.add_option("-m,--element_sizing_method", element_sizing_method_string, "background mesh mode (adaptive [default], constant)");
+    app.add_option("--field_precision", precision_string, "storage precision of the input and sizing fields (float32 [default], float16, int16)");
     app.add_option("-F,--feature_scaling", feature_scaling, "feature size scaling (higher values make a coarser mesh)");
     app.add_flag("-j,--fix_tet_windup", fix_tets, "ensure positive Jacobians with proper vertex wind-up");
     //app.add_option("-h,--help", show_help, "display help message");
     app.add_option("-i,--input_files", material_fields, "material field paths or segmentation path");
+    app.add_flag("--interleave", interleave, "store material values interleaved per voxel for faster lookups");
+    app.add_flag("--label_volume", label_volume, "mesh a segmentation from its label map and a narrow band instead of full indicator functions");
     app.add_option("-L,--lipschitz", lipschitz, "maximum rate of change of element size (1 is uniform)");
+    app.add_option("--grain_size", grain_size, "iterations per chunk in the parallel cleaving loops (default 0, each loop picks)");
     app.add_option("-f,--output_format", format_string, "output mesh format (tetgen [default], scirun, matlab, vtkUSG, vtkPoly, ply [surface mesh only])");
     app.add_option("-n,--output_name", output_name, "output mesh name (default 'output')");
     app.add_option("-o,--output_path", output_path, "output path prefix");
+    app.add_flag("--parallel_warp", parallel_warp, "warp vertex violations in parallel by conflict free colors (ordering differs from serial)");
     //app.add_option("-p,--padding", padding, "volume padding");
     app.add_option("-r,--record", recording_input, "record operations on tets from input file");
     app.add_option("-R,--sampling_rate", sampling_rate, "volume sampling rate (lower values make a coarser mesh)");
+    app.add_option("--reorder", reorder_string, "reorder mesh elements for memory locality or bandwidth (none [default], morton, rcm)");
     app.add_flag("-I,--indicator_functions", indicator_functions, "the input files are indicator functions");
     app.add_flag("--simple", simple, "use simple interface approximation");
     app.add_option("-z,--sizing_field", sizing_field, "sizing field path");
     app.add_flag("-t,--strict", strict, "warnings become errors");
+    app.add_option("--threads", threads, "number of worker threads (default 1, 0 uses all hardware threads)");
     app.add_flag("-e,--strip_exterior", strip_exterior, "strip exterior tetrahedra");
     app.add_flag("-w,--write_background_mesh", write_background_mesh, "write background mesh");
     app.add_flag("-v,--verbose", verbose, "enable verbose output");
@@ -264,6 +293,32 @@ int main(int argc, char* argv[])
       }
     }
 
+    // parse the element reordering method
+    if (!reorder_string.empty()) {
+      if (reorder_string.compare(morton) == 0) {
+        reorder_morton = true;
+      } else if (reorder_string.compare(rcm) == 0) {
+        reorder_rcm = true;
+      } else if (reorder_string.compare("none") != 0) {
+        std::cerr << "Error: invalid reordering method: " << reorder_string << std::endl;
+        std::cerr << "Valid Methods: [none] [morton] [rcm] " << std::endl;
+        return 12;
+      }
+    }
+
+    // parse the field storage precision
+    if (!precision_string.empty()) {
+      if (precision_string.compare(float16) == 0) {
+        precision = cleaver::Float16;
+      } else if (precision_string.compare(int16) == 0) {
+        precision = cleaver::Int16;
+      } else if (precision_string.compare(float32) != 0) {
+        std::cerr << "Error: invalid field precision: " << precision_string << std::endl;
+        std::cerr << "Valid Precisions: [float32] [float16] [int16] " << std::endl;
+        return 12;
+      }
+    }
+
   } catch (std::exception& e) {
     std::cerr << "Error: " << e.what() << std::endl;
     return 8;
@@ -285,8 +340,13 @@ int main(int argc, char* argv[])
     return 10;
   }
   if (segmentation && material_fields.size() == 1) {
-    fields = NRRDTools::segmentationToIndicatorFunctions(material_fields[0], sigma);
+    if (!label_volume)
+      fields = NRRDTools::segmentationToIndicatorFunctions(material_fields[0], sigma, precision);
   } else {
+    if (label_volume) {
+      std::cerr << "Warning: --label_volume needs a single segmentation input, it will be ignored." << std::endl;
+      label_volume = false;
+    }
     if (segmentation && material_fields.size() > 1) {
       std::cerr << "Warning: More than 1 input provided for segmentation." << std::endl
                 << "This will be assumed to be indicator functions." << std::endl;
@@ -300,7 +360,7 @@ int main(int argc, char* argv[])
         std::cout << " - " << material_fields[i] << std::endl;
       }
     }
-    fields = NRRDTools::loadNRRDFiles(material_fields,sigma);
+    fields = NRRDTools::loadNRRDFiles(material_fields, sigma, precision);
     if (fields.empty()) {
       std::cerr << "Failed to load image data. Terminating." << std::endl;
       return 10;
@@ -319,24 +379,56 @@ int main(int argc, char* argv[])
       continue;
     }
     //Check for critical errors
-    auto error = ((cleaver::ScalarField<float>*)fields[i])->getError();
+    auto error = fields[i]->getError();
     if (error.compare("nan") == 0 || error.compare("maxmin") == 0)
     {
       std::cerr << "Nrrd file read error: No zero crossing in indicator function. Not a valid file or need a lower sigma value." << std::endl;
       return 11;
     }
     //Check for warning
-    auto warning = ((cleaver::ScalarField<float>*)fields[i])->getWarning();
+    auto warning = fields[i]->getWarning();
     if (warning)
     {
       std::cerr << "Nrrd file read WARNING: Sigma is 10% of volume's size. Gaussian kernel may be truncated." << std::endl;
     }
   }
 
-  cleaver::Volume *volume = new cleaver::Volume(fields);
   cleaver::CleaverMesher mesher(simple);
+  mesher.setExecutionPolicy(threads, grain_size, deterministic);
+
+  cleaver::Volume *volume = nullptr;
+  if (label_volume) {
+    cleaver::LabelVolume *labels =
+      NRRDTools::loadLabelVolume(material_fields[0], sigma, &mesher.threadPool());
+    if (!labels) {
+      std::cerr << "Failed to load image data. Terminating." << std::endl;
+      return 10;
+    }
+    if (verbose) {
+      std::cout << " " << labels->bandBrickCount() << " of " << labels->brickCount()
+                << " bricks lie in the label boundary band." << std::endl;
+    }
+    volume = labels;
+  } else {
+    volume = new cleaver::Volume(fields);
+  }
+  if (interleave) {
+    try {
+      cleaver::Volume *interleaved = new cleaver::InterleavedVolume(*volume);
+      delete volume;
+      volume = interleaved;
+    } catch (const std::runtime_error &e) {
+      if (strict) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 13;
+      }
+      std::cerr << "Warning: " << e.what() << " Materials will not be interleaved." << std::endl;
+    }
+  }
   mesher.setVolume(volume);
   mesher.setAlphaInit(alpha);
+  mesher.setReorderSpatially(reorder_morton);
+  mesher.setParallelWarping(parallel_warp);
 
 
   // Maybe enable recording on debug dump tets.
@@ -370,7 +462,7 @@ int main(int argc, char* argv[])
     if (have_sizing_field) {
       std::cout << "Loading sizing field: " << sizing_field << std::endl;
       std::vector<std::string> tmp(1,sizing_field);
-      sizingField = NRRDTools::loadNRRDFiles(tmp);
+      sizingField = NRRDTools::loadNRRDFiles(tmp, 1., precision);
       // todo(jon): add error handling
     } else {
       cleaver::Timer sizing_field_timer;
@@ -382,7 +474,9 @@ int main(int argc, char* argv[])
         (float)feature_scaling,
         (int)padding,
         (element_sizing_method != cleaver::Constant),
-        verbose));
+        verbose,
+        &mesher.threadPool()));
+      cleaver::quantizeFields(sizingField, precision);
       sizing_field_timer.stop();
       sizing_field_time = sizing_field_timer.time();
     }
@@ -440,29 +534,44 @@ int main(int argc, char* argv[])
   cleaving_timer.stop();
   cleaving_time = cleaving_timer.time();
 
-  cleaver::TetMesh *mesh = mesher.getTetMesh();
+  //-----------------------------------------------------------
+  // Convert to compact form and release cleaving structures
+  //-----------------------------------------------------------
+  cleaver::CompactTetMesh mesh(*mesher.getTetMesh());
+  mesher.cleanup();
 
   //-----------------------------------------------------------
   // Strip Exterior Tets
   //-----------------------------------------------------------
   if (strip_exterior) {
-    cleaver::stripExteriorTets(mesh, volume, verbose);
+    cleaver::stripExteriorTets(&mesh, volume, verbose);
+  }
+
+  //-----------------------------------------------------------
+  // Renumber for bandwidth if requested
+  //-----------------------------------------------------------
+  if (reorder_rcm) {
+    std::size_t bandwidth = mesh.bandwidth();
+    mesh.reorderRCM(verbose);
+    if (!verbose) {
+      std::cout << "Bandwidth: " << bandwidth << " -> " << mesh.bandwidth() << std::endl;
+    }
   }
 
   //-----------------------------------------------------------
   // Compute Quality If Havn't Already
   //-----------------------------------------------------------
-  mesh->computeAngles();
+  mesh.computeAngles();
   //-----------------------------------------------------------
   // Fix jacobians if requested.
   //-----------------------------------------------------------
-  if (fix_tets) mesh->fixVertexWindup(verbose);
+  if (fix_tets) mesh.fixVertexWindup(verbose);
 
   //-----------------------------------------------------------
   // Write Mesh To File
   //-----------------------------------------------------------
-  mesh->writeMesh(output_path + output_name, output_format, verbose);
-  mesh->writeInfo(output_path + output_name, verbose);
+  mesh.writeMesh(output_path + output_name, output_format, verbose, &mesher.threadPool());
+  mesh.writeInfo(output_path + output_name, verbose);
   //-----------------------------------------------------------
   // Write Experiment Info to file
   //-----------------------------------------------------------
@@ -473,8 +582,8 @@ int main(int argc, char* argv[])
     std::cout << "Output Info" << std::endl;
     std::cout << "Size: " << volume->size().toString() << std::endl;
     std::cout << "Materials: " << volume->numberOfMaterials() << std::endl;
-    std::cout << "Min Dihedral: " << mesh->min_angle << std::endl;
-    std::cout << "Max Dihedral: " << mesh->max_angle << std::endl;
+    std::cout << "Min Dihedral: " << mesh.min_angle << std::endl;
+    std::cout << "Max Dihedral: " << mesh.max_angle << std::endl;
     std::cout << "Total Time: " << total_time << " seconds" << std::endl;
     std::cout << "Sizing Field Time: " << sizing_field_time << " seconds" << std::endl;
     std::cout << "Background Mesh Time: " << background_time << " seconds" << std::endl;
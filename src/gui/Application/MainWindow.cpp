@@ -20,6 +20,8 @@ MainWindow::MainWindow(QWidget *parent) :
 MainWindow::MainWindow(const QString &title) : meshSaved_(true), sizingFieldSaved_(true)
 {
   this->setWindowTitle(title);
+  // Sizing field and meshing threads share the mesher's pool
+  this->mesher_.setExecutionPolicy(0);
   // Create Menus/Windows
   this->createDockWindows();
   this->createActions();
@@ -100,7 +100,8 @@ void SizingFieldThread::run() {
       cleaver::SizingFieldCreator::createSizingFieldFromVolume(
         this->mesher_.getVolume(), this->lipschitz_,
         this->featureScaling_, this->featureScaling_,
-        this->padding_, this->adapt_, true);
+        this->padding_, this->adapt_, true,
+        &this->mesher_.threadPool());
     this->mesher_.getVolume()->setSizingField(sizingField);
     emit progress(50);
     std::string sizingFieldName =
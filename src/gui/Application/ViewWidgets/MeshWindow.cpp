@@ -659,12 +659,7 @@ void MeshWindow::drawVertexStar(int v)
 void MeshWindow::drawEdgeStar(int edge)
 {
   // get pointer to the current edge
-  int idx = 0;
-  std::map<std::pair<int, int>, cleaver::HalfEdge*>::iterator iter = this->mesh_->halfEdges.begin();
-  while (idx != edge){
-    iter++; idx++;
-  }
-  cleaver::HalfEdge *e = (*iter).second;
+  cleaver::HalfEdge *e = this->mesh_->halfEdges[edge];
 
   cleaver::vec3 p1 = e->vertex->pos();
   cleaver::vec3 p2 = e->mate->vertex->pos();
@@ -1439,13 +1434,13 @@ void MeshWindow::build_bkgrnd_vbos()
   if ((this->mesher_ && this->mesher_->interfacesComputed()))
   {
     std::vector<GLfloat> ViolationData;
-    std::map<std::pair<int, int>, cleaver::HalfEdge*>::iterator
+    cleaver::HalfEdgeTable::iterator
       edgesIter = this->mesh_->halfEdges.begin();
 
     // reset evaluation flag, so we can use to avoid duplicates
     while (edgesIter != this->mesh_->halfEdges.end())
     {
-      cleaver::HalfEdge *edge = (*edgesIter).second;
+      cleaver::HalfEdge *edge = *edgesIter;
       edge->evaluated = false;
       edgesIter++;
     }
@@ -1454,7 +1449,7 @@ void MeshWindow::build_bkgrnd_vbos()
     edgesIter = this->mesh_->halfEdges.begin();
     while (edgesIter != this->mesh_->halfEdges.end())
     {
-      cleaver::HalfEdge *edge = (*edgesIter).second;
+      cleaver::HalfEdge *edge = *edgesIter;
       if (edge->cut && edge->cut->order() == cleaver::Order::CUT && !edge->evaluated)
       {
         this->cutData_.push_back(static_cast<float>(edge->cut->pos().x));
@@ -1785,13 +1780,13 @@ void MeshWindow::build_output_vbos()
   // Now update Cuts List
   if ((this->mesher_ && this->mesher_->interfacesComputed()))
   {
-    std::map<std::pair<int, int>,
-      cleaver::HalfEdge*>::iterator edgesIter = this->mesh_->halfEdges.begin();
+    cleaver::HalfEdgeTable::iterator
+      edgesIter = this->mesh_->halfEdges.begin();
 
     // reset evaluation flag, so we can use to avoid duplicates
     while (edgesIter != this->mesh_->halfEdges.end())
     {
-      cleaver::HalfEdge *edge = (*edgesIter).second;
+      cleaver::HalfEdge *edge = *edgesIter;
       edge->evaluated = false;
       edgesIter++;
     }
@@ -1800,7 +1795,7 @@ void MeshWindow::build_output_vbos()
     edgesIter = this->mesh_->halfEdges.begin();
     while (edgesIter != this->mesh_->halfEdges.end())
     {
-      cleaver::HalfEdge *edge = (*edgesIter).second;
+      cleaver::HalfEdge *edge = *edgesIter;
       if (edge->cut && edge->cut->order() == cleaver::Order::CUT && !edge->evaluated)
       {
         this->cutData_.push_back(static_cast<float>(edge->cut->pos().x));
@@ -1,6 +1,7 @@
 #ifndef ABSTRACTSCALARFIELD_H
 #define ABSTRACTSCALARFIELD_H
 
+#include <cstddef>
 #include "AbstractField.h"
 #include "vec3.h"
 
@@ -20,6 +21,11 @@ public:
     {
         return valueAt(x.x, x.y, x.z);
     }
+    virtual void valueAt(const vec3 *x, size_t n, double *out) const
+    {
+        for(size_t i=0; i < n; i++)
+            out[i] = valueAt(x[i].x, x[i].y, x[i].z);
+    }
 
     virtual BoundingBox bounds() const = 0;
 
@@ -61,6 +61,25 @@ public:
     virtual int numberOfMaterials() const = 0;
     virtual const BoundingBox& bounds() const = 0;
 
+    // batched lookups, volumes that can share work across materials
+    // should override these
+    virtual void valuesAt(const vec3 &x, double *out) const
+    {
+        for(int m=0; m < numberOfMaterials(); m++)
+            out[m] = valueAt(x, m);
+    }
+    virtual void valuesAt(const vec3 &x, const int *materials, int count, double *out) const
+    {
+        for(int i=0; i < count; i++)
+            out[i] = valueAt(x, materials[i]);
+    }
+    virtual int argmaxAt(const vec3 &x) const { return maxAt(x); }
+    virtual void argmaxAt(const vec3 *x, size_t n, int *labels) const
+    {
+        for(size_t i=0; i < n; i++)
+            labels[i] = argmaxAt(x[i]);
+    }
+
     vec3 size(){ return bounds().size; }
     int  width()  const { return (int)bounds().size.x; }
     int  height() const { return (int)bounds().size.y; }
@@ -43,6 +43,7 @@
 #include "ScalarField.h"
 #include "Volume.h"
 #include <iostream>
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <string>
@@ -169,10 +170,113 @@ namespace cleaver
     return doubleField;
   }
 
+  template <typename T>
+  static void copyFieldLayout(const FloatField *source, ScalarField<T> *target)
+  {
+    target->setCenterType(source->getCenterType());
+    target->setScale(source->scale());
+    target->setBounds(source->bounds());
+    target->setName(source->name());
+    target->setWarning(source->getWarning());
+    target->setError(source->getError());
+  }
+
+  // Returns a copy of the field stored as half floats or 16 bit integers,
+  // or null for Float32. The copy's data is allocated with new[].
+  AbstractScalarField* createQuantizedField(const FloatField *field, FieldPrecision precision)
+  {
+    if (precision == Float32)
+      return nullptr;
+
+    BoundingBox dataBounds = field->dataBounds();
+    int pad = (field->getCenterType() == NodeCentered) ? 1 : 0;
+    int w = (int)dataBounds.size.x + pad;
+    int h = (int)dataBounds.size.y + pad;
+    int d = (int)dataBounds.size.z + pad;
+    size_t whd = (size_t)w*h*d;
+
+    const float *source = field->data();
+    double min = 0, max = 0;
+    if (whd > 0) {
+      min = max = source[0];
+      for (size_t i = 1; i < whd; i++) {
+        min = std::min(min, (double)source[i]);
+        max = std::max(max, (double)source[i]);
+      }
+    }
+
+    if (precision == Float16) {
+      // rescale by a power of two only when the range exceeds a half
+      double scale = 1;
+      double largest = std::max(std::fabs(min), std::fabs(max));
+      while (std::isfinite(largest) && largest / scale > 65504)
+        scale *= 2;
+
+      half *data = new half[whd];
+      for (size_t i = 0; i < whd; i++)
+        data[i] = half((float)(source[i] / scale));
+
+      HalfField *halfField = new HalfField(data, w, h, d);
+      copyFieldLayout(field, halfField);
+      halfField->setQuantization(scale, 0);
+      return halfField;
+    }
+
+    // indicator functions crossing zero map zero to zero exactly,
+    // otherwise the full range is centered on the offset
+    double scale, offset;
+    if (min < 0 && max > 0) {
+      offset = 0;
+      scale = std::max(-min, max) / 32767.0;
+    } else {
+      offset = 0.5*(min + max);
+      scale = (max - min) / 65534.0;
+    }
+    if (!(scale > 0) || !std::isfinite(scale))
+      scale = 1;
+
+    int16_t *data = new int16_t[whd];
+    for (size_t i = 0; i < whd; i++) {
+      double q = std::round((source[i] - offset) / scale);
+      data[i] = (int16_t)std::max(-32767.0, std::min(32767.0, q));
+    }
+
+    Int16Field *int16Field = new Int16Field(data, w, h, d);
+    copyFieldLayout(field, int16Field);
+    int16Field->setQuantization(scale, offset);
+    return int16Field;
+  }
+
+  // Replaces every float field with its quantized copy, freeing the
+  // float data. Other field types are left as they are.
+  void quantizeFields(std::vector<AbstractScalarField*> &fields, FieldPrecision precision)
+  {
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+      FloatField *floatField = dynamic_cast<FloatField*>(fields[i]);
+      if (!floatField)
+        continue;
+
+      AbstractScalarField *quantized = createQuantizedField(floatField, precision);
+      if (!quantized)
+        continue;
+
+      delete[] floatField->data();
+      delete floatField;
+      fields[i] = quantized;
+    }
+  }
+
   void stripExteriorTets(TetMesh *mesh, const Volume *volume, bool verbose)
   {
     // exterior material is equal to material count
     mesh->stripMaterial(volume->numberOfMaterials(), verbose);
   }
 
+  void stripExteriorTets(CompactTetMesh *mesh, const Volume *volume, bool verbose)
+  {
+    // exterior material is equal to material count
+    mesh->stripMaterial(volume->numberOfMaterials(), verbose);
+  }
+
 }
@@ -44,6 +44,7 @@
 #include "ScalarField.h"
 #include "Volume.h"
 #include "TetMesh.h"
+#include "CompactTetMesh.h"
 #include <string>
 
 namespace cleaver
@@ -53,7 +54,10 @@ namespace cleaver
     Volume*  createFloatFieldVolumeFromVolume(Volume *volume);    
     ScalarField<float>* createFloatFieldFromScalarField(AbstractScalarField *scalarField);
     ScalarField<double>* createDoubleFieldFromScalarField(AbstractScalarField *scalarField);
+    AbstractScalarField* createQuantizedField(const FloatField *field, FieldPrecision precision);
+    void quantizeFields(std::vector<AbstractScalarField*> &fields, FieldPrecision precision);
     void stripExteriorTets(TetMesh *mesh, const Volume *volume, bool verbose = false);
+    void stripExteriorTets(CompactTetMesh *mesh, const Volume *volume, bool verbose = false);
 
     extern const std::string VersionNumber;
     extern const std::string VersionDate;
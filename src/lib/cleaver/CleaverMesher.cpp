@@ -20,9 +20,11 @@
 #include "Debug.h"
 #include "vec3.h"
 #include "Util.h"
+#include <algorithm>
 #include <queue>
 #include <set>
 #include <stack>
+#include <atomic>
 #include <cmath>
 #include <cstdlib>
 
@@ -32,6 +34,24 @@ namespace cleaver
   static const double DEFAULT_ALPHA_LONG = 0.357;
   static const double DEFAULT_ALPHA_SHORT = 0.203;
 
+  namespace {
+    // one output tet of a stencilled background tet
+    struct StencilTet {
+      Vertex *verts[4];
+      int material;
+    };
+
+    // a background tet the stencil pass could not stencil, reported
+    // after the parallel lookup so messages come out in tet order
+    struct UngeneralizedTet {
+      size_t tet;
+      int failures;         // missing cuts, triples and quadruple
+      int cut_count;
+      int missing_triples;  // bit f is set if face f has no triple
+      bool skipped;
+    };
+  }
+
   CleaverMesherImp::CleaverMesherImp(bool simple)
   {
     // -- set algorithm state --
@@ -47,6 +67,10 @@ namespace cleaver
     m_bRecordOperations      = false;
 
     m_bSimple                = simple;
+    m_bReorderSpatially      = false;
+    m_bParallelWarp          = false;
+    m_bDeterministic         = false;
+    m_grainSize              = 0;
 
     m_volume                 = nullptr;
     m_sizingField            = nullptr;
@@ -55,7 +79,7 @@ namespace cleaver
     m_mesh                   = nullptr;
     m_interfaceCalculator    = nullptr;
     m_violationChecker       = nullptr;
-
+    m_snapScratch.resize(1);  // serial snapping uses the first set
 
     m_sizing_field_time = 0;
     m_background_time   = 0;
@@ -146,6 +170,43 @@ namespace cleaver
     m_pimpl->m_alpha_init = alpha;
   }
 
+  void CleaverMesher::setReorderSpatially(bool reorder)
+  {
+    m_pimpl->m_bReorderSpatially = reorder;
+  }
+
+  void CleaverMesher::setParallelWarping(bool parallel)
+  {
+    m_pimpl->m_bParallelWarp = parallel;
+  }
+
+  void CleaverMesher::setThreadCount(unsigned int threads)
+  {
+    m_pimpl->m_threadPool.setThreadCount(threads);
+  }
+
+  void CleaverMesher::setDeterministic(bool deterministic)
+  {
+    m_pimpl->m_bDeterministic = deterministic;
+  }
+
+  void CleaverMesher::setExecutionPolicy(unsigned int threads, size_t grain, bool deterministic)
+  {
+    m_pimpl->m_threadPool.setThreadCount(threads);
+    m_pimpl->m_grainSize = grain;
+    m_pimpl->m_bDeterministic = deterministic;
+  }
+
+  ThreadPool& CleaverMesher::threadPool()
+  {
+    return m_pimpl->m_threadPool;
+  }
+
+  unsigned int CleaverMesher::getThreadCount() const
+  {
+    return m_pimpl->m_threadPool.threadCount();
+  }
+
   void CleaverMesherImp::recordOperations(std::string input)
   {
     Json::Value root;
@@ -195,10 +256,14 @@ namespace cleaver
     }
 
     // Create the Octree Mesh
-    OctreeMesher octreeMesher(m_sizingField);
+    OctreeMesher octreeMesher(m_sizingField, &m_threadPool);
     octreeMesher.createMesh();
     m_bgMesh = octreeMesher.getMesh();
 
+    // improve locality before any adjacency is built
+    if (m_bReorderSpatially)
+      m_bgMesh->reorderSpatially(verbose);
+
     // set state
     m_bBackgroundMeshCreated = true;
 
@@ -314,26 +379,48 @@ namespace cleaver
       std::cout << "Sampling Volume..." << std::endl;
 
     Status status(m_bgMesh->verts.size());
-    // Sample Each Background Vertex
-    for (unsigned int v = 0; v < m_bgMesh->verts.size(); v++)
+    std::atomic<size_t> sampled(0);
+
+    // Sample Each Background Vertex, vertices are independent
+    m_threadPool.parallelFor(0, m_bgMesh->verts.size(), grainSize(1024),
+      [&](size_t begin, size_t end, unsigned int thread)
     {
-      if (verbose) {
-        status.printStatus();
+      // label vertices in small batches so the volume can evaluate
+      // each material over many points at once
+      const size_t kBatch = 256;
+      vec3 pos[kBatch];
+      int labels[kBatch];
+
+      for (size_t first = begin; first < end; first += kBatch)
+      {
+        size_t count = std::min(kBatch, end - first);
+        for (size_t i = 0; i < count; i++)
+          pos[i] = (*m_bgMesh).verts[first + i]->pos();
+        m_volume->argmaxAt(pos, count, labels);
+        for (size_t i = 0; i < count; i++)
+          (*m_bgMesh).verts[first + i]->label = labels[i];
       }
-      // Get Vertex
-      cleaver::Vertex *vertex = (*m_bgMesh).verts[v];
 
-      // Grab Material Label
-      vertex->label = m_volume->maxAt(vertex->pos());
+      for (size_t v = begin; v < end; v++)
+      {
+        // Get Vertex
+        cleaver::Vertex *vertex = (*m_bgMesh).verts[v];
+
+        // added feb 20 to attempt boundary conforming
+        if (!m_volume->bounds().contains(vertex->pos())) {
+          vertex->isExterior = true;
+          vertex->label = m_volume->numberOfMaterials();
+        } else {
+          vertex->isExterior = false;
+        }
+      }
 
-      // added feb 20 to attempt boundary conforming
-      if (!m_volume->bounds().contains(vertex->pos())) {
-        vertex->isExterior = true;
-        vertex->label = m_volume->numberOfMaterials();
-      } else {
-        vertex->isExterior = false;
+      // only the calling thread touches the console
+      size_t done = sampled.fetch_add(end - begin) + (end - begin);
+      if (verbose && thread == 0) {
+        status.printStatus(done);
       }
-    }
+    });
 
     m_bgMesh->material_count = m_volume->numberOfMaterials();
 
@@ -381,9 +468,8 @@ namespace cleaver
     //---------------------------------------------------
     // set alpha_init for all edges in background mesh
     //---------------------------------------------------
-    for (auto &entry : m_bgMesh->halfEdges)
+    for (HalfEdge *half_edge : m_bgMesh->halfEdges)
     {
-      HalfEdge *half_edge = entry.second;
       if (constant) {
         half_edge->alpha = (float)(half_edge->m_long_edge ? alp_long : alp_short);
       } else {
@@ -494,7 +580,7 @@ namespace cleaver
   //=============================================================
   void CleaverMesherImp::updateAlphaLengthAroundVertex(Vertex *vertex, float alpha_length)
   {
-    std::vector<HalfEdge*> adj_edges = m_bgMesh->edgesAroundVertex(vertex);
+    const std::vector<HalfEdge*> &adj_edges = m_bgMesh->edgesAroundVertex(vertex);
 
     for (size_t e = 0; e < adj_edges.size(); e++)
     {
@@ -571,9 +657,8 @@ namespace cleaver
       std::cout << "Computing Cuts..." << std::flush;
 
     {// DEBUG TEST
-      for (auto &entry : m_bgMesh->halfEdges)
+      for (cleaver::HalfEdge *edge : m_bgMesh->halfEdges)
       {
-        cleaver::HalfEdge *edge = entry.second;
         edge->evaluated = false;
       }
     }
@@ -581,17 +666,37 @@ namespace cleaver
     //---------------------------------------
     //  Compute Cuts One Edge At A Time
     //---------------------------------------
-    for (auto &entry : m_bgMesh->halfEdges)
+    // pick the half edge of each pair the serial traversal would visit,
+    // so every edge is cut exactly once and with the same orientation
+    std::vector<cleaver::HalfEdge*> edges;
+    edges.reserve(m_bgMesh->halfEdges.size() / 2);
+    for (cleaver::HalfEdge *edge : m_bgMesh->halfEdges)
     {
-      cleaver::HalfEdge *edge = entry.second;
-
       if (!edge->evaluated) {
-        m_interfaceCalculator->computeCutForEdge(edge);
-        if (edge->cut)
-          cut_count++;
+        edge->evaluated = true;
+        edge->mate->evaluated = true;
+        edges.push_back(edge);
       }
     }
 
+    // edges are independent, each thread allocates cuts from its own pool
+    m_bgMesh->setAllocationThreads(m_threadPool.threadCount());
+    std::vector<size_t> thread_cuts(m_threadPool.threadCount(), 0);
+    m_threadPool.parallelFor(0, edges.size(), grainSize(1024),
+      [&](size_t begin, size_t end, unsigned int thread)
+    {
+      size_t cuts = 0;
+      for (size_t e = begin; e < end; e++)
+      {
+        m_interfaceCalculator->computeCutForEdge(edges[e], thread);
+        if (edges[e]->cut)
+          cuts++;
+      }
+      thread_cuts[thread] += cuts;
+    });
+    for (size_t t = 0; t < thread_cuts.size(); t++)
+      cut_count += thread_cuts[t];
+
     if (verbose) {
       std::cout << " done. [" << cut_count << "]" << std::endl;
       std::cout << "Computing Triples..." << std::flush;
@@ -608,18 +713,30 @@ namespace cleaver
     //--------------------------------------
     // Compute Triples One Face At A Time
     //--------------------------------------
-    for (unsigned int f = 0; f < 4 * m_bgMesh->tets.size(); f++)
+    // a face and its mate share one triple, the lower indexed half face
+    // owns the pair, which is the one the serial traversal visits first.
+    // The violation check only touches the new triple, so the owner runs it.
+    std::vector<size_t> thread_triples(m_threadPool.threadCount(), 0);
+    m_threadPool.parallelFor(0, 4 * m_bgMesh->tets.size(), grainSize(1024),
+      [&](size_t begin, size_t end, unsigned int thread)
     {
-      cleaver::HalfFace *face = &m_bgMesh->halfFaces[f];
+      size_t triples = 0;
+      for (size_t f = begin; f < end; f++)
+      {
+        cleaver::HalfFace *face = &m_bgMesh->halfFaces[f];
+        if (face->mate && face->mate < face)
+          continue;
 
-      if (!face->evaluated) {
-        m_interfaceCalculator->computeTripleForFace(face);
+        m_interfaceCalculator->computeTripleForFace(face, thread);
         if (face->triple) {
           m_violationChecker->checkIfTripleViolatesVertices(face);
-          triple_count++;
+          triples++;
         }
       }
-    }
+      thread_triples[thread] += triples;
+    });
+    for (size_t t = 0; t < thread_triples.size(); t++)
+      triple_count += thread_triples[t];
 
     if (verbose) {
       std::cout << " done. [" << triple_count << "]" << std::endl;
@@ -629,14 +746,23 @@ namespace cleaver
     //-------------------------------------
     // Compute Quadruples One Tet At A Time
     //-------------------------------------
-    for (unsigned int t = 0; t < m_bgMesh->tets.size(); t++)
+    std::vector<size_t> thread_quadruples(m_threadPool.threadCount(), 0);
+    m_threadPool.parallelFor(0, m_bgMesh->tets.size(), grainSize(1024),
+      [&](size_t begin, size_t end, unsigned int thread)
     {
-      cleaver::Tet *tet = m_bgMesh->tets[t];
+      size_t quadruples = 0;
+      for (size_t t = begin; t < end; t++)
+      {
+        cleaver::Tet *tet = m_bgMesh->tets[t];
 
-      m_interfaceCalculator->computeQuadrupleForTet(tet);
-      if (tet->quadruple)
-        quadruple_count++;
-    }
+        m_interfaceCalculator->computeQuadrupleForTet(tet, thread);
+        if (tet->quadruple)
+          quadruples++;
+      }
+      thread_quadruples[thread] += quadruples;
+    });
+    for (size_t t = 0; t < thread_quadruples.size(); t++)
+      quadruple_count += thread_quadruples[t];
 
     if (verbose)
       std::cout << " done. [" << quadruple_count << "]" << std::endl;
@@ -669,9 +795,8 @@ namespace cleaver
       std::cout << "Computing Topological Cuts..." << std::flush;
 
     {// DEBUG TEST
-      for (auto &entry : m_bgMesh->halfEdges)
+      for (cleaver::HalfEdge *edge : m_bgMesh->halfEdges)
       {
-        cleaver::HalfEdge *edge = entry.second;
         edge->evaluated = false;
         edge->mate->evaluated = false;
       }
@@ -680,12 +805,10 @@ namespace cleaver
     //----------------------------------------------
     //  Compute Topological Cuts One Edge At A Time
     //----------------------------------------------
-    for (auto &entry : m_bgMesh->halfEdges)
+    for (cleaver::HalfEdge *edge : m_bgMesh->halfEdges)
     {
-      cleaver::HalfEdge *edge = entry.second;
-
       if (!edge->evaluated) {
-        m_interfaceCalculator->computeCutForEdge(edge);
+        m_interfaceCalculator->computeCutForEdge(edge, 0);
         if (edge->cut)
           cut_count++;
       }
@@ -730,7 +853,7 @@ namespace cleaver
     {
       cleaver::Tet *tet = m_bgMesh->tets[t];
 
-      m_interfaceCalculator->computeQuadrupleForTet(tet);
+      m_interfaceCalculator->computeQuadrupleForTet(tet, 0);
       if (tet->quadruple)
         quadruple_count++;
     }
@@ -777,6 +900,47 @@ namespace cleaver
       return true;
   }
 
+  //---------------------------------------------------
+  //  classifyInterfaceTets()
+  //
+  //  Flags every background tet with a real cut on one
+  //  of its edges. The rest see a single material and
+  //  come out of the stencils unchanged, so generalizing
+  //  and stenciling can skip most of their work.
+  //---------------------------------------------------
+  size_t CleaverMesherImp::classifyInterfaceTets()
+  {
+    const size_t tet_count = m_bgMesh->tets.size();
+    m_interfaceTets.assign(tet_count, 0);
+
+    std::vector<size_t> counts(m_threadPool.threadCount(), 0);
+    m_threadPool.parallelFor(0, tet_count, grainSize(4096),
+      [&](size_t begin, size_t end, unsigned int thread)
+    {
+      for (size_t t = begin; t < end; t++)
+      {
+        Vertex *verts[4];
+        HalfEdge *edges[6];
+        HalfFace *faces[4];
+        m_bgMesh->getAdjacencyListsForTet(m_bgMesh->tets[t], verts, edges, faces);
+
+        for (int e = 0; e < EDGES_PER_TET; e++) {
+          if (edges[e]->cut && edges[e]->cut->original_order() == Order::CUT) {
+            m_interfaceTets[t] = 1;
+            counts[thread]++;
+            break;
+          }
+        }
+      }
+    });
+
+    size_t interface_count = 0;
+    for (size_t c : counts)
+      interface_count += c;
+
+    return interface_count;
+  }
+
   //---------------------------------------------------
   //  generalizeTets()
   //---------------------------------------------------
@@ -785,183 +949,266 @@ namespace cleaver
     if (verbose)
       std::cout << "Generalizing Tets..." << std::endl;
 
-    //--------------------------------------
-    // Loop over all tets that contain cuts
-    //--------------------------------------
-    // (For Now, Looping over ALL tets)
-
-    Status status(m_bgMesh->tets.size());
-    for (unsigned int t = 0; t < m_bgMesh->tets.size(); t++)
+    size_t interface_count = classifyInterfaceTets();
+    if (verbose)
+      std::cout << interface_count << " of " << m_bgMesh->tets.size()
+                << " tets contain interfaces." << std::endl;
+
+    // Tets that already hold a quadruple have every edge cut and every
+    // face tripled, so the edges and faces left empty below are exactly
+    // the ones a tet-by-tet sweep would generalize. Each virtual choice
+    // depends only on the edge or face itself, which lets every edge and
+    // face be handled once by a single owner before the tets are visited.
+
+    //------------------------------
+    // determine virtual edge cuts
+    //------------------------------
+    m_threadPool.parallelFor(0, m_bgMesh->halfEdges.size(), grainSize(1024),
+      [&](size_t begin, size_t end, unsigned int)
     {
-      if (verbose) {
-        status.printStatus();
+      for (size_t i = begin; i < end; i++)
+      {
+        HalfEdge *edge = m_bgMesh->halfEdges[i];
+
+        // the half edge pointing at the larger index owns the pair
+        if (edge->vertex->tm_v_index < edge->mate->vertex->tm_v_index || edge->cut)
+          continue;
+
+        // always go towards the smaller index
+        edge->cut = edge->mate->vertex;
+
+        // copy info to mate edge
+        edge->mate->cut = edge->cut;
       }
-      cleaver::Tet *tet = m_bgMesh->tets[t];
+    });
 
-      //------------------------------
-      // if no quad, start generalization
-      //------------------------------
-      if (tet && !tet->quadruple)
+    //------------------------------
+    // determine virtual face cuts
+    //------------------------------
+    // workers only record failures, they are reported once the loop is done
+    std::vector<std::vector<size_t> > bad_faces(m_threadPool.threadCount());
+    m_threadPool.parallelFor(0, 4 * m_bgMesh->tets.size(), grainSize(1024),
+      [&](size_t begin, size_t end, unsigned int thread)
+    {
+      for (size_t f = begin; f < end; f++)
       {
-        // look up generalization
-        Vertex *verts[4];
-        HalfEdge *edges[6];
-        HalfFace *faces[4];
+        HalfFace *face = &m_bgMesh->halfFaces[f];
 
-        m_bgMesh->getAdjacencyListsForTet(tet, verts, edges, faces);
+        // the lower indexed half face owns the pair
+        if ((face->mate && face->mate < face) || face->triple)
+          continue;
 
-        int cut_count = 0;
-        for (int e = 0; e < 6; e++)
-          cut_count += (edges[e]->cut && (edges[e]->cut->order() == Order::CUT) ? 1 : 0);
+        HalfEdge *e[3];
+        Vertex   *v[3];
+        m_bgMesh->getAdjacencyListsForFace(face, v, e);
 
-
-        //------------------------------
-        // determine virtual edge cuts
-        //------------------------------
-        for (int e = 0; e < 6; e++) {
-          if (edges[e]->cut == nullptr)
+        int v_count = 0;
+        int v_e = 0;
+        for (int i = 0; i < 3; i++)
+        {
+          if (e[i]->cut->order() != Order::CUT)
           {
-            // always go towards the smaller index
-            if (edges[e]->vertex->tm_v_index < edges[e]->mate->vertex->tm_v_index)
-              edges[e]->cut = edges[e]->vertex;
-            else
-              edges[e]->cut = edges[e]->mate->vertex;
-
-            // copy info to mate edge
-            edges[e]->mate->cut = edges[e]->cut;
+            v_count++;
+            v_e = i;   // save index to virtual edge
           }
         }
 
-
-        //------------------------------
-        // determine virtual face cuts
-        //------------------------------
-        for (int f = 0; f < 4; f++)
+        // move to edge virtual cut went to
+        if (v_count == 1)
         {
-          if (faces[f]->triple == nullptr)
+          for (int i = 0; i < 3; i++)
           {
-            HalfEdge *e[3];
-            Vertex   *v[3];
-            m_bgMesh->getAdjacencyListsForFace(faces[f], v, e);
+            // skip edge that has virtual cut
+            if (i == v_e)
+              continue;
 
-            int v_count = 0;
-            int v_e = 0;
-            for (int i = 0; i < 3; i++)
+            if (e[i]->vertex == e[v_e]->cut || e[i]->mate->vertex == e[v_e]->cut)
             {
-              if (e[i]->cut->order() != Order::CUT)
-              {
-                v_count++;
-                v_e = i;   // save index to virtual edge
-              }
+              face->triple = e[i]->cut;
+              break;
             }
+          }
+        }
+        // move to minimal index vertex
+        else if (v_count == 3)
+        {
+          if ((v[0]->tm_v_index < v[1]->tm_v_index) && v[0]->tm_v_index < v[2]->tm_v_index)
+            face->triple = v[0];
+          else if ((v[1]->tm_v_index < v[2]->tm_v_index) && v[1]->tm_v_index < v[0]->tm_v_index)
+            face->triple = v[1];
+          else
+            face->triple = v[2];
+        } else
+        {
+          bad_faces[thread].push_back(f);
+          continue;
+        }
 
-            // move to edge virtual cut went to
-            if (v_count == 1)
-            {
-              for (int i = 0; i < 3; i++)
-              {
-                // skip edge that has virtual cut
-                if (i == v_e)
-                  continue;
+        // copy info to mate face if it exists
+        if (face->mate)
+          face->mate->triple = face->triple;
+      }
+    });
 
-                if (e[i]->vertex == e[v_e]->cut || e[i]->mate->vertex == e[v_e]->cut)
-                {
-                  faces[f]->triple = e[i]->cut;
-                  break;
-                }
-              }
-            }
-            // move to minimal index vertex
-            else if (v_count == 3)
-            {
-              if ((v[0]->tm_v_index < v[1]->tm_v_index) && v[0]->tm_v_index < v[2]->tm_v_index)
-                faces[f]->triple = v[0];
-              else if ((v[1]->tm_v_index < v[2]->tm_v_index) && v[1]->tm_v_index < v[0]->tm_v_index)
-                faces[f]->triple = v[1];
-              else
-                faces[f]->triple = v[2];
-            } else
-            {
-              std::cerr << "HUGE PROBLEM: virtual count = " << v_count << std::endl;
-              for (int j = 0; j < 3; j++) {
-                if (v[j]->isExterior)
-                  std::cout << "But it's Exterior!" << std::endl;
-              }
+    std::vector<size_t> failed_faces;
+    for (size_t i = 0; i < bad_faces.size(); i++)
+      failed_faces.insert(failed_faces.end(), bad_faces[i].begin(), bad_faces[i].end());
+    if (!failed_faces.empty())
+    {
+      std::sort(failed_faces.begin(), failed_faces.end());
+      HalfEdge *e[3];
+      Vertex   *v[3];
+      m_bgMesh->getAdjacencyListsForFace(&m_bgMesh->halfFaces[failed_faces[0]], v, e);
 
-              exit(8);
-            }
+      int v_count = 0;
+      for (int i = 0; i < 3; i++)
+        v_count += (e[i]->cut->order() != Order::CUT) ? 1 : 0;
 
-            // copy info to mate face if it exists
-            if (faces[f]->mate)
-              faces[f]->mate->triple = faces[f]->triple;
-          }
+      std::cerr << "HUGE PROBLEM: virtual count = " << v_count << std::endl;
+      for (int j = 0; j < 3; j++) {
+        if (v[j]->isExterior)
+          std::cout << "But it's Exterior!" << std::endl;
+      }
+
+      exit(8);
+    }
+
+    //--------------------------------------
+    // Loop over all tets that contain cuts
+    //--------------------------------------
+    // Homogeneous tets only have virtual edge cuts and face triples,
+    // so the full search would always land on their first face.
+
+    Status status(m_bgMesh->tets.size());
+    std::atomic<size_t> visited(0);
+    std::vector<std::vector<size_t> > failed_tets(m_threadPool.threadCount());
+    std::vector<size_t> low_order_counts(m_threadPool.threadCount(), 0);
+    m_threadPool.parallelFor(0, m_bgMesh->tets.size(), grainSize(1024),
+      [&](size_t begin, size_t end, unsigned int thread)
+    {
+      for (size_t t = begin; t < end; t++)
+      {
+        cleaver::Tet *tet = m_bgMesh->tets[t];
+
+        if (tet && !tet->quadruple && !m_interfaceTets[t])
+        {
+          tet->quadruple = m_bgMesh->halfFaces[4 * tet->tm_index].triple;
+          continue;
         }
 
         //------------------------------
-        // determine virtual quadruple
+        // if no quad, start generalization
         //------------------------------
-        if (cut_count == 3)
+        if (tet && !tet->quadruple)
         {
-          if (faces[0]->triple == faces[1]->triple ||
-            faces[0]->triple == faces[2]->triple ||
-            faces[0]->triple == faces[3]->triple)
-            tet->quadruple = faces[0]->triple;
-          else if (faces[1]->triple == faces[2]->triple ||
-            faces[1]->triple == faces[3]->triple)
-            tet->quadruple = faces[1]->triple;
-          else if (faces[2]->triple == faces[3]->triple)
-            tet->quadruple = faces[2]->triple;
-        } else if (cut_count == 4)
-        {
-          for (int f = 0; f < 4; f++)
+          // look up generalization
+          Vertex *verts[4];
+          HalfEdge *edges[6];
+          HalfFace *faces[4];
+
+          m_bgMesh->getAdjacencyListsForTet(tet, verts, edges, faces);
+
+          int cut_count = 0;
+          for (int e = 0; e < 6; e++)
+            cut_count += (edges[e]->cut && (edges[e]->cut->order() == Order::CUT) ? 1 : 0);
+
+          //------------------------------
+          // determine virtual quadruple
+          //------------------------------
+          if (cut_count == 3)
+          {
+            if (faces[0]->triple == faces[1]->triple ||
+              faces[0]->triple == faces[2]->triple ||
+              faces[0]->triple == faces[3]->triple)
+              tet->quadruple = faces[0]->triple;
+            else if (faces[1]->triple == faces[2]->triple ||
+              faces[1]->triple == faces[3]->triple)
+              tet->quadruple = faces[1]->triple;
+            else if (faces[2]->triple == faces[3]->triple)
+              tet->quadruple = faces[2]->triple;
+          } else if (cut_count == 4)
           {
-            if (faces[f]->triple->order() < Order::TRIP && (faces[(f + 1) % 4]->triple == faces[f]->triple ||
-              faces[(f + 2) % 4]->triple == faces[f]->triple ||
-              faces[(f + 3) % 4]->triple == faces[f]->triple))
+            for (int f = 0; f < 4; f++)
             {
-              tet->quadruple = faces[f]->triple;
-              break;
+              if (faces[f]->triple->order() < Order::TRIP && (faces[(f + 1) % 4]->triple == faces[f]->triple ||
+                faces[(f + 2) % 4]->triple == faces[f]->triple ||
+                faces[(f + 3) % 4]->triple == faces[f]->triple))
+              {
+                tet->quadruple = faces[f]->triple;
+                break;
+              }
             }
-          }
-        } else if (cut_count == 5)
-        {
-          for (int f = 0; f < 4; f++)
+          } else if (cut_count == 5)
           {
-            if (faces[f]->triple->order() == Order::TRIP)
+            for (int f = 0; f < 4; f++)
             {
-              tet->quadruple = faces[f]->triple;
-              break;
+              if (faces[f]->triple->order() == Order::TRIP)
+              {
+                tet->quadruple = faces[f]->triple;
+                break;
+              }
             }
-          }
-        } else
-        {
-          for (int f = 0; f < 4; f++)
+          } else
           {
-            if (faces[f]->triple->order() < Order::TRIP)
+            for (int f = 0; f < 4; f++)
             {
-              tet->quadruple = faces[f]->triple;
-              break;
+              if (faces[f]->triple->order() < Order::TRIP)
+              {
+                tet->quadruple = faces[f]->triple;
+                break;
+              }
             }
           }
-        }
 
-        if (tet->quadruple == nullptr)
-        {
-          std::cerr << "Generalization Failed!!" << std::endl;
-          std::cerr << "problem tet contains " << cut_count << " cuts." << std::endl;
+          if (tet->quadruple == nullptr)
+            failed_tets[thread].push_back(t);
+          else if (tet->quadruple->order() < Order::VERT)
+            low_order_counts[thread]++;
         }
+      }
+
+      // only the calling thread touches the console
+      size_t done = visited.fetch_add(end - begin) + (end - begin);
+      if (verbose && thread == 0) {
+        status.printStatus(done);
+      }
+    });
 
-        if (tet->quadruple->order() < Order::VERT)
-          std::cerr << "GOT YA!" << std::endl;
+    if (verbose) {
+      status.done();
+    }
+
+    // report what the workers recorded, failed tets in tet order
+    for (size_t i = 0; i < low_order_counts.size(); i++) {
+      for (size_t c = 0; c < low_order_counts[i]; c++)
+        std::cerr << "GOT YA!" << std::endl;
+    }
 
+    std::vector<size_t> failed;
+    for (size_t i = 0; i < failed_tets.size(); i++)
+      failed.insert(failed.end(), failed_tets[i].begin(), failed_tets[i].end());
+    if (!failed.empty())
+    {
+      std::sort(failed.begin(), failed.end());
+      for (size_t i = 0; i < failed.size(); i++)
+      {
+        HalfEdge *edges[6];
+        m_bgMesh->edgesAroundTet(m_bgMesh->tets[failed[i]], edges);
+
+        int cut_count = 0;
+        for (int e = 0; e < 6; e++)
+          cut_count += (edges[e]->cut && (edges[e]->cut->order() == Order::CUT) ? 1 : 0);
+
+        std::cerr << "Generalization Failed!!" << std::endl;
+        std::cerr << "problem tet contains " << cut_count << " cuts." << std::endl;
       }
+      exit(8);
     }
 
     // set state
     m_bGeneralized = true;
 
     if (verbose) {
-      status.done();
       std::cout << " done." << std::endl;
     }
 
@@ -1048,12 +1295,12 @@ namespace cleaver
               exit(19);
               // technically this case should never happen, but if
               // it does, let's just make a triple point in the center
-              faces[f]->triple = new Vertex(m_volume->numberOfMaterials());
+              faces[f]->triple = m_bgMesh->createVertex(m_volume->numberOfMaterials());
               faces[f]->triple->pos() = (1.0 / 3.0)*(v[0]->pos() + v[1]->pos() + v[2]->pos());
               faces[f]->triple->order() = Order::TRIP;
-              faces[f]->triple->lbls[v[0]->label] = true;
-              faces[f]->triple->lbls[v[1]->label] = true;
-              faces[f]->triple->lbls[v[2]->label] = true;
+              faces[f]->triple->lbls.set(v[0]->label);
+              faces[f]->triple->lbls.set(v[1]->label);
+              faces[f]->triple->lbls.set(v[2]->label);
               faces[f]->triple->violating = false;
               faces[f]->triple->closestGeometry = nullptr;
               if (faces[f]->mate)
@@ -1351,30 +1598,294 @@ namespace cleaver
 
   //==============================================================
   // Snap and Warp All Vertex Violations
+  //
+  //  Vertices are visited from a worklist seeded with every
+  //  violated vertex. Warping a vertex moves the interfaces in
+  //  its star, which can make a neighbor violated after it was
+  //  checked, so unwarped neighbors that become violated are
+  //  pushed back on the list. Each vertex warps at most once.
   //==============================================================
   void CleaverMesherImp::snapAndWarpVertexViolations(bool verbose)
   {
     //---------------------------------------------------
-    //  Apply vertex warping to all vertices in lattice
+    //  Seed the worklist with all violated vertices
     //---------------------------------------------------
     if (verbose) {
       std::cout << "preparing to examine " << m_bgMesh->verts.size() << " verts" << std::endl;
     }
-    Status status(m_bgMesh->verts.size());
-    for (unsigned int v = 0; v < m_bgMesh->verts.size(); v++)
+    const size_t vert_count = m_bgMesh->verts.size();
+    std::vector<char> queued(vert_count, 0);
+    m_threadPool.parallelFor(0, vert_count, grainSize(1024),
+      [&](size_t begin, size_t end, unsigned int)
+    {
+      for (size_t v = begin; v < end; v++)
+        queued[v] = isVertexViolated(m_bgMesh->verts[v]) ? 1 : 0;
+    });
+
+    std::vector<Vertex*> worklist;
+    for (size_t v = 0; v < vert_count; v++) {
+      if (queued[v])
+        worklist.push_back(m_bgMesh->verts[v]);
+    }
+    if (verbose) {
+      std::cout << worklist.size() << " verts violated" << std::endl;
+    }
+
+    Status status(worklist.size());
+    size_t visited = 0;
+
+    // operations are recorded in order, so recording always runs serially
+    if (m_bParallelWarp && !m_bRecordOperations)
+    {
+      // warp in rounds, each round colors the worklist so that vertices
+      // of one color touch disjoint parts of the mesh
+      m_snapScratch.resize(std::max<size_t>(m_snapScratch.size(), m_threadPool.threadCount()));
+      size_t round_count = 0;
+      while (!worklist.empty())
+      {
+        std::vector<std::vector<Vertex*> > classes;
+        colorWarpConflicts(worklist, classes);
+        round_count++;
+
+        for (size_t i = 0; i < worklist.size(); i++)
+          queued[worklist[i]->tm_v_index] = 0;
+
+        for (size_t c = 0; c < classes.size(); c++)
+        {
+          const std::vector<Vertex*> &color = classes[c];
+          m_threadPool.parallelFor(0, color.size(), grainSize(16),
+            [&](size_t begin, size_t end, unsigned int thread)
+          {
+            for (size_t v = begin; v < end; v++)
+              snapAndWarpForViolatedVertex(color[v], thread);
+          });
+
+          visited += color.size();
+          if (verbose) {
+            status.printStatus(visited);
+          }
+        }
+
+        // gather neighbors of this round's warps that became violated,
+        // a neighbor shared by several warps is queued once
+        std::vector<std::vector<Vertex*> > found(m_threadPool.threadCount());
+        m_threadPool.parallelFor(0, worklist.size(), grainSize(64),
+          [&](size_t begin, size_t end, unsigned int thread)
+        {
+          for (size_t i = begin; i < end; i++) {
+            if (worklist[i]->warped)
+              collectViolatedNeighbors(worklist[i], queued, found[thread]);
+          }
+        });
+
+        std::vector<Vertex*> next;
+        for (size_t f = 0; f < found.size(); f++) {
+          for (size_t i = 0; i < found[f].size(); i++) {
+            Vertex *neighbor = found[f][i];
+            if (!queued[neighbor->tm_v_index]) {
+              queued[neighbor->tm_v_index] = 1;
+              next.push_back(neighbor);
+            }
+          }
+        }
+
+        // which thread found a neighbor depends on scheduling, and the
+        // order of the next round decides its colors, so always sort
+        std::sort(next.begin(), next.end(), [](Vertex *a, Vertex *b) {
+          return a->tm_v_index < b->tm_v_index;
+        });
+        worklist.swap(next);
+      }
+
+      if (verbose) {
+        status.done();
+        std::cout << "warped in " << round_count << " rounds" << std::endl;
+      }
+    }
+    else
     {
+      std::queue<Vertex*> vq;
+      for (size_t i = 0; i < worklist.size(); i++)
+        vq.push(worklist[i]);
+
+      std::vector<Vertex*> pushed;
+      while (!vq.empty())
+      {
+        if (verbose) {
+          status.printStatus(visited++);
+        }
+        Vertex *vertex = vq.front();
+        vq.pop();
+        queued[vertex->tm_v_index] = 0;
+
+        if (snapAndWarpForViolatedVertex(vertex)) {
+          pushed.clear();
+          queueViolatedNeighbors(vertex, queued, pushed);
+          for (size_t i = 0; i < pushed.size(); i++)
+            vq.push(pushed[i]);
+        }
+      }
+
       if (verbose) {
-        status.printStatus();
+        status.done();
       }
-      Vertex *vertex = m_bgMesh->verts[v];            // TODO: add check for vertex->hasAdjacentCuts
-      snapAndWarpForViolatedVertex(vertex);           //       to reduce workload significantly.
     }
     if (verbose) {
-      status.done();
       std::cout << "Phase 1 Complete" << std::endl;
     }
   }
 
+  //==============================================================
+  // - isVertexViolated()
+  //
+  //  True if an unsnapped cut, triple or quadruple around the
+  //  vertex violates it. Only reads the mesh, roots are found
+  //  without compressing so threads may call this together.
+  //==============================================================
+  bool CleaverMesherImp::isVertexViolated(Vertex *vertex)
+  {
+    const std::vector<HalfEdge*> &edges = m_bgMesh->edgesAroundVertex(vertex);
+    for (size_t e = 0; e < edges.size(); e++)
+    {
+      Vertex *cut = edges[e]->cut;
+      if (cut && cut->findRoot()->original_order() == Order::CUT &&
+          cut->violating && cut->closestGeometry == vertex)
+        return true;
+    }
+
+    const std::vector<Tet*> &tets = m_bgMesh->tetsAroundVertex(vertex);
+    for (size_t t = 0; t < tets.size(); t++)
+    {
+      Vertex *quadruple = tets[t]->quadruple;
+      if (quadruple && quadruple->findRoot()->original_order() == Order::QUAD &&
+          quadruple->violating && quadruple->closestGeometry == vertex)
+        return true;
+
+      HalfFace *faces[4];
+      m_bgMesh->facesAroundTet(tets[t], faces);
+      for (int f = 0; f < 4; f++)
+      {
+        Vertex *triple = faces[f]->triple;
+        if (triple && triple->findRoot()->original_order() == Order::TRIP &&
+            triple->violating && triple->closestGeometry == vertex)
+          return true;
+      }
+    }
+    return false;
+  }
+
+  //==============================================================
+  // - queueViolatedNeighbors()
+  //
+  //  After a warp, appends the unwarped neighbors of the vertex
+  //  that are now violated and not already queued.
+  //==============================================================
+  void CleaverMesherImp::queueViolatedNeighbors(Vertex *vertex, std::vector<char> &queued,
+                                                std::vector<Vertex*> &list)
+  {
+    const std::vector<Tet*> &tets = m_bgMesh->tetsAroundVertex(vertex);
+    for (size_t t = 0; t < tets.size(); t++)
+    {
+      for (int v = 0; v < 4; v++)
+      {
+        Vertex *neighbor = tets[t]->verts[v];
+        if (neighbor->warped || queued[neighbor->tm_v_index])
+          continue;
+        if (isVertexViolated(neighbor)) {
+          queued[neighbor->tm_v_index] = 1;
+          list.push_back(neighbor);
+        }
+      }
+    }
+  }
+
+  //==============================================================
+  // - collectViolatedNeighbors()
+  //
+  //  Like queueViolatedNeighbors(), but leaves the queued flags
+  //  alone so several threads can collect at once. The list may
+  //  repeat a vertex found from different warped vertices.
+  //==============================================================
+  void CleaverMesherImp::collectViolatedNeighbors(Vertex *vertex, const std::vector<char> &queued,
+                                                  std::vector<Vertex*> &list)
+  {
+    const size_t first = list.size();
+    const std::vector<Tet*> &tets = m_bgMesh->tetsAroundVertex(vertex);
+    for (size_t t = 0; t < tets.size(); t++)
+    {
+      for (int v = 0; v < 4; v++)
+      {
+        Vertex *neighbor = tets[t]->verts[v];
+        if (neighbor->warped || queued[neighbor->tm_v_index])
+          continue;
+        if (std::find(list.begin() + first, list.end(), neighbor) != list.end())
+          continue;
+        if (isVertexViolated(neighbor))
+          list.push_back(neighbor);
+      }
+    }
+  }
+
+  //==============================================================
+  // - colorWarpConflicts()
+  //
+  //  Splits the candidate vertices into color classes that are
+  //  safe to warp concurrently. Warping a vertex rewrites the
+  //  interfaces in its star and in the stars of its neighbors,
+  //  so two candidates conflict when they are three or fewer
+  //  edges apart. Colors are assigned greedily in candidate
+  //  order, so the classes do not depend on the thread count.
+  //==============================================================
+  void CleaverMesherImp::colorWarpConflicts(const std::vector<Vertex*> &candidates,
+                                            std::vector<std::vector<Vertex*> > &classes)
+  {
+    const size_t vert_count = m_bgMesh->verts.size();
+    classes.clear();
+
+    std::vector<int> color(vert_count, -1);
+    std::vector<size_t> seen(vert_count, 0);    // last candidate whose rings reached it
+    std::vector<size_t> taken;                  // last candidate a color was blocked for
+    std::vector<Vertex*> ring, next;
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+      Vertex *vertex = candidates[i];
+
+      // walk three rings, blocking the colors already used there
+      const size_t stamp = i + 1;
+      seen[vertex->tm_v_index] = stamp;
+      ring.assign(1, vertex);
+      for (int depth = 0; depth < 3; depth++)
+      {
+        next.clear();
+        for (size_t r = 0; r < ring.size(); r++) {
+          const std::vector<Tet*> &tets = ring[r]->tets;
+          for (size_t t = 0; t < tets.size(); t++) {
+            for (int v = 0; v < 4; v++) {
+              Vertex *u = tets[t]->verts[v];
+              if (seen[u->tm_v_index] == stamp)
+                continue;
+              seen[u->tm_v_index] = stamp;
+              next.push_back(u);
+              if (color[u->tm_v_index] >= 0)
+                taken[color[u->tm_v_index]] = stamp;
+            }
+          }
+        }
+        ring.swap(next);
+      }
+
+      int c = 0;
+      while (c < static_cast<int>(taken.size()) && taken[c] == stamp)
+        c++;
+      if (c == static_cast<int>(taken.size())) {
+        taken.push_back(0);
+        classes.push_back(std::vector<Vertex*>());
+      }
+      color[vertex->tm_v_index] = c;
+      classes[c].push_back(vertex);
+    }
+  }
+
 
 
   //=========================================================================
@@ -1741,37 +2252,29 @@ namespace cleaver
   //=================================================================
   //  Snap and Warp Violations Surrounding a Vertex
   //=================================================================
-  void CleaverMesherImp::snapAndWarpForViolatedVertex(Vertex *vertex)
-  {
-    std::vector<HalfEdge*>   viol_edges;      // violating cut edges
-    std::vector<HalfFace*>   viol_faces;      // violating triple-points
-    std::vector<Tet*>        viol_tets;       // violating quadruple-points
-
-    std::vector<HalfEdge*>   part_edges;      // participating cut edges
-    std::vector<HalfFace*>   part_faces;      // participating triple-points
-    std::vector<Tet*>        part_tets;       // participating quadruple-points
-
-
-    // TODO: This shouldn't here. It's a temporary fix
-    //
-    //  Explanation:  The algorithm loops through each vertex naively.
-    //           If a warped edge moves an edge to violate some other
-    //           vertex that has not yet been warped, it does nothing,
-    //           knowing that vertex will take of it when it's evaluated.
-    //      The problem is that vertex may have already been touched in
-    //      the list, but simply had no violations so it wasn't warped.
-    //      It will never be evaluated again, and the violation will remain.
-    //  The PROPER fix would be to create a list of potential vertices that
-    //  we pop off of, and we will push new vertices back onto the list if
-    //  we think they might have recently become violated.
-    //
-    vertex->warped = true;
-    //--------------------
+  bool CleaverMesherImp::snapAndWarpForViolatedVertex(Vertex *vertex, unsigned int thread)
+  {
+    SnapScratch &scratch = m_snapScratch[thread];
+    std::vector<HalfEdge*>  &viol_edges = scratch.violEdges;   // violating cut edges
+    std::vector<HalfFace*>  &viol_faces = scratch.violFaces;   // violating triple-points
+    std::vector<Tet*>       &viol_tets  = scratch.violTets;    // violating quadruple-points
+
+    std::vector<HalfEdge*>  &part_edges = scratch.partEdges;   // participating cut edges
+    std::vector<HalfFace*>  &part_faces = scratch.partFaces;   // participating triple-points
+    std::vector<Tet*>       &part_tets  = scratch.partTets;    // participating quadruple-points
+
+    viol_edges.clear();  viol_faces.clear();  viol_tets.clear();
+    part_edges.clear();  part_faces.clear();  part_tets.clear();
+
+
+    // Only vertices that actually warp are marked. If a warp leaves an
+    // interface violating an unwarped neighbor, the worklist in
+    // snapAndWarpVertexViolations() brings that neighbor back.
 
     //---------------------------------------------------------
     //   Add Participating & Violating CutPoints  (Edges)
     //---------------------------------------------------------
-    std::vector<HalfEdge*> incidentEdges = m_bgMesh->edgesAroundVertex(vertex);
+    const std::vector<HalfEdge*> &incidentEdges = m_bgMesh->edgesAroundVertex(vertex);
 
     for (unsigned int e = 0; e < incidentEdges.size(); e++)
     {
@@ -1788,7 +2291,8 @@ namespace cleaver
     //---------------------------------------------------------
     // Add Participating & Violating TriplePoints   (Faces)
     //---------------------------------------------------------
-    std::vector<HalfFace*> incidentFaces = m_bgMesh->facesAroundVertex(vertex);
+    std::vector<HalfFace*> &incidentFaces = scratch.incidentFaces;
+    m_bgMesh->facesAroundVertex(vertex, incidentFaces);
 
     for (unsigned int f = 0; f < incidentFaces.size(); f++)
     {
@@ -1806,7 +2310,7 @@ namespace cleaver
     //---------------------------------------------------------
     // Add Participating & Violating QuaduplePoints   (Tets)
     //---------------------------------------------------------
-    std::vector<Tet*> incidentTets = m_bgMesh->tetsAroundVertex(vertex);
+    const std::vector<Tet*> &incidentTets = m_bgMesh->tetsAroundVertex(vertex);
 
     for (unsigned int t = 0; t < incidentTets.size(); t++)
     {
@@ -1825,7 +2329,7 @@ namespace cleaver
     //-----------------------------------------
     if (viol_edges.empty() && viol_faces.empty() && viol_tets.empty())
     {
-      return;
+      return false;
     }
 
 
@@ -1913,9 +2417,10 @@ namespace cleaver
     for (unsigned int e = 0; e < part_edges.size(); e++)
     {
       HalfEdge *edge = part_edges[e];
-      Tet *innertet = getInnerTet(edge, vertex, warp_point);
+      Tet *innertet = getInnerTet(edge, vertex, warp_point, thread);
 
-      std::vector<HalfFace*> faces = m_bgMesh->facesAroundEdge(edge);
+      std::vector<HalfFace*> &faces = scratch.edgeFaces;
+      m_bgMesh->facesAroundEdge(edge, faces);
 
       bool handled = false;
       for (unsigned int f = 0; f < faces.size(); f++)
@@ -1997,14 +2502,8 @@ namespace cleaver
 
       for (unsigned int c = 0; c < viol_edges.size() && !affected; c++)
       {
-        bool same = true;
-        for (int m = 0; m < m_volume->numberOfMaterials(); m++) {
-          if (part_edges[e]->cut->lbls[m] != viol_edges[c]->cut->lbls[m]) {
-            same = false;
-            break;
-          }
-        }
-        affected = same;
+        affected = part_edges[e]->cut->lbls.equals(
+          viol_edges[c]->cut->lbls, m_volume->numberOfMaterials());
       }
 
       //-----------------------
@@ -2036,7 +2535,7 @@ namespace cleaver
           snapCutForEdgeToVertex(part_edges[e], (Vertex*)cut->closestGeometry);
 
           // Probably should call resolve_degeneracies around vertex(closestGeometry); to be safe
-          resolveDegeneraciesAroundVertex((Vertex*)cut->closestGeometry);
+          resolveDegeneraciesAroundVertex((Vertex*)cut->closestGeometry, thread);
         }
       }
     }
@@ -2063,7 +2562,7 @@ namespace cleaver
           snapTripleForFaceToVertex(part_faces[f], (Vertex*)triple->closestGeometry);
 
           // Probably should call resolve_degeneracies around vertex(closestGeometry); to be safe
-          resolveDegeneraciesAroundVertex((Vertex*)triple->closestGeometry);
+          resolveDegeneraciesAroundVertex((Vertex*)triple->closestGeometry, thread);
         }
       }
     }
@@ -2103,7 +2602,9 @@ namespace cleaver
     //--------------------------------------
     //  Resolve Degeneracies Around Vertex
     //--------------------------------------
-    resolveDegeneraciesAroundVertex(vertex);
+    resolveDegeneraciesAroundVertex(vertex, thread);
+
+    return true;
 
     //---------------------------------------------------------------------
     // end. CleaverMesherImp::snapAndWarpForViolatedVertex(Vertex *vertex)
@@ -2132,9 +2633,10 @@ namespace cleaver
   //  of projection the cut on the participating edge tied
   //  to the current mesh warp.
   //=======================================================================
-  Tet* CleaverMesherImp::getInnerTet(HalfEdge *edge, Vertex *warpVertex, const vec3 &warpPt)
+  Tet* CleaverMesherImp::getInnerTet(HalfEdge *edge, Vertex *warpVertex, const vec3 &warpPt, unsigned int thread)
   {
-    std::vector<Tet*> tets = m_bgMesh->tetsAroundEdge(edge);
+    std::vector<Tet*> &tets = m_snapScratch[thread].edgeTets;
+    m_bgMesh->tetsAroundEdge(edge, tets);
     vec3 hit_pt = vec3::zero;
 
     Vertex *static_vertex;
@@ -2152,11 +2654,13 @@ namespace cleaver
 
     for (unsigned int t = 0; t < tets.size(); t++)
     {
-      std::vector<HalfFace*> faces = m_bgMesh->facesAroundTet(tets[t]);
+      HalfFace *faces[4];
+      m_bgMesh->facesAroundTet(tets[t], faces);
 
       for (int f = 0; f < FACES_PER_TET; f++)
       {
-        std::vector<Vertex*> verts = m_bgMesh->vertsAroundFace(faces[f]);
+        Vertex *verts[3];
+        m_bgMesh->vertsAroundFace(faces[f], verts);
 
         if (triangle_intersection(verts[0], verts[1], verts[2], origin, ray, hit_pt))
         {
@@ -2169,11 +2673,13 @@ namespace cleaver
     // if none hit, make a less picky choice
     for (unsigned int t = 0; t < tets.size(); t++)
     {
-      std::vector<HalfFace*> faces = m_bgMesh->facesAroundTet(tets[t]);
+      HalfFace *faces[4];
+      m_bgMesh->facesAroundTet(tets[t], faces);
 
       for (int f = 0; f < 4; f++)
       {
-        std::vector<Vertex*> verts = m_bgMesh->vertsAroundFace(faces[f]);
+        Vertex *verts[3];
+        m_bgMesh->vertsAroundFace(faces[f], verts);
 
         if (triangle_intersection(verts[0], verts[1], verts[2], origin, ray, hit_pt))
         {
@@ -2200,14 +2706,16 @@ namespace cleaver
     vec3 dmy_pt;
     vec3 ray = normalize(warpPt - face->triple->pos());
 
-    std::vector<Tet*> tets = m_bgMesh->tetsAroundFace(face);
+    Tet *tets[2];
+    int tet_count = m_bgMesh->tetsAroundFace(face, tets);
 
     // if on boundary, return only neighbor tet  (added Mar 14/2013)
-    if (tets.size() == 1)
+    if (tet_count == 1)
       return tets[0];
 
-    std::vector<Vertex*> verts_a = m_bgMesh->vertsAroundTet(tets[0]);
-    std::vector<Vertex*> verts_b = m_bgMesh->vertsAroundTet(tets[1]);
+    Vertex *verts_a[4], *verts_b[4];
+    m_bgMesh->vertsAroundTet(tets[0], verts_a);
+    m_bgMesh->vertsAroundTet(tets[1], verts_b);
 
     // sort them so exterior vertex is first
     for (int v = 0; v < 4; v++) {
@@ -2248,7 +2756,8 @@ namespace cleaver
   vec3 CleaverMesherImp::projectTriple(HalfFace *face, Vertex *quad, Vertex *warpVertex, const vec3 &warpPt)
   {
     Vertex *trip = face->triple;
-    std::vector<Vertex*> verts = m_bgMesh->vertsAroundFace(face);
+    Vertex *verts[3];
+    m_bgMesh->vertsAroundFace(face, verts);
 
     for (int i = 0; i < 3; i++)
     {
@@ -2526,13 +3035,13 @@ namespace cleaver
     //  Apply snapping to all remaining edge-cuts
     //---------------------------------------------------------
     // reset evaluation flag, so we can use to avoid duplicates
-    for (auto &entry : m_bgMesh->halfEdges)
+    for (HalfEdge *edge : m_bgMesh->halfEdges)
     {
       if (verbose) {
         status.printStatus();
       }
-      HalfEdge *edge = entry.second;    // TODO: add  redundancy checks
-      snapAndWarpForViolatedEdge(edge);        //to reduce workload.
+      // TODO: add  redundancy checks to reduce workload.
+      snapAndWarpForViolatedEdge(edge);
     }
     if (verbose) {
       status.done();
@@ -2791,10 +3300,11 @@ namespace cleaver
   //   TODO: This currently checks too much, even vertices
   //         that were snapped a long time ago. Optimize.
   //===================================================
-  void CleaverMesherImp::resolveDegeneraciesAroundVertex(Vertex *vertex)
+  void CleaverMesherImp::resolveDegeneraciesAroundVertex(Vertex *vertex, unsigned int thread)
   {
-    std::vector<HalfFace*> faces = m_bgMesh->facesAroundVertex(vertex);
-    std::vector<Tet*>       tets = m_bgMesh->tetsAroundVertex(vertex);
+    std::vector<HalfFace*> &faces = m_snapScratch[thread].resolveFaces;
+    m_bgMesh->facesAroundVertex(vertex, faces);
+    const std::vector<Tet*> &tets = m_bgMesh->tetsAroundVertex(vertex);
 
     bool changed = true;
     while (changed)
@@ -2812,7 +3322,8 @@ namespace cleaver
         if (tet->quadruple->isEqualTo(vertex))
         {
           // Check if any cuts exist to snap
-          std::vector<HalfEdge*> edges = m_bgMesh->edgesAroundTet(tet);
+          HalfEdge *edges[EDGES_PER_TET];
+          m_bgMesh->edgesAroundTet(tet, edges);
           for (int e = 0; e < EDGES_PER_TET; e++)
           {
             // cut exists & spans the vertex in question
@@ -2824,13 +3335,15 @@ namespace cleaver
           }
 
           // Check if any triples exist to snap
-          std::vector<HalfFace*> faces = m_bgMesh->facesAroundTet(tet);
+          HalfFace *faces[FACES_PER_TET];
+          m_bgMesh->facesAroundTet(tet, faces);
           for (int f = 0; f < FACES_PER_TET; f++)
           {
             // triple exists & spans the vertex in question
             if (faces[f]->triple->order() == Order::TRIP)
             {
-              std::vector<Vertex*> verts = m_bgMesh->vertsAroundFace(faces[f]);
+              Vertex *verts[3];
+              m_bgMesh->vertsAroundFace(faces[f], verts);
               if (verts[0] == vertex || verts[1] == vertex || verts[2] == vertex)
               {
                 snapTripleForFaceToVertex(faces[f], vertex);
@@ -2894,7 +3407,8 @@ namespace cleaver
       {
         if (tets[t] && tets[t]->quadruple->order() == Order::QUAD)
         {
-          std::vector<HalfFace*> faces = m_bgMesh->facesAroundTet(tets[t]);
+          HalfFace *faces[FACES_PER_TET];
+          m_bgMesh->facesAroundTet(tets[t], faces);
 
           // count # trips snapped to vertex
           int count = 0;
@@ -3018,88 +3532,107 @@ namespace cleaver
     //-------------------------------
     // Naively Examine All Tets
     //-------------------------------
-    for (size_t t = 0; t < m_bgMesh->tets.size(); t++)
+    // Stencils are looked up in parallel into per-thread buffers. Output
+    // counts are then prefix summed and the tets are merged in background
+    // tet order, so vertex and tet numbering match a serial sweep.
+    const size_t tet_count = m_bgMesh->tets.size();
+    const int kKeepTet = -1;
+    std::vector<int> stencil_count(tet_count, 0);    // output tets, or kKeepTet
+    std::vector<size_t> stencil_offset(tet_count, 0);
+    std::vector<unsigned int> stencil_thread(tet_count, 0);
+    std::vector<std::vector<StencilTet> > stencil_buffers(m_threadPool.threadCount());
+    std::vector<std::vector<UngeneralizedTet> > ungeneralized(m_threadPool.threadCount());
+
+    // the topological path generalizes without classifying
+    if (m_interfaceTets.size() != tet_count)
+      classifyInterfaceTets();
+
+    m_threadPool.parallelFor(0, tet_count, grainSize(1024),
+      [&](size_t begin, size_t end, unsigned int thread)
     {
-      if (verbose) {
-        status.printStatus();
-      }
-      // ----------------------------------------
-      // Grab Handle to Current Background Tet
-      // ----------------------------------------
-      Tet *tet = m_bgMesh->tets[t];
-
-      //----------------------------------------------------------
-      // Ensure we don't try to stencil a tet that we just added
-      //----------------------------------------------------------
-      if (tet->output)
-        continue;
-      tet->output = true;
-
-      //-----------------------------------
-      // set parent to self
-      //-----------------------------------
-      tet->parent = static_cast<int>(t);
-      const int parent = tet->parent;
+      std::vector<StencilTet> &buffer = stencil_buffers[thread];
+      for (size_t t = begin; t < end; t++)
+      {
+        // ----------------------------------------
+        // Grab Handle to Current Background Tet
+        // ----------------------------------------
+        Tet *tet = m_bgMesh->tets[t];
+
+        //----------------------------------------------------------
+        // Ensure we don't try to stencil a tet that we just added
+        //----------------------------------------------------------
+        if (tet->output)
+          continue;
+        tet->output = true;
+
+        //-----------------------------------
+        // set parent to self
+        //-----------------------------------
+        tet->parent = static_cast<int>(t);
+
+        // homogeneous tets are emitted as they are
+        if (!m_interfaceTets[t]) {
+          stencil_count[t] = kKeepTet;
+          continue;
+        }
 
-      //----------------------------------------
-      // Prepare adjacency info for Stenciling
-      //----------------------------------------
-      Vertex *v[4];
-      HalfEdge *edges[6];
-      HalfFace *faces[4];
-      m_bgMesh->getAdjacencyListsForTet(tet, v, edges, faces);
+        //----------------------------------------
+        // Prepare adjacency info for Stenciling
+        //----------------------------------------
+        Vertex *v[4];
+        HalfEdge *edges[6];
+        HalfFace *faces[4];
+        m_bgMesh->getAdjacencyListsForTet(tet, v, edges, faces);
 
-      bool stencil = false;
-      int cut_count = 0;
-      for (int e = 0; e < EDGES_PER_TET; e++) {
-        cut_count += ((edges[e]->cut && edges[e]->cut->order() == Order::CUT) ? 1 : 0);
-        if (edges[e]->cut && edges[e]->cut->original_order() == Order::CUT)
-          stencil = true;
-      }
+        // roots are found without compressing, other threads share these chains
+        bool stencil = false;
+        int cut_count = 0;
+        for (int e = 0; e < EDGES_PER_TET; e++) {
+          cut_count += ((edges[e]->cut && edges[e]->cut->findRoot()->original_order() == Order::CUT) ? 1 : 0);
+          if (edges[e]->cut && edges[e]->cut->original_order() == Order::CUT)
+            stencil = true;
+        }
 
-      //-- guard against failed generalization (won't guard against inconsistencies)
-      for (int e = 0; e < 6; e++)
-      {
-        if (edges[e]->cut == nullptr)
+        //-- guard against failed generalization (won't guard against inconsistencies)
+        UngeneralizedTet failed = { t, 0, cut_count, 0, false };
+        for (int e = 0; e < 6; e++)
         {
-          std::cout << "Failed Generalization" << std::endl;
-          stencil = false;
+          if (edges[e]->cut == nullptr)
+          {
+            failed.failures++;
+            stencil = false;
+          }
         }
-      }
-      for (int f = 0; f < 4; f++)
-      {
-        if (faces[f]->triple == nullptr)
+        for (int f = 0; f < 4; f++)
         {
-          std::cout << "Failed Generalization" << std::endl;
+          if (faces[f]->triple == nullptr)
+          {
+            failed.failures++;
+            failed.missing_triples |= 1 << f;
+            stencil = false;
+          }
+        }
+        if (tet->quadruple == nullptr)
+        {
+          failed.failures++;
           stencil = false;
         }
-      }
-      if (tet->quadruple == nullptr)
-      {
-        std::cout << "Failed Generalization" << std::endl;
-        stencil = false;
-      }
 
-      if (!stencil && cut_count > 0) {
-        std::cerr << "Skipping ungeneralized tet with " << cut_count << " cuts." << std::endl;
-        if (cut_count == 3) {
-          for (int f = 0; f < 4; f++) {
-            if (faces[f]->triple == nullptr)
-              std::cerr << "Missing Triple T" << f + 1 << std::endl;
-          }
+        // workers stay quiet, the merge below reports these in tet order
+        failed.skipped = !stencil && cut_count > 0;
+        if (failed.failures > 0 || failed.skipped)
+          ungeneralized[thread].push_back(failed);
+
+        if (!stencil) {
+          stencil_count[t] = kKeepTet;
+          continue;
         }
-      }
 
-      if (stencil)
-      {
-        // add new stencil tets, and delete the old ones
-        // 'replacing' the original tet with one of the new
-        // output tets will guarantee we don't have to shift elements,
-        // only add new ones.
         Vertex *verts[15];
         m_bgMesh->getRightHandedVertexList(tet, verts);
 
-        bool first_tet = true;
+        stencil_thread[t] = thread;
+        stencil_offset[t] = buffer.size();
         for (int st = 0; st < 24; st++)
         {
           //---------------------------------------------
@@ -3111,95 +3644,144 @@ namespace cleaver
           //---------------------------------------------
           //     Get Vertices
           //---------------------------------------------
-          Vertex *v1 = verts[stencilTable[st][0]]->root();  // grabbing root ensures uniqueness
-          Vertex *v2 = verts[stencilTable[st][1]]->root();
-          Vertex *v3 = verts[stencilTable[st][2]]->root();
-          Vertex *v4 = verts[stencilTable[st][3]]->root();
-          Vertex *vM = verts[materialTable[st]]->root();
+          StencilTet output;
+          for (int v = 0; v < 4; v++)
+            output.verts[v] = verts[stencilTable[st][v]]->findRoot();  // grabbing root ensures uniqueness
+          output.material = (int)verts[materialTable[st]]->findRoot()->label;
 
           //----------------------------------------------------------
           //  Ensure Tet Not Degenerate (all vertices must be unique)
           //----------------------------------------------------------
-          if (v1 == v2 || v1 == v3 || v1 == v4 || v2 == v3 || v2 == v4 || v3 == v4)
+          Vertex **ov = output.verts;
+          if (ov[0] == ov[1] || ov[0] == ov[2] || ov[0] == ov[3] || ov[1] == ov[2] || ov[1] == ov[3] || ov[2] == ov[3])
             continue;
 
-          //----------------------------------------------------------------
-          // Reconfigure Background Tet to become First Output Stencil Tet
-          //----------------------------------------------------------------
-          if (first_tet)
-          {
-            first_tet = false;
+          buffer.push_back(output);
+          stencil_count[t]++;
+        }
+      }
+    });
 
-            //---------------------------------------
-            // Get Rid of Old Adjacency Information
-            //---------------------------------------
-            for (int v = 0; v < 4; v++)
-            {
-              // check if tet is ever in there twice.. (regardless of whether it should be possible...)
-              int pc = 0;
-              for (size_t j = 0; j < tet->verts[v]->tets.size(); j++)
-              {
-                if (tet->verts[v]->tets[j] == tet)
-                {
-                  pc++;
-                }
-              }
-              if (pc > 1)
-              {
-                std::cout << "Vertex has a Tet stored TWICE in it. Bingo." << std::endl;
-                exit(0);
-              }
+    // new tets go after the background tets, in background tet order
+    size_t new_tets = 0;
+    for (size_t t = 0; t < tet_count; t++) {
+      if (stencil_count[t] > 1)
+        new_tets += stencil_count[t] - 1;
+    }
+    m_bgMesh->tets.reserve(tet_count + new_tets);
 
-              for (size_t j = 0; j < tet->verts[v]->tets.size(); j++)
-              {
-                // Question:  Could tet be there twice?
+    std::vector<UngeneralizedTet> failures;
+    for (size_t i = 0; i < ungeneralized.size(); i++)
+      failures.insert(failures.end(), ungeneralized[i].begin(), ungeneralized[i].end());
+    std::sort(failures.begin(), failures.end(),
+      [](const UngeneralizedTet &a, const UngeneralizedTet &b) { return a.tet < b.tet; });
+    size_t next_failure = 0;
 
-                // remove this tet from the list of all its vertices
-                if (tet->verts[v]->tets[j] == tet) {
-                  tet->verts[v]->tets.erase(tet->verts[v]->tets.begin() + j);
-                  break;
-                }
-              }
+    for (size_t t = 0; t < tet_count; t++)
+    {
+      if (verbose) {
+        status.printStatus();
+      }
+
+      if (next_failure < failures.size() && failures[next_failure].tet == t)
+      {
+        const UngeneralizedTet &failed = failures[next_failure++];
+        for (int i = 0; i < failed.failures; i++)
+          std::cout << "Failed Generalization" << std::endl;
+        if (failed.skipped) {
+          std::cerr << "Skipping ungeneralized tet with " << failed.cut_count << " cuts." << std::endl;
+          if (failed.cut_count == 3) {
+            for (int f = 0; f < 4; f++) {
+              if (failed.missing_triples & (1 << f))
+                std::cerr << "Missing Triple T" << f + 1 << std::endl;
             }
+          }
+        }
+      }
 
-            //----------------------------------
-            // Insert New Defining Vertices
-            //----------------------------------
-            tet->verts[0] = v1;
-            tet->verts[1] = v2;
-            tet->verts[2] = v3;
-            tet->verts[3] = v4;
-            tet->mat_label = (int)vM->label;
-            total_changed++;
-
-            //----------------------------------
-            //  Repair Adjacency Information
-            //----------------------------------
-            for (int v = 0; v < 4; v++)
+      Tet *tet = m_bgMesh->tets[t];
+      const int parent = tet->parent;
+
+      if (stencil_count[t] > 0)
+      {
+        // add new stencil tets, and delete the old ones
+        // 'replacing' the original tet with one of the new
+        // output tets will guarantee we don't have to shift elements,
+        // only add new ones.
+        const StencilTet *outputs = &stencil_buffers[stencil_thread[t]][stencil_offset[t]];
+
+        //----------------------------------------------------------------
+        // Reconfigure Background Tet to become First Output Stencil Tet
+        //----------------------------------------------------------------
+
+        //---------------------------------------
+        // Get Rid of Old Adjacency Information
+        //---------------------------------------
+        for (int v = 0; v < 4; v++)
+        {
+          // check if tet is ever in there twice.. (regardless of whether it should be possible...)
+          int pc = 0;
+          for (size_t j = 0; j < tet->verts[v]->tets.size(); j++)
+          {
+            if (tet->verts[v]->tets[j] == tet)
             {
-              if (tet->verts[v]->tm_v_index < 0)
-              {
-                tet->verts[v]->tm_v_index = static_cast<int>(m_bgMesh->verts.size());
-                m_bgMesh->verts.push_back(tet->verts[v]);
-              }
-              tet->verts[v]->tets.push_back(tet);
+              pc++;
             }
+          }
+          if (pc > 1)
+          {
+            std::cout << "Vertex has a Tet stored TWICE in it. Bingo." << std::endl;
+            exit(0);
+          }
+
+          for (size_t j = 0; j < tet->verts[v]->tets.size(); j++)
+          {
+            // Question:  Could tet be there twice?
 
+            // remove this tet from the list of all its vertices
+            if (tet->verts[v]->tets[j] == tet) {
+              tet->verts[v]->tets.erase(tet->verts[v]->tets.begin() + j);
+              break;
+            }
           }
-          //---------------------------------
-          //  Create New Tet + Add to List
-          //---------------------------------
-          else {
-            // create new ones for any extra
-            Tet *nst = m_bgMesh->createTet(v1, v2, v3, v4, (int)vM->label);
-            nst->parent = parent;
-            nst->output = true;  // so we don't come back to this output tet again
-            nst->key = tet->key;
-            total_output++;
+        }
+
+        //----------------------------------
+        // Insert New Defining Vertices
+        //----------------------------------
+        for (int v = 0; v < 4; v++)
+          tet->verts[v] = outputs[0].verts[v];
+        tet->mat_label = outputs[0].material;
+        total_changed++;
+
+        //----------------------------------
+        //  Repair Adjacency Information
+        //----------------------------------
+        for (int v = 0; v < 4; v++)
+        {
+          if (tet->verts[v]->tm_v_index < 0)
+          {
+            tet->verts[v]->tm_v_index = static_cast<int>(m_bgMesh->verts.size());
+            m_bgMesh->verts.push_back(tet->verts[v]);
           }
+          tet->verts[v]->tets.push_back(tet);
         }
 
-      } else {
+        //---------------------------------
+        //  Create New Tet + Add to List
+        //---------------------------------
+        for (int st = 1; st < stencil_count[t]; st++)
+        {
+          // create new ones for any extra
+          const StencilTet &output = outputs[st];
+          Tet *nst = m_bgMesh->createTet(output.verts[0], output.verts[1], output.verts[2], output.verts[3], output.material);
+          nst->parent = parent;
+          nst->output = true;  // so we don't come back to this output tet again
+          nst->key = tet->key;
+          total_output++;
+        }
+
+      } else if (stencil_count[t] == kKeepTet) {
 
         // set tet to proper material
         total_changed++;
@@ -3225,9 +3807,15 @@ namespace cleaver
       status.done();
     }
 
+    // flags no longer line up with the grown tet list
+    m_interfaceTets.clear();
+
     // mesh is now 'done'
     m_mesh = m_bgMesh;
 
+    if (m_bReorderSpatially)
+      m_mesh->reorderSpatially(verbose);
+
     // recompute adjacency
     m_mesh->constructFaces();
 
@@ -7,6 +7,7 @@ namespace cleaver {
 
 class Volume;
 class TetMesh;
+class ThreadPool;
 class CleaverMesherImp;
 
 class CleaverMesher
@@ -76,6 +77,19 @@ public:
     //================================
     void setAlphas(double l, double s);
     void setConstant(bool reg);
+    void setReorderSpatially(bool reorder);
+    void setParallelWarping(bool parallel);      // warp by conflict free colors, ordering differs from serial
+    void setThreadCount(unsigned int threads);   // 0 uses all hardware threads
+    void setDeterministic(bool deterministic);   // guarantee the same output for any thread count or schedule
+    unsigned int getThreadCount() const;
+
+    // Sets threads, deterministic mode and the chunk size of the
+    // mesher's per element loops (0 keeps each loop's default).
+    void setExecutionPolicy(unsigned int threads, size_t grain = 0, bool deterministic = false);
+
+    // The pool the mesher runs on. Pass it to the sizing field,
+    // octree and writer stages so they share the same threads.
+    ThreadPool& threadPool();
 
 private:
     CleaverMesherImp *m_pimpl;
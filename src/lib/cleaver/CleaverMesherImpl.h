@@ -15,6 +15,7 @@
 #include "CleaverMesher.h"
 #include "InterfaceCalculator.h"
 #include "ViolationChecker.h"
+#include "ThreadPool.h"
 
 namespace cleaver {
 
@@ -55,7 +56,7 @@ public:
     void snapAndWarpEdgeViolations(bool verbose = false);
     void snapAndWarpFaceViolations(bool verbose = false);
 
-    void snapAndWarpForViolatedVertex(Vertex *vertex);
+    bool snapAndWarpForViolatedVertex(Vertex *vertex, unsigned int thread = 0);   // true if it warped
     void snapAndWarpForViolatedEdge(HalfEdge *edge);
     void snapAndWarpForViolatedFace(HalfFace *face);
 
@@ -71,14 +72,21 @@ public:
     void snapQuadrupleForTetToEdge(Tet *tet, HalfEdge *edge);
     void snapQuadrupleForTetToTriple(Tet *tet, Vertex *triple);
 
-    void resolveDegeneraciesAroundVertex(Vertex *vertex);
+    void resolveDegeneraciesAroundVertex(Vertex *vertex, unsigned int thread = 0);
     void resolveDegeneraciesAroundEdge(HalfEdge *edge);
 
-    Tet* getInnerTet(HalfEdge *edge, Vertex *warpVertex, const vec3 &warpPt);
+    Tet* getInnerTet(HalfEdge *edge, Vertex *warpVertex, const vec3 &warpPt, unsigned int thread = 0);
     Tet* getInnerTet(HalfFace *face, Vertex *warpVertex, const vec3 &warpPt);
     vec3 projectCut(HalfEdge *edge, Tet *tet, Vertex *warpVertex, const vec3 &warpPt);
     vec3 projectTriple(HalfFace *face, Vertex *quadruple, Vertex *warpVertex, const vec3 &warpPt);
 
+    bool isVertexViolated(Vertex *vertex);
+    void queueViolatedNeighbors(Vertex *vertex, std::vector<char> &queued, std::vector<Vertex*> &list);
+    void collectViolatedNeighbors(Vertex *vertex, const std::vector<char> &queued, std::vector<Vertex*> &list);
+    void colorWarpConflicts(const std::vector<Vertex*> &candidates,
+                            std::vector<std::vector<Vertex*> > &classes);
+    size_t classifyInterfaceTets();
+
 
     // -- algorithm state --
     bool m_bBackgroundMeshCreated;
@@ -95,6 +103,19 @@ public:
     // Whether to use simple interface approximation.
     bool m_bSimple;
 
+    // Whether to sort background and output meshes along a Morton curve.
+    bool m_bReorderSpatially;
+
+    // Whether to warp violated vertices in rounds of conflict free colors,
+    // in parallel, instead of one at a time from a queue.
+    bool m_bParallelWarp;
+
+    // Guarantees results do not depend on the thread count or on how
+    // work was scheduled. Every parallel stage currently merges in a
+    // fixed order, so this holds by default. A stage that would trade
+    // ordering for speed must keep the fixed order when this is set.
+    bool m_bDeterministic;
+
     std::set<size_t> m_tets_to_record;
     std::ofstream m_recorder_stream;
 
@@ -105,6 +126,12 @@ public:
     CleaverMesher::TopologyMode m_topologyMode;
     double m_alpha_init;
 
+    ThreadPool m_threadPool;
+
+    // iterations per chunk for the element loops, 0 lets each loop pick
+    size_t m_grainSize;
+    size_t grainSize(size_t preferred) const { return m_grainSize ? m_grainSize : preferred; }
+
     Volume *m_volume;
     AbstractScalarField *m_sizingField;
     SizingFieldOracle   *m_sizingOracle;
@@ -112,6 +139,22 @@ public:
     ViolationChecker    *m_violationChecker;
     TetMesh *m_bgMesh;
     TetMesh *m_mesh;
+
+    // scratch lists reused by the snap & warp routines, so that
+    // visiting a vertex does not allocate once they have grown,
+    // one set for each thread that may be warping
+    struct SnapScratch {
+        std::vector<HalfEdge*> violEdges, partEdges;
+        std::vector<HalfFace*> violFaces, partFaces;
+        std::vector<Tet*>      violTets,  partTets;
+        std::vector<HalfFace*> incidentFaces, edgeFaces, resolveFaces;
+        std::vector<Tet*>      edgeTets;
+    };
+    std::vector<SnapScratch> m_snapScratch;
+
+    // one flag per background tet, set if any of its edges holds a real
+    // cut. Tets left unflagged are homogeneous and skip the stencils.
+    std::vector<char> m_interfaceTets;
 };
 
 }
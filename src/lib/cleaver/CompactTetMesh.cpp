@@ -0,0 +1,1519 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- Compact TetMesh Class
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+//-------------------------------------------------------------------
+
+#include "CompactTetMesh.h"
+
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cmath>
+#include <map>
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+#include "Face.h"
+#include "Util.h"
+#include "Matlab.h"
+#include "Status.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+#ifndef PI
+#define PI 3.14159265
+#endif
+
+#ifdef WIN32
+#include <direct.h>
+#define GetCurrentDir _getcwd
+#else
+#include <unistd.h>
+#define GetCurrentDir getcwd
+#endif
+
+
+namespace cleaver
+{
+  CompactTetMesh::CompactTetMesh() : min_angle(0), max_angle(0), time(0)
+  {
+  }
+
+  //===================================================
+  // - CompactTetMesh()
+  //
+  // Copy the vertex positions, connectivity and face
+  // lists out of a pointer based TetMesh. Vertex
+  // indices are taken from tm_v_index, tet indices
+  // from the tets array order.
+  //===================================================
+  CompactTetMesh::CompactTetMesh(const TetMesh &mesh) :
+    min_angle(mesh.min_angle), max_angle(mesh.max_angle), time(mesh.time)
+  {
+    positions.resize(3*mesh.verts.size());
+    for(size_t v=0; v < mesh.verts.size(); v++)
+    {
+      const vec3 &p = mesh.verts[v]->pos();
+      positions[3*v+0] = p.x;
+      positions[3*v+1] = p.y;
+      positions[3*v+2] = p.z;
+    }
+
+    tets.resize(4*mesh.tets.size());
+    labels.resize(mesh.tets.size());
+    parents.resize(mesh.tets.size());
+    for(size_t t=0; t < mesh.tets.size(); t++)
+    {
+      const Tet *tet = mesh.tets[t];
+      for(int v=0; v < 4; v++)
+        tets[4*t+v] = tet->verts[v]->tm_v_index;
+      labels[t] = tet->mat_label;
+      parents[t] = tet->parent;
+    }
+
+    faces.resize(3*mesh.faces.size());
+    faceTets.resize(2*mesh.faces.size());
+    for(size_t f=0; f < mesh.faces.size(); f++)
+    {
+      const Face *face = mesh.faces[f];
+      faces[3*f+0] = face->verts[0];
+      faces[3*f+1] = face->verts[1];
+      faces[3*f+2] = face->verts[2];
+      faceTets[2*f+0] = face->tets[0];
+      faceTets[2*f+1] = face->tets[1];
+    }
+  }
+
+  //===================================================
+  // - constructAdjacency()
+  //
+  // Build the vertex to tet incidence lists in CSR
+  // form using a counting sort over the tet array.
+  //===================================================
+  void CompactTetMesh::constructAdjacency()
+  {
+    vertTetOffsets.assign(vertCount() + 1, 0);
+    for(size_t i=0; i < tets.size(); i++)
+      vertTetOffsets[tets[i] + 1]++;
+    for(size_t v=0; v < vertCount(); v++)
+      vertTetOffsets[v+1] += vertTetOffsets[v];
+
+    std::vector<int32_t> next(vertTetOffsets.begin(), vertTetOffsets.end() - 1);
+    vertTets.resize(tets.size());
+    for(size_t t=0; t < tetCount(); t++)
+      for(int v=0; v < 4; v++)
+        vertTets[next[tets[4*t+v]]++] = static_cast<int32_t>(t);
+  }
+
+  void CompactTetMesh::clearAdjacency()
+  {
+    std::vector<int32_t>().swap(vertTetOffsets);
+    std::vector<int32_t>().swap(vertTets);
+  }
+
+  //===================================================
+  // - stripMaterial()
+  //
+  // Remove all tets of the given material along with
+  // any vertices left unreferenced. Remaining vertices
+  // are renumbered in order of first use, matching
+  // TetMesh::stripMaterial().
+  //===================================================
+  void CompactTetMesh::stripMaterial(char material, bool verbose)
+  {
+    std::vector<int32_t> vert_map(vertCount(), -1);
+    std::vector<int32_t> tet_map(tetCount(), -1);
+    int32_t vert_count = 0;
+    int32_t tet_count = 0;
+
+    for(size_t t=0; t < tetCount(); t++) {
+      if(labels[t] == material)
+        continue;
+
+      for(int v=0; v < 4; v++) {
+        int32_t &index = vert_map[tets[4*t+v]];
+        if(index < 0)
+          index = vert_count++;
+        tets[4*tet_count+v] = index;
+      }
+      labels[tet_count] = labels[t];
+      parents[tet_count] = parents[t];
+      tet_map[t] = tet_count++;
+    }
+
+    std::vector<double> stripped_positions(3*vert_count);
+    for(size_t v=0; v < vert_map.size(); v++) {
+      if(vert_map[v] < 0)
+        continue;
+      memcpy(&stripped_positions[3*vert_map[v]], &positions[3*v], 3*sizeof(double));
+    }
+
+    // keep faces that still border a tet
+    size_t face_count = 0;
+    for(size_t f=0; f < faceCount(); f++) {
+      int32_t t1 = faceTets[2*f+0] < 0 ? -1 : tet_map[faceTets[2*f+0]];
+      int32_t t2 = faceTets[2*f+1] < 0 ? -1 : tet_map[faceTets[2*f+1]];
+      if(t1 < 0 && t2 < 0)
+        continue;
+
+      for(int v=0; v < 3; v++)
+        faces[3*face_count+v] = vert_map[faces[3*f+v]];
+      faceTets[2*face_count+0] = t1;
+      faceTets[2*face_count+1] = t2;
+      face_count++;
+    }
+
+    size_t stripped_verts_count = vertCount() - vert_count;
+    size_t stripped_tets_count = tetCount() - tet_count;
+
+    positions.swap(stripped_positions);
+    tets.resize(4*tet_count);
+    labels.resize(tet_count);
+    parents.resize(tet_count);
+    faces.resize(3*face_count);
+    faceTets.resize(2*face_count);
+
+    if(hasAdjacency())
+      constructAdjacency();
+
+    if(verbose) {
+      std::cout << "Stripped " << stripped_tets_count << " tets from mesh exterior." << std::endl;
+      std::cout << "Stripped " << stripped_verts_count << " verts from mesh exterior." << std::endl;
+    }
+  }
+
+  //===================================================
+  // - bandwidth()
+  //
+  // Bandwidth of the vertex adjacency (stiffness)
+  // matrix implied by the tet connectivity.
+  //===================================================
+  size_t CompactTetMesh::bandwidth() const
+  {
+    size_t result = 0;
+    for(size_t t=0; t < tetCount(); t++) {
+      const int32_t *tet = &tets[4*t];
+      int32_t lo = std::min(std::min(tet[0], tet[1]), std::min(tet[2], tet[3]));
+      int32_t hi = std::max(std::max(tet[0], tet[1]), std::max(tet[2], tet[3]));
+      result = std::max(result, static_cast<size_t>(hi - lo));
+    }
+    return result;
+  }
+
+  //===================================================
+  // - reorderRCM()
+  //
+  // Renumber vertices in Reverse Cuthill-McKee order to
+  // reduce the bandwidth of matrices assembled on the
+  // mesh, then sort tets by their lowest vertex so that
+  // element loops sweep the vertices in order. Each
+  // connected component is started from a
+  // pseudo-peripheral vertex. Faces follow both.
+  //===================================================
+  void CompactTetMesh::reorderRCM(bool verbose)
+  {
+    const size_t nv = vertCount();
+    const size_t before = bandwidth();
+    bool had_adjacency = hasAdjacency();
+    constructAdjacency();
+
+    //-----------------------------------
+    //  Build Vertex Graph (CSR)
+    //-----------------------------------
+    std::vector<int32_t> offsets(nv + 1, 0);
+    std::vector<int32_t> neighbors;
+    std::vector<int32_t> mark(nv, -1);
+    neighbors.reserve(vertTets.size() * 2);
+    for(size_t v=0; v < nv; v++) {
+      mark[v] = static_cast<int32_t>(v);
+      for(int32_t i = tetsAroundVertexBegin(v); i < tetsAroundVertexEnd(v); i++) {
+        const int32_t *tet = &tets[4*vertTets[i]];
+        for(int j=0; j < 4; j++) {
+          if(mark[tet[j]] != static_cast<int32_t>(v)) {
+            mark[tet[j]] = static_cast<int32_t>(v);
+            neighbors.push_back(tet[j]);
+          }
+        }
+      }
+      offsets[v+1] = static_cast<int32_t>(neighbors.size());
+    }
+    if(!had_adjacency)
+      clearAdjacency();
+
+    //-----------------------------------
+    //  Cuthill-McKee Traversal
+    //-----------------------------------
+    std::vector<int32_t> order;
+    std::vector<int32_t> level(nv, -1);
+    std::vector<char> visited(nv, 0);
+    order.reserve(nv);
+
+    // breadth first walk from root, neighbors by increasing degree
+    auto degree = [&](int32_t v) { return offsets[v+1] - offsets[v]; };
+    auto by_degree = [&](int32_t a, int32_t b) {
+      return degree(a) < degree(b) || (degree(a) == degree(b) && a < b);
+    };
+    auto traverse = [&](int32_t root, std::vector<int32_t> &queue, std::vector<char> &seen) {
+      size_t head = queue.size();
+      queue.push_back(root);
+      seen[root] = 1;
+      level[root] = 0;
+      while(head < queue.size()) {
+        int32_t v = queue[head++];
+        size_t first = queue.size();
+        for(int32_t i = offsets[v]; i < offsets[v+1]; i++) {
+          int32_t n = neighbors[i];
+          if(!seen[n]) {
+            seen[n] = 1;
+            level[n] = level[v] + 1;
+            queue.push_back(n);
+          }
+        }
+        std::sort(queue.begin() + first, queue.end(), by_degree);
+      }
+    };
+
+    std::vector<int32_t> probe;
+    std::vector<char> probed(nv, 0);
+    for(size_t s=0; s < nv; s++) {
+      if(visited[s])
+        continue;
+
+      // pick a pseudo-peripheral root: repeatedly jump to the lowest
+      // degree vertex of the last level while eccentricity grows
+      int32_t root = static_cast<int32_t>(s);
+      int32_t depth = -1;
+      for(int pass=0; pass < 8; pass++) {
+        probe.clear();
+        traverse(root, probe, probed);
+        int32_t last = level[probe.back()];
+        int32_t candidate = probe.back();
+        for(size_t i=0; i < probe.size(); i++) {
+          probed[probe[i]] = 0;
+          if(level[probe[i]] == last && by_degree(probe[i], candidate))
+            candidate = probe[i];
+        }
+        if(last <= depth)
+          break;
+        depth = last;
+        root = candidate;
+      }
+
+      traverse(root, order, visited);
+    }
+
+    std::reverse(order.begin(), order.end());
+    std::vector<int32_t> vert_map(nv);
+    for(size_t i=0; i < nv; i++)
+      vert_map[order[i]] = static_cast<int32_t>(i);
+
+    //-----------------------------------
+    //  Apply Vertex Permutation
+    //-----------------------------------
+    std::vector<double> sorted_positions(positions.size());
+    for(size_t v=0; v < nv; v++)
+      memcpy(&sorted_positions[3*vert_map[v]], &positions[3*v], 3*sizeof(double));
+    positions.swap(sorted_positions);
+    for(size_t i=0; i < tets.size(); i++)
+      tets[i] = vert_map[tets[i]];
+    for(size_t i=0; i < faces.size(); i++)
+      faces[i] = vert_map[faces[i]];
+
+    //-----------------------------------
+    //  Sort Tets By Lowest Vertex
+    //-----------------------------------
+    std::vector<std::pair<int32_t, int32_t> > tet_order(tetCount());
+    for(size_t t=0; t < tetCount(); t++) {
+      const int32_t *tet = &tets[4*t];
+      int32_t lo = std::min(std::min(tet[0], tet[1]), std::min(tet[2], tet[3]));
+      tet_order[t] = std::make_pair(lo, static_cast<int32_t>(t));
+    }
+    std::sort(tet_order.begin(), tet_order.end());
+
+    std::vector<int32_t> tet_map(tetCount());
+    std::vector<int32_t> sorted_tets(tets.size());
+    std::vector<char>    sorted_labels(labels.size());
+    std::vector<int32_t> sorted_parents(parents.size());
+    for(size_t t=0; t < tet_order.size(); t++) {
+      int32_t old = tet_order[t].second;
+      tet_map[old] = static_cast<int32_t>(t);
+      memcpy(&sorted_tets[4*t], &tets[4*old], 4*sizeof(int32_t));
+      sorted_labels[t] = labels[old];
+      sorted_parents[t] = parents[old];
+    }
+    tets.swap(sorted_tets);
+    labels.swap(sorted_labels);
+    parents.swap(sorted_parents);
+    for(size_t i=0; i < faceTets.size(); i++)
+      if(faceTets[i] >= 0)
+        faceTets[i] = tet_map[faceTets[i]];
+
+    if(had_adjacency)
+      constructAdjacency();
+
+    if(verbose) {
+      std::cout << "Reordered " << nv << " verts by Reverse Cuthill-McKee." << std::endl;
+      std::cout << "Bandwidth: " << before << " -> " << bandwidth() << std::endl;
+    }
+  }
+
+  size_t CompactTetMesh::fixVertexWindup(bool verbose) {
+    if (verbose) std::cout <<
+      "Fixing Vertex wind-up..." << std::endl;
+    size_t count = 0;
+    Status s(tetCount());
+    // loop over all tets in the mesh
+    for(size_t t=0; t < tetCount(); t++) {
+      int32_t *tet = &tets[4*t];
+      vec3 v1 = position(tet[0]);
+      vec3 v2 = position(tet[1]);
+      vec3 v3 = position(tet[2]);
+      vec3 v4 = position(tet[3]);
+      //check the wind up.
+      if ((v4 - v1).dot((v2 - v1).cross(v3 - v1)) < 0.f) {
+        //re-order since v4 is on the wrong side.
+        std::swap(tet[2], tet[3]);
+        count++;
+      }
+      if (verbose)
+        s.printStatus();
+    }
+    if (verbose)
+      s.done();
+
+    if (verbose) {
+      std::cout << "Fixed " << count << " Tet vertex wind-ups." << std::endl;
+    }
+    return count;
+  }
+
+  void CompactTetMesh::computeAngles()
+  {
+    double min = 180;
+    double max = 0;
+    Status status(tetCount());
+    int bad_tets = 0;
+
+    for (size_t i=0; i < tetCount(); i++)
+    {
+      status.printStatus();
+      const int32_t *t = &tets[4*i];
+
+      //each tet has 6 dihedral angles between pairs of faces
+      //compute the face normals for each face
+      vec3 face_normals[4];
+
+      for (int j=0; j<4; j++) {
+        vec3 v0 = position(t[(j+1)%4]);
+        vec3 v1 = position(t[(j+2)%4]);
+        vec3 v2 = position(t[(j+3)%4]);
+        vec3 normal = normalize(cross(v1-v0,v2-v0));
+
+        // make sure normal faces 4th (opposite) vertex
+        vec3 v3 = position(t[(j+0)%4]);
+        vec3 v3_dir = normalize(v3 - v0);
+        if(dot(v3_dir, normal) > 0)
+          normal *= -1;
+
+        face_normals[j] = normal;
+      }
+
+      double local_min = 180., local_max = 0.;
+
+      //now compute the 6 dihedral angles between each pair of faces
+      for (int j=0; j<4; j++) {
+        for (int k=j+1; k<4; k++) {
+          double dot_product = dot(face_normals[j], face_normals[k]);
+          if (dot_product < -1) {
+            dot_product = -1;
+          } else if (dot_product > 1) {
+            dot_product = 1;
+          }
+
+          double dihedral_angle = 180.0 - acos(dot_product) * 180.0 / PI;
+          if (local_min > dihedral_angle) local_min = dihedral_angle;
+          if (local_max < dihedral_angle) local_max = dihedral_angle;
+          if (dihedral_angle < min) min = dihedral_angle;
+          if (dihedral_angle > max) max = dihedral_angle;
+        }
+      }
+
+      if(local_max == 180){
+        bad_tets++;
+        std::cout << "ERROR, TET #: " << i << std::endl;
+        std::cout << "\t vertex positions: {"
+          << position(t[0]) << ", "
+          << position(t[1]) << ", "
+          << position(t[2]) << ", "
+          << position(t[3]) << "} " << std::endl;
+      }
+    }
+    status.done();
+    if (bad_tets > 0) {
+      std::cout << "Errors: " << bad_tets << " degenerate tets." << std::endl;
+    }
+
+    min_angle = min;
+    max_angle = max;
+  }
+
+  void CompactTetMesh::writeInfo(const string &filename, bool verbose) const
+  {
+    //-----------------------------------
+    //         Create Pts File
+    //-----------------------------------
+    std::string info_filename = filename + ".info";
+    if(verbose)
+      std::cout << "Writing info file: " << info_filename << std::endl;
+    std::ofstream info_file(info_filename.c_str());
+
+    info_file.precision(8);
+    info_file << "min_angle = " << min_angle << std::endl;
+    info_file << "max_angle = " << max_angle << std::endl;
+    info_file << "tet_count = " << tetCount() << std::endl;
+    info_file << "vtx_count = " << vertCount() << std::endl;
+    info_file << "mesh time = " << time << "s" << std::endl;
+
+    info_file.close();
+  }
+
+  //===================================================
+  // vec3 comparator
+  //
+  //===================================================
+  class vec3_compare {
+    public:
+      bool operator()(const vec3 &a, const vec3 &b) const {
+        if ((a.x < b.x) && (b.x - a.x) > 1e-9) return true;
+        else if ((a.x > b.x) && (a.x - b.x) > 1e-9) return false;
+        if ((a.y < b.y) && (b.y - a.y) > 1e-9) return true;
+        else if ((a.y > b.y) && (a.y - b.y) > 1e-9) return false;
+        if ((a.z < b.z) && (b.z - a.z) > 1e-9) return true;
+        else if ((a.z > b.z) && (a.z - b.z) > 1e-9) return false;
+        return false;
+      }
+  };
+  typedef std::map< const vec3, size_t, vec3_compare > VertMap;
+
+  //===================================================
+  // writePly()
+  //
+  // Public method that writes the surface mesh
+  // in the PLY triangle file format.
+  //===================================================
+  void CompactTetMesh::writePly(const std::string &filename, bool verbose) const
+  {
+    //-----------------------------------
+    //           Initialize
+    //-----------------------------------
+    if(verbose)
+      cout << "Writing mesh ply file: " << filename + ".ply" << endl;
+    ofstream file((filename + ".ply").c_str());
+
+    std::vector<size_t> interfaces;
+    std::vector<size_t> colors;
+    std::vector<size_t> keys;
+
+    // determine output faces and vertices vertex counts
+    for(size_t f=0; f < faceCount(); f++)
+    {
+      const int t1_index = static_cast<int>(faceTets[2*f+0]);
+      const int t2_index = static_cast<int>(faceTets[2*f+1]);
+
+      if(t1_index < 0 || t2_index < 0){
+        continue;
+      }
+
+      const char label1 = labels[t1_index];
+      const char label2 = labels[t2_index];
+
+      if(label1 != label2)
+      {
+        interfaces.push_back(f);
+
+        const size_t color_key = (size_t)((1 << (int)label1) + (1 << (int)label2));
+        int color_index = -1;
+        for(size_t k=0; k < keys.size(); k++)
+        {
+          if(keys[k] == color_key){
+            color_index = static_cast<int>(k);
+            break;
+          }
+        }
+        if(color_index == -1)
+        {
+          keys.push_back(color_key);
+          color_index = static_cast<int>(keys.size() - 1);
+        }
+
+        colors.push_back(color_index);
+      }
+    }
+
+    //-----------------------------------
+    //           Write Header
+    //-----------------------------------
+    file << "ply" << endl;
+    file << "format ascii 1.0" << endl;
+
+    //-----------------------------------
+    //         Create Pruned Vertex List
+    //-----------------------------------
+    VertMap vert_map;
+    std::vector<vec3> pruned_verts;
+    size_t pruned_pos = 0;
+    for(size_t f=0; f < interfaces.size(); f++)
+    {
+      const int32_t *face = &faces[3*interfaces[f]];
+
+      vec3 p1 = position(face[0]);
+      vec3 p2 = position(face[1]);
+      vec3 p3 = position(face[2]);
+
+      if (!vert_map.count(p1)) {
+        vert_map.insert(std::pair<vec3,size_t>(p1,pruned_pos));
+        pruned_pos++;
+        pruned_verts.push_back(p1);
+      }
+      if (!vert_map.count(p2)) {
+        vert_map.insert(std::pair<vec3,size_t>(p2,pruned_pos));
+        pruned_pos++;
+        pruned_verts.push_back(p2);
+      }
+      if (!vert_map.count(p3)) {
+        vert_map.insert(std::pair<vec3,size_t>(p3,pruned_pos));
+        pruned_pos++;
+        pruned_verts.push_back(p3);
+      }
+    }
+    file << "element vertex " << pruned_verts.size() << endl;
+    file << "property float x " << endl;
+    file << "property float y " << endl;
+    file << "property float z " << endl;
+    file << "element face " << interfaces.size() << endl;
+    file << "property list uchar int vertex_index" << endl;
+    file << "property uchar red" << endl;
+    file << "property uchar green" << endl;
+    file << "property uchar blue" << endl;
+    file << "end_header" << endl;
+
+    //-----------------------------------
+    //         Write Vertex List
+    //-----------------------------------
+    for(std::vector<vec3>::iterator it = pruned_verts.begin();
+        it != pruned_verts.end(); ++it) {
+      file << it->x << " " << it->y << " " << it->z << std::endl;
+    }
+
+    //-----------------------------------
+    //         Write Face List
+    //-----------------------------------
+    for(size_t f=0; f < interfaces.size(); f++)
+    {
+      const int32_t *face = &faces[3*interfaces[f]];
+
+      size_t i1 = vert_map.find(position(face[0]))->second;
+      size_t i2 = vert_map.find(position(face[1]))->second;
+      size_t i3 = vert_map.find(position(face[2]))->second;
+      // output 3 vertices
+      file << "3 " << i1 << " " << i2 << " " << i3 << " ";
+
+      // output 3 color components
+      file << (int)(255*INTERFACE_COLORS[colors[f]%12][0]) << " ";
+      file << (int)(255*INTERFACE_COLORS[colors[f]%12][1]) << " ";
+      file << (int)(255*INTERFACE_COLORS[colors[f]%12][2]) << endl;
+    }
+
+    //-----------------------------------
+    //          Close  File
+    //-----------------------------------
+    file.close();
+  }
+
+  namespace {
+    //---------------------------------------------------
+    // Writes lines [0,count) produced by line(stream, i).
+    // With a pool, blocks of lines are formatted into
+    // strings concurrently, one batch at a time, and the
+    // batch is written out in order.
+    //---------------------------------------------------
+    template <typename LineWriter>
+    void writeLines(ostream &file, size_t count, ThreadPool *pool, const LineWriter &line)
+    {
+      if (!pool || pool->threadCount() == 1) {
+        for (size_t i = 0; i < count; i++)
+          line(file, i);
+        return;
+      }
+
+      const size_t block = 8192;
+      vector<string> blocks(4 * pool->threadCount());
+      for (size_t first = 0; first < count; first += block * blocks.size())
+      {
+        size_t block_count = std::min(blocks.size(), (count - first + block - 1) / block);
+        pool->parallelFor(0, block_count, 1, [&](size_t begin, size_t end, unsigned int)
+        {
+          for (size_t b = begin; b < end; b++) {
+            ostringstream stream;
+            size_t last = std::min(count, first + (b + 1) * block);
+            for (size_t i = first + b * block; i < last; i++)
+              line(stream, i);
+            blocks[b] = stream.str();
+          }
+        });
+        for (size_t b = 0; b < block_count; b++)
+          file << blocks[b];
+      }
+    }
+  }
+
+  //===================================================
+  // writeNodeEle()
+  //
+  // Public method that writes the mesh
+  // in the TetGen node/ele file format.
+  //===================================================
+  void CompactTetMesh::writeNodeEle(const string &filename, bool verbose, bool include_materials, bool include_parents,
+                                    ThreadPool *pool) const
+  {
+    //-----------------------------------
+    //  Determine Attributes to Include
+    //-----------------------------------
+    int attribute_count = 0;
+    if(include_materials)
+      attribute_count++;
+    if(include_parents)
+      attribute_count++;
+
+
+    //-----------------------------------
+    //         Write Node File
+    //-----------------------------------
+    string node_filename = filename + ".node";
+    if(verbose)
+      cout << "Writing mesh node file: " << node_filename << endl;
+    ofstream node_file(node_filename.c_str());
+
+    //---------------------------------------------------------------------------------------------------------
+    //  First line: <# of points> <dimension (must be 3)> <# of attributes> <# of boundary markers (0 or 1)>
+    //---------------------------------------------------------------------------------------------------------
+    node_file << "# Node count, 3 dim, no attributes, no boundary markers" << endl;
+    node_file << vertCount() << " 3  0  0" << endl << endl;
+
+    //-------------------------------------------------------------------------------------------
+    //  Remaining lines list # of points:  <point #> <x> <y> <z> [attributes] [boundary marker]
+    //-------------------------------------------------------------------------------------------
+    writeLines(node_file, vertCount(), pool, [&](ostream &out, size_t i)
+    {
+      out << i+1 << " " << positions[3*i+0] << " " << positions[3*i+1] << " " << positions[3*i+2] << "\n";
+    });
+
+    node_file.close();
+
+
+    //-----------------------------------
+    //        Write Element File
+    //-----------------------------------
+    string elem_filename = filename + ".ele";
+    if(verbose)
+      cout << "Writing mesh ele file: " << elem_filename << endl;
+    ofstream elem_file(elem_filename.c_str());
+
+    //---------------------------------------------------------------------------
+    //  First line: <# of tetrahedra> <nodes per tetrahedron> <# of attributes>
+    //--------------------------------------------------------------------------
+    elem_file << "# Tet count, verts per tet, attribute count" << endl;
+    elem_file << tetCount() << " 4 " << attribute_count << endl << endl;
+
+    //-----------------------------------------------------------------------------------------------------------
+    //  Remaining lines list of # of tetrahedra:  <tetrahedron #> <node> <node> <node> <node> ... [attributes]
+    //-----------------------------------------------------------------------------------------------------------
+    writeLines(elem_file, tetCount(), pool, [&](ostream &out, size_t i)
+    {
+      out << i+1;
+      for(int v=0; v < 4; v++)
+        out << " " << tets[4*i+v] + 1;
+      if(include_materials)
+        out << " " << labels[i] + 1;
+      if(include_parents)
+        out << " " << parents[i] + 1;
+      out << "\n";
+    });
+
+    elem_file.close();
+  }
+
+
+  //===================================================
+  // writePtsEle()
+  //
+  // Public method that writes the mesh
+  // in the SciRun pts/ele file format.
+  //===================================================
+  void CompactTetMesh::writePtsEle(const std::string &filename, bool verbose, ThreadPool *pool) const
+  {
+    //-----------------------------------
+    //         Create Pts File
+    //-----------------------------------
+    string pts_filename = filename + ".pts";
+    if(verbose)
+      cout << "Writing mesh pts file: " << pts_filename << endl;
+    ofstream pts_file(pts_filename.c_str());
+
+    //-------------------------------------------------------------------------------------------
+    //  Write each line of file <x> <y> <z>
+    //-------------------------------------------------------------------------------------------
+    writeLines(pts_file, vertCount(), pool, [&](ostream &out, size_t i)
+    {
+      out << positions[3*i+0] << " " << positions[3*i+1] << " " << positions[3*i+2] << "\n";
+    });
+    pts_file.close();
+
+
+    //-----------------------------------
+    //        Create Element File
+    //-----------------------------------
+    string elem_filename = filename + ".elem";
+    if(verbose)
+      cout << "Writing mesh elem file: " << elem_filename << endl;
+    ofstream elem_file(elem_filename.c_str());
+
+
+    //-----------------------------------------------------------------------------------------------------------
+    //  Write each line <node> <node> <node> <node>
+    //-----------------------------------------------------------------------------------------------------------
+    writeLines(elem_file, tetCount(), pool, [&](ostream &out, size_t i)
+    {
+      out << tets[4*i+0] + 1 << " ";
+      out << tets[4*i+1] + 1 << " ";
+      out << tets[4*i+2] + 1 << " ";
+      out << tets[4*i+3] + 1 << "\n";
+    });
+    elem_file.close();
+
+    //-----------------------------------
+    //        Create Material File
+    //-----------------------------------
+    string mat_filename = filename + ".txt";
+    cout << "Writing mesh material file: " << mat_filename << endl;
+    ofstream mat_file(mat_filename.c_str());
+    for(size_t i=0; i < tetCount(); i++)
+    {
+      mat_file << labels[i] + 1 << endl;
+    }
+    mat_file.close();
+  }
+
+  //============================================================
+  // writeMesh()
+  //
+  // Public method to write mesh to file using desired
+  // mesh format. The appropriate file writer is called.
+  //============================================================
+  void CompactTetMesh::writeMesh(const std::string &filename, MeshFormat format, bool verbose, ThreadPool *pool) const
+  {
+
+    switch(format) {
+    case cleaver::Tetgen:
+      writeNodeEle(filename, verbose, true, false, pool);
+      break;
+    case cleaver::Scirun:
+      writePtsEle(filename, verbose, pool);
+      break;
+    case cleaver::Matlab:
+      writeMatlab(filename, verbose);
+      break;
+    case  cleaver::VtkUSG:
+      writeVtkUnstructuredGrid(filename, verbose);
+      break;
+    case  cleaver::VtkPoly:
+      writeVtkPolyData(filename, verbose);
+      break;
+    case  cleaver::PLY:
+      writePly(filename, verbose);
+      break;
+    default: {
+               std::cerr << "Unsupported Mesh Format. " << std::endl;
+               break;
+             }
+    }
+  }
+
+  void CompactTetMesh::writeVtkPolyData(const std::string &filename, bool verbose) const
+  {
+    std::string path = filename.substr(0,filename.find_last_of("/")+1);
+    std::string name = filename.substr(filename.find_last_of("/")+1,filename.size() - 1);
+    if (path.empty()) {
+      char cCurrentPath[FILENAME_MAX];
+      if(GetCurrentDir(cCurrentPath, sizeof(cCurrentPath))){}
+      cCurrentPath[sizeof(cCurrentPath) - 1] = '\0';
+      path = std::string(cCurrentPath) + "/";
+    }
+    // get the number of files/mats
+    std::vector<std::ofstream*> output;
+    std::vector<size_t> numTetsPerMat;
+    for(size_t i = 0; i < tetCount(); i++) {
+      size_t label = labels.at(i);
+      if (label + 1 > numTetsPerMat.size())
+        numTetsPerMat.resize(label+1);
+      numTetsPerMat.at(label)++;
+    }
+    size_t num = 0;
+    std::vector<std::string> filenames;
+    while (numTetsPerMat.size() != filenames.size()) {
+      std::stringstream ss;
+      ss << path << name << num++ << ".vtk" ;
+      filenames.push_back(ss.str());
+      std::cout << "\t" << ss.str() << std:: endl;
+    }
+    if(verbose) {
+      std::cout << "Writing VTK mesh files(tets): \n";
+      for(size_t i = 0; i < filenames.size(); i++)
+        std::cout << "\t" << filenames.at(i) << std::endl;
+    }
+    //-----------------------------------
+    //         Create Pruned Vertex List
+    //-----------------------------------
+    std::vector<VertMap> vert_maps;
+    vert_maps.resize(numTetsPerMat.size());
+    std::vector<std::vector<vec3> > pruned_verts;
+    pruned_verts.resize(numTetsPerMat.size());
+    std::vector<size_t> pruned_pos;
+    pruned_pos.resize(numTetsPerMat.size());
+    for(size_t i = 0; i < numTetsPerMat.size();i++)
+      pruned_pos[i] = 0;
+    for(size_t t=0; t < tetCount(); t++) {
+      const int32_t *tet = &tets[4*t];
+      size_t label = labels[t];
+
+      vec3 p1 = position(tet[0]);
+      vec3 p2 = position(tet[1]);
+      vec3 p3 = position(tet[2]);
+      vec3 p4 = position(tet[3]);
+
+      if (!vert_maps[label].count(p1)) {
+        vert_maps[label].insert(std::pair<vec3,size_t>(p1,pruned_pos[label]));
+        pruned_pos[label]++;
+        pruned_verts[label].push_back(p1);
+      }
+      if (!vert_maps[label].count(p2)) {
+        vert_maps[label].insert(std::pair<vec3,size_t>(p2,pruned_pos[label]));
+        pruned_pos[label]++;
+        pruned_verts[label].push_back(p2);
+      }
+      if (!vert_maps[label].count(p3)) {
+        vert_maps[label].insert(std::pair<vec3,size_t>(p3,pruned_pos[label]));
+        pruned_pos[label]++;
+        pruned_verts[label].push_back(p3);
+      }
+      if (!vert_maps[label].count(p4)) {
+        vert_maps[label].insert(std::pair<vec3,size_t>(p4,pruned_pos[label]));
+        pruned_pos[label]++;
+        pruned_verts[label].push_back(p4);
+      }
+    }
+    //-----------------------------------
+    //         Write Headers
+    //-----------------------------------
+    for(size_t i=0; i < numTetsPerMat.size(); i++) {
+      output.push_back(new std::ofstream(filenames.at(i).c_str()));
+      *output.at(i) << "# vtk DataFile Version 2.0\n";
+      *output.at(i) << filenames.at(i) << " Tet Mesh\n";
+      *output.at(i) << "ASCII\n";
+      *output.at(i) << "DATASET POLYDATA\n";
+      *output.at(i) << "POINTS " << pruned_verts[i].size() << " float\n";
+    }
+    //-----------------------------------
+    //         Write Vertex List
+    //-----------------------------------
+    for(size_t f=0; f < numTetsPerMat.size(); f++) {
+      for(size_t i=0; i < pruned_verts[f].size(); i++)
+      {
+        *output.at(f) << pruned_verts[f][i].x << " "
+          << pruned_verts[f][i].y << " "
+          << pruned_verts[f][i].z << std::endl;
+      }
+      size_t num_tets = numTetsPerMat.at(f);
+      *output.at(f) << "POLYGONS " << num_tets*4 << " "
+        << (num_tets*16) <<"\n";
+    }
+    //-----------------------------------
+    //         Write Cell/Face List
+    //-----------------------------------
+    for(size_t f=0; f < tetCount(); f++)
+    {
+      const int32_t *t = &tets[4*f];
+      const size_t label = labels[f];
+
+      size_t i1 = vert_maps[label].find(position(t[0]))->second;
+      size_t i2 = vert_maps[label].find(position(t[1]))->second;
+      size_t i3 = vert_maps[label].find(position(t[2]))->second;
+      size_t i4 = vert_maps[label].find(position(t[3]))->second;
+
+      *output.at(label) << 3 << " " << i1 <<  " " << i2 << " " << i3 << "\n";
+      *output.at(label) << 3 << " " << i2 <<  " " << i3 << " " << i4 << "\n";
+      *output.at(label) << 3 << " " << i3 <<  " " << i4 << " " << i1 << "\n";
+      *output.at(label) << 3 << " " << i4 <<  " " << i1 << " " << i2 << "\n";
+    }
+    //CLOSE
+    for(size_t i=0; i < numTetsPerMat.size(); i++) {
+      (*output.at(i)).close();
+      delete output.at(i);
+    }
+  }
+
+  void CompactTetMesh::writeVtkUnstructuredGrid(const std::string &filename, bool verbose) const
+  {
+    std::string filepath = filename + ".vtk";
+    std::ofstream output(filepath.c_str(), std::ios::out | std::ios::binary);
+    if(verbose)
+      std::cout << "Writing mesh vtk file: " << filepath << std::endl;
+    //-----------------------------------
+    //         Create Pruned Vertex List
+    //-----------------------------------
+    VertMap vert_map;
+    std::vector<vec3> pruned_verts;
+    size_t pruned_pos = 0;
+    for(size_t t=0; t < tetCount(); t++) {
+      const int32_t *tet = &tets[4*t];
+
+      vec3 p1 = position(tet[0]);
+      vec3 p2 = position(tet[1]);
+      vec3 p3 = position(tet[2]);
+      vec3 p4 = position(tet[3]);
+
+      if (!vert_map.count(p1)) {
+        vert_map.insert(std::pair<vec3,size_t>(p1,pruned_pos));
+        pruned_pos++;
+        pruned_verts.push_back(p1);
+      }
+      if (!vert_map.count(p2)) {
+        vert_map.insert(std::pair<vec3,size_t>(p2,pruned_pos));
+        pruned_pos++;
+        pruned_verts.push_back(p2);
+      }
+      if (!vert_map.count(p3)) {
+        vert_map.insert(std::pair<vec3,size_t>(p3,pruned_pos));
+        pruned_pos++;
+        pruned_verts.push_back(p3);
+      }
+      if (!vert_map.count(p4)) {
+        vert_map.insert(std::pair<vec3,size_t>(p4,pruned_pos));
+        pruned_pos++;
+        pruned_verts.push_back(p4);
+      }
+    }
+
+    //-----------------------------------
+    //         Write Header
+    //-----------------------------------
+    output << "# vtk DataFile Version 2.0\n";
+    output << filepath << " Tet Mesh\n";
+    output << "ASCII\n";
+    output << "DATASET UNSTRUCTURED_GRID\n";
+    output << "POINTS " << pruned_verts.size() << " float\n";
+    //-----------------------------------
+    //         Write Vertex List
+    //-----------------------------------
+    for(size_t i=0; i < pruned_verts.size(); i++)
+    {
+      output << pruned_verts[i].x << " "
+        << pruned_verts[i].y << " "
+        << pruned_verts[i].z << std::endl;
+    }
+
+    //-----------------------------------
+    //         Write Cell/Face List
+    //-----------------------------------
+    // \todo make writing background optional
+    output << "CELLS " << tetCount() << " " << tetCount()*5 << "\n";
+    for(size_t f=0; f < tetCount(); f++)
+    {
+      const int32_t *t = &tets[4*f];
+
+      size_t i1 = vert_map.find(position(t[0]))->second;
+      size_t i2 = vert_map.find(position(t[1]))->second;
+      size_t i3 = vert_map.find(position(t[2]))->second;
+      size_t i4 = vert_map.find(position(t[3]))->second;
+      output << 4 << " " << i1 <<  " " << i2 << " " << i3 << " " << i4 << "\n";
+    }
+
+    output << "CELL_TYPES " << tetCount() << "\n";
+    for(size_t f=0; f < tetCount(); f++)
+    {
+      output << 10 << "\n";
+    }
+
+    //-----------------------------------
+    //         Write Labels
+    //-----------------------------------
+    output << "CELL_DATA " << tetCount() << "\n";
+    output << "SCALARS labels int 1\n";
+    output << "LOOKUP_TABLE default\n";
+    for(size_t f=0; f < tetCount(); f++)
+    {
+      output << (int)labels[f] << "\n";
+    }
+
+    //CLOSE
+    output.close();
+  }
+
+  //==================================================================
+  // writeMatlab()
+  //
+  // Public method that writes the mesh
+  // in the SCIRun-Matlab file format.
+  //==================================================================
+  void CompactTetMesh::writeMatlab(const std::string &filename, bool verbose) const
+  {
+#ifdef _WIN32
+#define float_t float
+#endif
+    //-------------------------------
+    //         Create File
+    //-------------------------------
+    std::ofstream file((filename + ".mat").c_str(), std::ios::out | std::ios::binary);
+    if(verbose)
+      std::cout << "Writing mesh matlab file: " << (filename + ".mat").c_str() << std::endl;
+
+    if(!file.is_open())
+    {
+      std::cerr << "Failed to create file." << std::endl;
+      return;
+    }
+    Status status(vertCount() + 2*tetCount());
+
+    //--------------------------------------------------------------
+    //        Write Header (128 bytes)
+    //
+    //      Bytes   1 - 116  : Descriptive Text (116 bytes)
+    //      Bytes 117 - 124  : Subsystem Offset (8 bytes)
+    //      Bytes 125 - 126  : Matlab Version   ( 2 bytes)
+    //      Bytes 127 - 128  : Endian Indicator ( 2 bytes)
+    //--------------------------------------------------------------
+
+    // write description
+    std::string description = "MATLAB 5.0 MAT-file, SCIRun-TetMesh Created using Cleaver. SCI/Utah | http://www.sci.utah.edu";
+    description.resize(116, ' ');
+    file.write((char*)description.c_str(), description.length());
+
+    // write offset
+    char zeros[32] = {0};
+    file.write(zeros, 8);
+
+    // write version
+    int16_t version = 0x0100;
+    file.write((char*)&version, sizeof(int16_t));
+
+    // write endian
+    char endian[2] = {'I','M'};
+    file.write(endian, sizeof(int16_t));
+
+    //----------------------------------------------------------
+    //  Write Containing Structure
+    //  8 byte Tag for Matrix Element
+    //  6 Structure SubElements as Data
+    //          1 - Array Flags         (8 bytes)
+    //          2 - Dimensions Array    numberOfDimensions * sizeOfDataType
+    //          3 - Array Name          numberOfCharacters * sizeOfDataType
+    //          4 - Field Name Length   (4 bytes)
+    //          5 - Field Names         numberOfFields * FieldNameLength;
+    //          6 - Node Field
+    //          7 - Cell Field
+    //          8 - Field Field
+    //----------------------------------------------------------
+    int32_t mainType  = miMATRIX;
+    int32_t totalSize = 0;
+
+    // save location, when total size known, come back and fill it in
+    long totalSizeAddress = (long)file.tellp();
+    totalSizeAddress += sizeof(int32_t);
+
+
+    file.write((char*)&mainType, sizeof(int32_t));
+    file.write((char*)&totalSize, sizeof(int32_t));
+
+    //---------------------------------------------
+    //       Write Array Flags SubElement
+    //
+    //   bytes 1 - 2  : undefined (2 bytes)
+    //   byte  3      : flags  (1 byte)
+    //   byte  4      : class  (1 byte)
+    //   bytes 5 - 8  : undefined (4 bytes)
+    //---------------------------------------------
+
+    int32_t flagsType = miUINT32;
+    int32_t flagsSize = 8;
+
+    file.write((char*)&flagsType, sizeof(int32_t));
+    file.write((char*)&flagsSize, sizeof(int32_t));
+
+    int8_t flagsByte = 0;
+    int8_t classByte = mxSTRUCT_CLASS;
+
+    file.write((char*)&classByte, sizeof(int8_t));
+    file.write((char*)&flagsByte, sizeof(int8_t));
+    file.write(zeros, 2);
+    file.write(zeros, 4);
+
+    //---------------------------------------------
+    //     Write Dimensions Array SubElement
+    //
+    //---------------------------------------------
+    int32_t dimensionsType = miINT32;
+    int32_t dimensionsSize = 8;
+    int32_t dimension = 1;
+
+    file.write((char*)&dimensionsType, sizeof(int32_t));
+    file.write((char*)&dimensionsSize, sizeof(int32_t));
+    file.write((char*)&dimension, sizeof(int32_t));
+    file.write((char*)&dimension, sizeof(int32_t));
+
+    //---------------------------------------------
+    //     Write Array Name SubElement
+    //---------------------------------------------
+    int8_t  arrayName[8] = {'t','e','t','m','e','s','h','\0'};
+    int32_t arrayNameType = miINT8;
+    int32_t arrayNameSize = 7;
+
+    file.write((char*)&arrayNameType, sizeof(int32_t));
+    file.write((char*)&arrayNameSize, sizeof(int32_t));
+    file.write((char*)arrayName,    8*sizeof(int8_t));
+
+
+    //---------------------------------------------
+    //  Write Field Name Length SubElement
+    //---------------------------------------------
+    int16_t fieldNameLengthSize = sizeof(int32_t);
+    int16_t fieldNameLengthType = miINT32;
+    int32_t fieldNameLengthData = 8;
+
+    file.write((char*)&fieldNameLengthType, sizeof(int16_t));
+    file.write((char*)&fieldNameLengthSize, sizeof(int16_t));
+    file.write((char*)&fieldNameLengthData, sizeof(int32_t));
+
+    //---------------------------------------------
+    //  Write Field Names
+    //---------------------------------------------
+    int32_t fieldNamesType = miINT8;
+    int32_t fieldNamesSize = 8*3;
+
+    file.write((char*)&fieldNamesType, sizeof(int32_t));
+    file.write((char*)&fieldNamesSize, sizeof(int32_t));
+
+    strcpy(zeros, "node");
+    file.write(zeros, 8*sizeof(char));
+    memset(zeros, 0, 32);
+
+    strcpy(zeros, "cell");
+    file.write(zeros, 8*sizeof(char));
+    memset(zeros, 0, 32);
+
+    strcpy(zeros, "field");
+    file.write(zeros, 8*sizeof(char));
+    memset(zeros, 0, 32);
+
+    //---------------------------------------------
+    //  Write Field Cells
+    //---------------------------------------------
+
+    //-------------------------------
+    //         Write .node
+    //-------------------------------
+    int32_t nodeType = miMATRIX;
+    int32_t nodeSize = 0;
+
+    long nodeSizeAddress = (long)file.tellp();
+    nodeSizeAddress += sizeof(int32_t);
+
+    file.write((char*)&nodeType, sizeof(int32_t));
+    file.write((char*)&nodeSize, sizeof(int32_t));
+
+    //--------------------------------
+    //  Write Node Array flags
+    //
+    //   bytes 1 - 2  : undefined (2 bytes)
+    //   byte  3      : flags  (1 byte)
+    //   byte  4      : class  (1 byte)
+    //   bytes 5 - 8  : undefined (4 bytes)
+    //--------------------------------
+    int32_t nodeFlagsType = miUINT32;
+    int32_t nodeFlagsSize = 8;
+
+    file.write((char*)&nodeFlagsType, sizeof(int32_t));
+    file.write((char*)&nodeFlagsSize, sizeof(int32_t));
+
+    int8_t nodeFlagsByte = 0;
+    int8_t nodeClassByte = mxSINGLE_CLASS;
+
+    file.write((char*)&nodeClassByte, sizeof(int8_t));
+    file.write((char*)&nodeFlagsByte, sizeof(int8_t));
+    file.write(zeros, 2);
+    file.write(zeros, 4);
+
+    //---------------------------------------------
+    //   Write Node Dimensions Array
+    //---------------------------------------------
+    int32_t nodeDimensionType = miINT32;
+    int32_t nodeDimensionSize = 8;
+    int32_t nodeDimensionRows = 3;
+    int32_t nodeDimensionCols = static_cast<int32_t>(vertCount());
+
+    file.write((char*)&nodeDimensionType, sizeof(int32_t));
+    file.write((char*)&nodeDimensionSize, sizeof(int32_t));
+    file.write((char*)&nodeDimensionRows, sizeof(int32_t));
+    file.write((char*)&nodeDimensionCols, sizeof(int32_t));
+
+    //---------------------------------------------
+    //     Write Node Array Name SubElement
+    //---------------------------------------------
+    int32_t nodeArrayNameType = miINT8;
+    int32_t nodeArrayNameSize = 0;
+
+    file.write((char*)&nodeArrayNameType, sizeof(int32_t));
+    file.write((char*)&nodeArrayNameSize, sizeof(int32_t));
+
+    //----------------------------------------------
+    //     Write Node Pr Array Data SubElement
+    //----------------------------------------------
+    int32_t nodeDataType = miSINGLE;
+    int32_t nodeDataSize = nodeDimensionRows*nodeDimensionCols*sizeof(float_t);
+    int32_t nodePadding = (8 - (nodeDataSize % 8)) % 8;
+
+    file.write((char*)&nodeDataType, sizeof(int32_t));
+    file.write((char*)&nodeDataSize, sizeof(int32_t));
+
+    for(size_t i=0; i < vertCount(); i++)
+    {
+      if (verbose) status.printStatus();
+      float_t x = (float_t)positions[3*i+0];
+      float_t y = (float_t)positions[3*i+1];
+      float_t z = (float_t)positions[3*i+2];
+
+      file.write((char*)&x, sizeof(float_t));
+      file.write((char*)&y, sizeof(float_t));
+      file.write((char*)&z, sizeof(float_t));
+    }
+    if(nodePadding)
+      file.write((char*)zeros, nodePadding);
+    long nodeEndAddress = (long)file.tellp();
+
+    //-------------------------------
+    //         Write .cell
+    //-------------------------------
+    int32_t cellType = miMATRIX;
+    int32_t cellSize = 0;
+
+    long cellSizeAddress = (long)file.tellp();
+    cellSizeAddress += sizeof(int32_t);
+
+    file.write((char*)&cellType, sizeof(int32_t));
+    file.write((char*)&cellSize, sizeof(int32_t));
+
+    //--------------------------------
+    //  Write Cell Array flags
+    //
+    //   bytes 1 - 2  : undefined (2 bytes)
+    //   byte  3      : flags  (1 byte)
+    //   byte  4      : class  (1 byte)
+    //   bytes 5 - 8  : undefined (4 bytes)
+    //--------------------------------
+    int32_t cellFlagsType = miUINT32;
+    int32_t cellFlagsSize = 8;
+
+    file.write((char*)&cellFlagsType, sizeof(int32_t));
+    file.write((char*)&cellFlagsSize, sizeof(int32_t));
+
+    int8_t cellFlagsByte = 0;
+    int8_t cellClassByte = mxINT32_CLASS;
+
+    file.write((char*)&cellClassByte, sizeof(int8_t));
+    file.write((char*)&cellFlagsByte, sizeof(int8_t));
+    file.write(zeros, 2);
+    file.write(zeros, 4);
+
+    //---------------------------------------------
+    //   Write Cell Dimensions Array
+    //---------------------------------------------
+    int32_t cellDimensionType = miINT32;
+    int32_t cellDimensionSize = 8;
+    int32_t cellDimensionRows = 4;
+    int32_t cellDimensionCols = static_cast<int32_t>(tetCount());
+
+    file.write((char*)&cellDimensionType, sizeof(int32_t));
+    file.write((char*)&cellDimensionSize, sizeof(int32_t));
+    file.write((char*)&cellDimensionRows, sizeof(int32_t));
+    file.write((char*)&cellDimensionCols, sizeof(int32_t));
+
+    //---------------------------------------------
+    //     Write Cell Array Name SubElement
+    //---------------------------------------------
+    int32_t cellArrayNameType = miINT8;
+    int32_t cellArrayNameSize = 0;
+
+    file.write((char*)&cellArrayNameType, sizeof(int32_t));
+    file.write((char*)&cellArrayNameSize, sizeof(int32_t));
+
+    //----------------------------------------------
+    //     Write Cell Pr Array Data SubElement
+    //----------------------------------------------
+    int32_t cellDataType = miINT32;
+    int32_t cellDataSize = cellDimensionRows*cellDimensionCols*sizeof(int32_t);
+    int32_t cellPadding  = (8 - (cellDataSize % 8)) % 8;
+
+    file.write((char*)&cellDataType, sizeof(int32_t));
+    file.write((char*)&cellDataSize, sizeof(int32_t));
+
+    for(size_t i=0; i < tetCount(); i++)
+    {
+      if (verbose) status.printStatus();
+      for(int v=0; v < 4; v++){
+        int32_t index = tets[4*i+v] + 1;
+        file.write((char*)&index, sizeof(int32_t));
+      }
+    }
+    if(cellPadding)
+      file.write((char*)zeros, cellPadding);
+    long cellEndAddress = (long)file.tellp();
+
+    //----------------------------------
+    //         Write .field
+    //----------------------------------
+    int32_t fieldType = miMATRIX;
+    int32_t fieldSize = 0;
+
+    long fieldSizeAddress = (long)file.tellp();
+    fieldSizeAddress += sizeof(int32_t);
+
+    file.write((char*)&fieldType, sizeof(int32_t));
+    file.write((char*)&fieldSize, sizeof(int32_t));
+
+    //--------------------------------
+    //  Write Field Array flags
+    //
+    //   bytes 1 - 2  : undefined (2 bytes)
+    //   byte  3      : flags  (1 byte)
+    //   byte  4      : class  (1 byte)
+    //   bytes 5 - 8  : undefined (4 bytes)
+    //--------------------------------
+    int32_t fieldFlagsType = miUINT32;
+    int32_t fieldFlagsSize = 8;
+
+    file.write((char*)&fieldFlagsType, sizeof(int32_t));
+    file.write((char*)&fieldFlagsSize, sizeof(int32_t));
+
+    int8_t fieldFlagsByte = 0;
+    int8_t fieldClassByte = mxUINT8_CLASS;
+
+    file.write((char*)&fieldClassByte, sizeof(int8_t));
+    file.write((char*)&fieldFlagsByte, sizeof(int8_t));
+    file.write(zeros, 2);
+    file.write(zeros, 4);
+
+    //---------------------------------------------
+    //   Write Field Dimensions Array
+    //---------------------------------------------
+    int32_t fieldDimensionType = miINT32;
+    int32_t fieldDimensionSize = 8;
+    int32_t fieldDimensionRows = 1;
+    int32_t fieldDimensionCols = static_cast<int32_t>(tetCount());
+
+    file.write((char*)&fieldDimensionType, sizeof(int32_t));
+    file.write((char*)&fieldDimensionSize, sizeof(int32_t));
+    file.write((char*)&fieldDimensionRows, sizeof(int32_t));
+    file.write((char*)&fieldDimensionCols, sizeof(int32_t));
+
+    //---------------------------------------------
+    //     Write Field Array Name SubElement
+    //---------------------------------------------
+    int32_t fieldArrayNameType = miINT8;
+    int32_t fieldArrayNameSize = 0;
+
+    file.write((char*)&fieldArrayNameType, sizeof(int32_t));
+    file.write((char*)&fieldArrayNameSize, sizeof(int32_t));
+
+    //----------------------------------------------
+    //     Write Field Pr Array Data SubElement
+    //----------------------------------------------
+    int32_t fieldDataType = miUINT8;
+    int32_t fieldDataSize = fieldDimensionRows*fieldDimensionCols*sizeof(int8_t);
+    int32_t fieldPadding  = (8 - (fieldDataSize % 8)) % 8;
+
+    file.write((char*)&fieldDataType, sizeof(int32_t));
+    file.write((char*)&fieldDataSize, sizeof(int32_t));
+
+    for(size_t i=0; i < tetCount(); i++)
+    {
+      if (verbose) status.printStatus();
+      unsigned char m = labels[i];
+      file.write((char*)&m, sizeof(int8_t));
+    }
+    if(fieldPadding)
+      file.write(zeros, fieldPadding);
+    long fieldEndAddress = (long)file.tellp();
+    long fileEndAddress = (long)file.tellp();
+
+    //-------------------------------
+    //  Finally, Compute Sizes and
+    //         Write Them
+    //-------------------------------
+    totalSize = fileEndAddress -  (totalSizeAddress + sizeof(int32_t));
+    nodeSize  = nodeEndAddress -  (nodeSizeAddress  + sizeof(int32_t));
+    cellSize  = cellEndAddress -  (cellSizeAddress  + sizeof(int32_t));
+    fieldSize = fieldEndAddress - (fieldSizeAddress + sizeof(int32_t));
+
+    file.seekp(totalSizeAddress);
+    file.write((char*)&totalSize, sizeof(int32_t));
+
+    file.seekp(nodeSizeAddress);
+    file.write((char*)&nodeSize,  sizeof(int32_t));
+
+    file.seekp(cellSizeAddress);
+    file.write((char*)&cellSize,  sizeof(int32_t));
+
+    file.seekp(fieldSizeAddress);
+    file.write((char*)&fieldSize, sizeof(int32_t));
+
+    //-------------------------------
+    //   Done
+    //-------------------------------
+    file.flush();
+    file.close();
+    if (verbose) status.done();
+  }
+
+}
@@ -0,0 +1,118 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- Compact TetMesh Class
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+//-------------------------------------------------------------------
+
+#ifndef COMPACT_TETMESH_H
+#define COMPACT_TETMESH_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "TetMesh.h"
+#include "vec3.h"
+
+namespace cleaver
+{
+
+class ThreadPool;
+
+/**
+ * Index based, structure-of-arrays representation of a tetrahedral
+ * mesh. Positions, tet connectivity and material labels live in flat
+ * arrays and vertex to tet adjacency is stored in CSR form, so the
+ * output stages (stripping, quality, file writing) run as linear
+ * passes without chasing Vertex/Tet pointers. The half-edge and
+ * half-face structures needed during cleaving are not carried over.
+ */
+class CompactTetMesh
+{
+public:
+    CompactTetMesh();
+    explicit CompactTetMesh(const TetMesh &mesh);
+
+    size_t vertCount() const { return positions.size() / 3; }
+    size_t tetCount()  const { return labels.size(); }
+    size_t faceCount() const { return faceTets.size() / 2; }
+
+    vec3 position(size_t v) const {
+        return vec3(positions[3*v+0], positions[3*v+1], positions[3*v+2]);
+    }
+
+    void constructAdjacency();
+    void clearAdjacency();
+    bool hasAdjacency() const { return !vertTetOffsets.empty(); }
+
+    // tets incident to vertex v are vertTets[begin,end)
+    int32_t tetsAroundVertexBegin(size_t v) const { return vertTetOffsets[v]; }
+    int32_t tetsAroundVertexEnd(size_t v)   const { return vertTetOffsets[v+1]; }
+
+    size_t fixVertexWindup(bool verbose = false);
+    void stripMaterial(char material, bool verbose = false);
+    void computeAngles();
+
+    // largest index difference between two vertices sharing a tet
+    size_t bandwidth() const;
+    // renumber vertices by Reverse Cuthill-McKee, tets by lowest vertex
+    void reorderRCM(bool verbose = false);
+
+    // text writers take an optional pool to format lines in parallel
+    void writeMesh(const std::string &filename, MeshFormat format, bool verbose = false, ThreadPool *pool = nullptr) const;
+    void writeVtkPolyData(const std::string &filename, bool verbose = false) const;
+    void writeVtkUnstructuredGrid(const std::string &filename, bool verbose = false) const;
+    void writeMatlab(const std::string &filename, bool verbose = false) const;
+    void writeNodeEle(const std::string &filename, bool verbose = false, bool includeMaterials = true, bool includeParent = false,
+                      ThreadPool *pool = nullptr) const;
+    void writePtsEle(const std::string &filename, bool verbose = false, ThreadPool *pool = nullptr) const;
+    void writePly(const std::string &filename, bool verbose = false) const;
+    void writeInfo(const std::string &filename, bool verbose = false) const;
+
+    std::vector<double>  positions;        // x,y,z per vertex
+    std::vector<int32_t> tets;             // 4 vertex indices per tet
+    std::vector<char>    labels;           // material per tet
+    std::vector<int32_t> parents;          // background tet per tet
+    std::vector<int32_t> faces;            // 3 vertex indices per face
+    std::vector<int32_t> faceTets;         // 2 tet indices per face, -1 on boundary
+    std::vector<int32_t> vertTetOffsets;   // CSR offsets, vertCount()+1
+    std::vector<int32_t> vertTets;         // CSR tet indices
+
+    double min_angle;      // smallest dihedral angle
+    double max_angle;      // largest dihedral angle
+    double time;           // time taken to mesh
+};
+
+}
+
+#endif // COMPACT_TETMESH_H
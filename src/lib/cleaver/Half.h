@@ -0,0 +1,147 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- Half Precision Float
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+//-------------------------------------------------------------------
+
+#ifndef HALF_H
+#define HALF_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace cleaver
+{
+
+/**
+ * IEEE 754 binary16 storage type. It only stores values, anything
+ * computed with it goes through float. Conversion from float rounds
+ * to nearest even, values beyond +-65504 become infinity.
+ */
+class half
+{
+public:
+    half() : m_bits(0) {}
+    half(float value) : m_bits(fromFloat(value)) {}
+
+    operator float() const { return toFloat(m_bits); }
+
+    unsigned short bits() const { return m_bits; }
+    static half fromBits(unsigned short bits);
+
+    static unsigned short fromFloat(float value);
+    static float toFloat(unsigned short bits);
+
+private:
+    unsigned short m_bits;
+};
+
+inline half half::fromBits(unsigned short bits)
+{
+    half h;
+    h.m_bits = bits;
+    return h;
+}
+
+inline unsigned short half::fromFloat(float value)
+{
+    uint32_t f;
+    std::memcpy(&f, &value, sizeof(f));
+
+    uint32_t sign = (f >> 16) & 0x8000;
+    uint32_t absf = f & 0x7fffffff;
+
+    // infinity and NaN, NaN keeps a quiet payload
+    if(absf >= 0x7f800000)
+        return (unsigned short)(sign | 0x7c00 | (absf > 0x7f800000 ? 0x200 : 0));
+
+    // 65520 and above round past the largest half
+    if(absf >= 0x477ff000)
+        return (unsigned short)(sign | 0x7c00);
+
+    // below the smallest normal half, round into a subnormal
+    if(absf < 0x38800000)
+    {
+        if(absf < 0x33000000)
+            return (unsigned short)sign;
+
+        uint32_t mant = (absf & 0x7fffff) | 0x800000;
+        int shift = 126 - (int)(absf >> 23);
+        uint32_t result = mant >> shift;
+        uint32_t rem = mant & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if(rem > halfway || (rem == halfway && (result & 1)))
+            result++;
+        return (unsigned short)(sign | result);
+    }
+
+    // rebias the exponent, a mantissa carry rolls into it correctly
+    uint32_t bits = absf - 0x38000000;
+    bits += 0xfff + ((bits >> 13) & 1);
+    return (unsigned short)(sign | (bits >> 13));
+}
+
+inline float half::toFloat(unsigned short bits)
+{
+    uint32_t sign = (uint32_t)(bits & 0x8000) << 16;
+    uint32_t exp  = (bits >> 10) & 0x1f;
+    uint32_t mant = bits & 0x3ff;
+
+    uint32_t f;
+    if(exp == 0x1f)
+        f = sign | 0x7f800000 | (mant << 13);
+    else if(exp != 0)
+        f = sign | ((exp + 112) << 23) | (mant << 13);
+    else if(mant == 0)
+        f = sign;
+    else
+    {
+        // subnormal, normalize the mantissa
+        uint32_t e = 113;
+        while(!(mant & 0x400))
+        {
+            mant <<= 1;
+            e--;
+        }
+        f = sign | (e << 23) | ((mant & 0x3ff) << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &f, sizeof(value));
+    return value;
+}
+
+}
+
+#endif // HALF_H
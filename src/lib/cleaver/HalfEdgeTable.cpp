@@ -0,0 +1,187 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- HalfEdge Hash Table
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+//-------------------------------------------------------------------
+
+#include "HalfEdgeTable.h"
+#include <algorithm>
+
+namespace cleaver
+{
+
+static const uint64_t kEmptyKey = ~0ULL;
+static const size_t kPageSize = 4096;
+static const size_t kMinCapacity = 64;
+
+HalfEdgeTable::HalfEdgeTable() : m_pageUsed(kPageSize)
+{
+}
+
+HalfEdgeTable::~HalfEdgeTable()
+{
+    clear();
+}
+
+//-------------------------------------------------------------------
+// Pack the ordered index pair into a single 64 bit key.
+//-------------------------------------------------------------------
+uint64_t HalfEdgeTable::makeKey(int v1, int v2)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(v1)) << 32) |
+            static_cast<uint64_t>(static_cast<uint32_t>(v2));
+}
+
+//-------------------------------------------------------------------
+// 64 bit finalizer (MurmurHash3 fmix64) so that neighboring vertex
+// indices spread across the table.
+//-------------------------------------------------------------------
+uint64_t HalfEdgeTable::hash(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+HalfEdge* HalfEdgeTable::find(int v1, int v2) const
+{
+    if (m_slots.empty())
+        return nullptr;
+
+    const uint64_t key = makeKey(v1, v2);
+    const size_t mask = m_slots.size() - 1;
+    size_t i = static_cast<size_t>(hash(key)) & mask;
+    while (m_slots[i].key != kEmptyKey) {
+        if (m_slots[i].key == key)
+            return m_slots[i].edge;
+        i = (i + 1) & mask;
+    }
+    return nullptr;
+}
+
+HalfEdge* HalfEdgeTable::findOrCreate(int v1, int v2, bool long_edge)
+{
+    // keep load factor at or below one half
+    if (2*(m_edges.size() + 1) > m_slots.size())
+        rehash(m_slots.empty() ? kMinCapacity : 2*m_slots.size());
+
+    const uint64_t key = makeKey(v1, v2);
+    const size_t mask = m_slots.size() - 1;
+    size_t i = static_cast<size_t>(hash(key)) & mask;
+    while (m_slots[i].key != kEmptyKey) {
+        if (m_slots[i].key == key)
+            return m_slots[i].edge;
+        i = (i + 1) & mask;
+    }
+
+    HalfEdge *edge = allocate(long_edge);
+    m_slots[i].key = key;
+    m_slots[i].edge = edge;
+    m_edges.push_back(edge);
+    return edge;
+}
+
+//-------------------------------------------------------------------
+// Grab the next HalfEdge from the current page, starting a new page
+// when the current one is exhausted.
+//-------------------------------------------------------------------
+HalfEdge* HalfEdgeTable::allocate(bool long_edge)
+{
+    if (m_pageUsed == kPageSize) {
+        m_pages.push_back(new HalfEdge[kPageSize]);
+        m_pageUsed = 0;
+    }
+    HalfEdge *edge = &m_pages.back()[m_pageUsed++];
+    edge->m_long_edge = long_edge;
+    return edge;
+}
+
+void HalfEdgeTable::rehash(size_t capacity)
+{
+    std::vector<Slot> old_slots(capacity, Slot{kEmptyKey, nullptr});
+    old_slots.swap(m_slots);
+
+    const size_t mask = m_slots.size() - 1;
+    for (size_t s = 0; s < old_slots.size(); s++) {
+        if (old_slots[s].key == kEmptyKey)
+            continue;
+        size_t i = static_cast<size_t>(hash(old_slots[s].key)) & mask;
+        while (m_slots[i].key != kEmptyKey)
+            i = (i + 1) & mask;
+        m_slots[i] = old_slots[s];
+    }
+}
+
+void HalfEdgeTable::reserve(size_t count)
+{
+    size_t capacity = kMinCapacity;
+    while (capacity < 2*count)
+        capacity *= 2;
+    if (capacity > m_slots.size())
+        rehash(capacity);
+    m_edges.reserve(count);
+}
+
+//-------------------------------------------------------------------
+// Edge traversal order affects which cuts are snapped first, so the
+// mesher relies on a deterministic, index based ordering.
+//-------------------------------------------------------------------
+void HalfEdgeTable::sortByIndex()
+{
+    std::vector<Slot> used;
+    used.reserve(m_edges.size());
+    for (size_t s = 0; s < m_slots.size(); s++) {
+        if (m_slots[s].key != kEmptyKey)
+            used.push_back(m_slots[s]);
+    }
+    std::sort(used.begin(), used.end(),
+              [](const Slot &a, const Slot &b) { return a.key < b.key; });
+    for (size_t i = 0; i < used.size(); i++)
+        m_edges[i] = used[i].edge;
+}
+
+void HalfEdgeTable::clear()
+{
+    for (size_t p = 0; p < m_pages.size(); p++)
+        delete [] m_pages[p];
+    m_pages.clear();
+    m_pageUsed = kPageSize;
+    m_edges.clear();
+    m_slots.clear();
+}
+
+}
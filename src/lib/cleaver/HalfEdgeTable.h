@@ -0,0 +1,108 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- HalfEdge Hash Table
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+//-------------------------------------------------------------------
+
+#ifndef HALFEDGE_TABLE_H
+#define HALFEDGE_TABLE_H
+
+#include <vector>
+#include <cstdint>
+#include "HalfEdge.h"
+
+namespace cleaver
+{
+
+/**
+ * Open-addressing hash table mapping an ordered pair of vertex
+ * indices (tm_v_index) to the HalfEdge between them. Replaces the
+ * std::map previously used by TetMesh, avoiding a heap node and a
+ * O(log n) tree walk per lookup. HalfEdges are allocated in pages
+ * owned by the table, so their addresses remain stable until clear().
+ * Iteration visits edges in creation order, or in (v1,v2) index order
+ * after a call to sortByIndex().
+ */
+class HalfEdgeTable
+{
+public:
+    typedef std::vector<HalfEdge*>::const_iterator const_iterator;
+    typedef const_iterator iterator;
+
+    HalfEdgeTable();
+    ~HalfEdgeTable();
+
+    // lookup only, returns nullptr if no edge exists
+    HalfEdge* find(int v1, int v2) const;
+
+    // lookup, creating a new edge if none exists
+    HalfEdge* findOrCreate(int v1, int v2, bool long_edge);
+
+    void reserve(size_t count);
+    void clear();
+
+    // order iteration by (v1,v2), matching the traversal of an ordered map
+    void sortByIndex();
+
+    size_t size() const { return m_edges.size(); }
+    bool empty() const { return m_edges.empty(); }
+    HalfEdge* operator[](size_t i) const { return m_edges[i]; }
+
+    const_iterator begin() const { return m_edges.begin(); }
+    const_iterator end() const { return m_edges.end(); }
+
+private:
+    HalfEdgeTable(const HalfEdgeTable&);
+    HalfEdgeTable& operator=(const HalfEdgeTable&);
+
+    struct Slot {
+        uint64_t key;
+        HalfEdge *edge;
+    };
+
+    static uint64_t makeKey(int v1, int v2);
+    static uint64_t hash(uint64_t key);
+
+    HalfEdge* allocate(bool long_edge);
+    void rehash(size_t capacity);
+
+    std::vector<Slot> m_slots;          // power of two sized
+    std::vector<HalfEdge*> m_edges;     // iteration order
+    std::vector<HalfEdge*> m_pages;     // backing storage
+    size_t m_pageUsed;
+};
+
+}
+
+#endif // HALFEDGE_TABLE_H
@@ -54,9 +54,12 @@ class InterfaceCalculator
 {
   public:
     virtual ~InterfaceCalculator() {}
-    virtual void computeCutForEdge(HalfEdge *edge) = 0;
-    virtual void computeTripleForFace(HalfFace *face) = 0;
-    virtual void computeQuadrupleForTet(Tet *tet) = 0;
+    // thread is the index of the calling thread, new vertices are allocated
+    // from that thread's pool so edges, faces and tets may be processed
+    // concurrently as long as each is handled by a single thread
+    virtual void computeCutForEdge(HalfEdge *edge, unsigned int thread) = 0;
+    virtual void computeTripleForFace(HalfFace *face, unsigned int thread) = 0;
+    virtual void computeQuadrupleForTet(Tet *tet, unsigned int thread) = 0;
 };
 
 }
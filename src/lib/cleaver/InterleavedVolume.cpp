@@ -0,0 +1,169 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- Interleaved Volume Class
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "InterleavedVolume.h"
+#include <stdexcept>
+
+namespace cleaver
+{
+
+// material counts up to this are interpolated into a stack buffer
+static const int kStackMaterials = 64;
+
+InterleavedVolume::InterleavedVolume(const Volume &volume) :
+    Volume(volume), m_materials(volume.numberOfMaterials())
+{
+    if(!sharedGridValid())
+        throw std::runtime_error("InterleavedVolume requires float materials on a single grid.");
+
+    m_grid = *m_sharedGrid[0];
+    m_grid.setData(0);
+
+    // node centered data bounds are one sample short on each axis
+    BoundingBox dims = m_grid.dataBounds();
+    int pad = (m_grid.getCenterType() == NodeCentered) ? 1 : 0;
+    size_t voxels = (size_t)(dims.size.x + pad) *
+                    (size_t)(dims.size.y + pad) *
+                    (size_t)(dims.size.z + pad);
+
+    m_data.resize(voxels*m_materials);
+    for(int m=0; m < m_materials; m++)
+    {
+        const float *field = m_sharedGrid[m]->data();
+        for(size_t v=0; v < voxels; v++)
+            m_data[v*m_materials + m] = field[v];
+    }
+}
+
+void InterleavedVolume::stencilAt(const vec3 &x, TrilinearStencil &stencil) const
+{
+    BoundingBox grid = m_grid.bounds();
+    m_grid.stencilAt((x.x / bounds().size.x)*grid.size.x,
+                     (x.y / bounds().size.y)*grid.size.y,
+                     (x.z / bounds().size.z)*grid.size.z, stencil);
+}
+
+void InterleavedVolume::interpolate(const TrilinearStencil &stencil, double *out) const
+{
+    // corners are accumulated in the same order as ScalarField::valueAt,
+    // the inner loop runs over contiguous materials and vectorizes
+    const float *corner = &m_data[(size_t)stencil.index[0]*m_materials];
+    for(int m=0; m < m_materials; m++)
+        out[m] = stencil.weight[0]*(double)corner[m];
+
+    for(int c=1; c < 8; c++)
+    {
+        corner = &m_data[(size_t)stencil.index[c]*m_materials];
+        double weight = stencil.weight[c];
+        for(int m=0; m < m_materials; m++)
+            out[m] += weight*(double)corner[m];
+    }
+}
+
+double InterleavedVolume::interpolate(const TrilinearStencil &stencil, int material) const
+{
+    double value = stencil.weight[0]*(double)m_data[(size_t)stencil.index[0]*m_materials + material];
+    for(int c=1; c < 8; c++)
+        value += stencil.weight[c]*(double)m_data[(size_t)stencil.index[c]*m_materials + material];
+    return value;
+}
+
+double InterleavedVolume::valueAt(const vec3 &x, int material) const
+{
+    TrilinearStencil stencil;
+    stencilAt(x, stencil);
+    return interpolate(stencil, material);
+}
+
+double InterleavedVolume::valueAt(double x, double y, double z, int material) const
+{
+    return valueAt(vec3(x,y,z), material);
+}
+
+void InterleavedVolume::valuesAt(const vec3 &x, double *out) const
+{
+    TrilinearStencil stencil;
+    stencilAt(x, stencil);
+    interpolate(stencil, out);
+}
+
+void InterleavedVolume::valuesAt(const vec3 &x, const int *materials, int count, double *out) const
+{
+    TrilinearStencil stencil;
+    stencilAt(x, stencil);
+    for(int i=0; i < count; i++)
+        out[i] = interpolate(stencil, materials[i]);
+}
+
+int InterleavedVolume::argmaxAt(const vec3 &x) const
+{
+    double stackValues[kStackMaterials];
+    std::vector<double> heapValues;
+    double *values = stackValues;
+    if(m_materials > kStackMaterials)
+    {
+        heapValues.resize(m_materials);
+        values = &heapValues[0];
+    }
+
+    valuesAt(x, values);
+
+    int maxLabel = 0;
+    for(int m=1; m < m_materials; m++)
+    {
+        if(values[m] > values[maxLabel])
+            maxLabel = m;
+    }
+    return maxLabel;
+}
+
+void InterleavedVolume::argmaxAt(const vec3 *x, size_t n, int *labels) const
+{
+    for(size_t i=0; i < n; i++)
+        labels[i] = argmaxAt(x[i]);
+}
+
+void InterleavedVolume::addMaterial(AbstractScalarField *)
+{
+    throw std::runtime_error("InterleavedVolume materials can't change after construction.");
+}
+
+void InterleavedVolume::removeMaterial(AbstractScalarField *)
+{
+    throw std::runtime_error("InterleavedVolume materials can't change after construction.");
+}
+
+}
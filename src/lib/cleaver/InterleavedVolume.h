@@ -0,0 +1,80 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- Interleaved Volume Class
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef INTERLEAVEDVOLUME_H
+#define INTERLEAVEDVOLUME_H
+
+#include <vector>
+#include "Volume.h"
+
+namespace cleaver
+{
+
+// A Volume that keeps a packed copy of its materials with every voxel's
+// values next to each other, so one sample reads eight short runs instead
+// of eight corners in each of N separate arrays. All materials must be
+// FloatFields on one grid. The source fields are still referenced for
+// getMaterial() and must outlive the volume. The material list can't
+// change after construction, addMaterial() and removeMaterial() throw.
+class InterleavedVolume : public Volume
+{
+public:
+    explicit InterleavedVolume(const Volume &volume);
+
+    virtual double valueAt(const vec3 &x, int material) const;
+    virtual double valueAt(double x, double y, double z, int material) const;
+
+    virtual void valuesAt(const vec3 &x, double *out) const;
+    virtual void valuesAt(const vec3 &x, const int *materials, int count, double *out) const;
+    virtual int argmaxAt(const vec3 &x) const;
+    virtual void argmaxAt(const vec3 *x, size_t n, int *labels) const;
+
+    virtual void addMaterial(AbstractScalarField *field);
+    virtual void removeMaterial(AbstractScalarField *field);
+
+private:
+    void stencilAt(const vec3 &x, TrilinearStencil &stencil) const;
+    void interpolate(const TrilinearStencil &stencil, double *out) const;
+    double interpolate(const TrilinearStencil &stencil, int material) const;
+
+    FloatField m_grid;              // grid geometry of the materials, no data
+    int m_materials;
+    std::vector<float> m_data;      // voxel major, material minor
+};
+
+}
+
+#endif // INTERLEAVEDVOLUME_H
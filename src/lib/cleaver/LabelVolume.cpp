@@ -0,0 +1,425 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- Label Volume Class
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "LabelVolume.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace cleaver
+{
+
+namespace
+{
+
+// inverse of the standard normal CDF, Acklam's rational approximation
+// with a relative error below 1.2e-9
+double probit(double p)
+{
+    static const double a[] = { -3.969683028665376e+01,  2.209460984245205e+02,
+                                -2.759285104469687e+02,  1.383577518672690e+02,
+                                -3.066479806614716e+01,  2.506628277459239e+00 };
+    static const double b[] = { -5.447609879822406e+01,  1.615858368580409e+02,
+                                -1.556989798598866e+02,  6.680131188771972e+01,
+                                -1.328068155288572e+01 };
+    static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01,
+                                -2.400758277161838e+00, -2.549732539343734e+00,
+                                 4.374664141464968e+00,  2.938163982698783e+00 };
+    static const double d[] = {  7.784695709041462e-03,  3.224671290700398e-01,
+                                 2.445134137142996e+00,  3.754408661907416e+00 };
+    const double low = 0.02425;
+
+    if(p < low || p > 1 - low)
+    {
+        double q = std::sqrt(-2*std::log(p < low ? p : 1 - p));
+        double x = (((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+                    ((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1);
+        return p < low ? x : -x;
+    }
+
+    double q = p - 0.5;
+    double r = q*q;
+    return (((((a[0]*r + a[1])*r + a[2])*r + a[3])*r + a[4])*r + a[5])*q /
+           (((((b[0]*r + b[1])*r + b[2])*r + b[3])*r + b[4])*r + 1);
+}
+
+}
+
+LabelVolume::LabelVolume(const unsigned short *labels, int w, int h, int d, int materials,
+                         const vec3 &spacing, double sigma, ThreadPool *pool) :
+    Volume(std::vector<AbstractScalarField*>(), w, h, d),
+    m_grid(0, w, h, d), m_w(w), m_h(h), m_d(d), m_materials(materials)
+{
+    m_grid.setScale(spacing);
+    setSize(m_grid.bounds().size);
+
+    // reserved up front, the base volume keeps pointers to these
+    m_materialFields.reserve(materials);
+    for(int m=0; m < materials; m++)
+    {
+        m_materialFields.push_back(MaterialField(this, m));
+        m_materialFields.back().setName("label " + std::to_string(m));
+    }
+    for(int m=0; m < materials; m++)
+        Volume::addMaterial(&m_materialFields[m]);
+
+    // a blur narrower than half a voxel would leave no band at all
+    double minSpacing = std::min(spacing.x, std::min(spacing.y, spacing.z));
+    m_sigma = std::max(sigma, 0.5*minSpacing);
+    m_band  = 3*m_sigma;
+
+    const double axisSpacing[3] = { spacing.x, spacing.y, spacing.z };
+    const int dims[3] = { w, h, d };
+    for(int a=0; a < 3; a++)
+    {
+        m_radius[a] = (int)std::ceil(m_band / axisSpacing[a]);
+        m_bricksPerAxis[a] = (dims[a] + kBrickSize - 1) / kBrickSize;
+    }
+
+    size_t voxels = (size_t)w*h*d;
+    if(materials <= 256)
+        m_labels8.assign(labels, labels + voxels);
+    else
+        m_labels16.assign(labels, labels + voxels);
+
+    ThreadPool inline_pool(1);
+    ThreadPool &threads = pool ? *pool : inline_pool;
+
+    // label shared by all voxels of each brick, -1 if it has several
+    const int bx = m_bricksPerAxis[0], by = m_bricksPerAxis[1], bz = m_bricksPerAxis[2];
+    size_t bricks = (size_t)bx*by*bz;
+    std::vector<int> uniform(bricks);
+    threads.parallelFor(0, bricks, 64, [&](size_t begin, size_t end, unsigned int)
+    {
+        for(size_t b = begin; b < end; b++)
+        {
+            int bi = (int)(b % bx), bj = (int)((b / bx) % by), bk = (int)(b / ((size_t)bx*by));
+            int first = labelAt(bi*kBrickSize, bj*kBrickSize, bk*kBrickSize);
+            int result = first;
+            for(int k = bk*kBrickSize; k < std::min(d, (bk+1)*kBrickSize) && result >= 0; k++)
+                for(int j = bj*kBrickSize; j < std::min(h, (bj+1)*kBrickSize) && result >= 0; j++)
+                    for(int i = bi*kBrickSize; i < std::min(w, (bi+1)*kBrickSize); i++)
+                        if(labelAt(i, j, k) != first) { result = -1; break; }
+            uniform[b] = result;
+        }
+    });
+
+    // a brick needs values if a different label lies within blur reach,
+    // checked conservatively on whole neighbouring bricks
+    int reach[3];
+    for(int a=0; a < 3; a++)
+        reach[a] = (m_radius[a] + kBrickSize - 1) / kBrickSize;
+
+    std::vector<char> inBand(bricks, 0);
+    threads.parallelFor(0, bricks, 256, [&](size_t begin, size_t end, unsigned int)
+    {
+        for(size_t b = begin; b < end; b++)
+        {
+            int bi = (int)(b % bx), bj = (int)((b / bx) % by), bk = (int)(b / ((size_t)bx*by));
+            bool band = (uniform[b] < 0);
+            for(int k = std::max(0, bk - reach[2]); k <= std::min(bz - 1, bk + reach[2]) && !band; k++)
+                for(int j = std::max(0, bj - reach[1]); j <= std::min(by - 1, bj + reach[1]) && !band; j++)
+                    for(int i = std::max(0, bi - reach[0]); i <= std::min(bx - 1, bi + reach[0]); i++)
+                        if(uniform[((size_t)k*by + j)*bx + i] != uniform[b]) { band = true; break; }
+            inBand[b] = band;
+        }
+    });
+
+    m_brickSlot.assign(bricks, -1);
+    std::vector<size_t> bandBricks;
+    for(size_t b=0; b < bricks; b++)
+    {
+        if(inBand[b])
+        {
+            m_brickSlot[b] = (int)bandBricks.size();
+            bandBricks.push_back(b);
+        }
+    }
+
+    m_bricks.resize(bandBricks.size());
+    threads.parallelFor(0, bandBricks.size(), 1, [&](size_t begin, size_t end, unsigned int)
+    {
+        for(size_t s = begin; s < end; s++)
+            buildBrick(bandBricks[s], m_bricks[s]);
+    });
+}
+
+void LabelVolume::buildBrick(size_t b, Brick &brick) const
+{
+    const int B = kBrickSize;
+    const int bx = m_bricksPerAxis[0], by = m_bricksPerAxis[1];
+    const int x0 = (int)(b % bx)*B, y0 = (int)((b / bx) % by)*B, z0 = (int)(b / ((size_t)bx*by))*B;
+    const int rx = m_radius[0], ry = m_radius[1], rz = m_radius[2];
+    const int ex = B + 2*rx, ey = B + 2*ry, ez = B + 2*rz;
+
+    // labels of the brick and its blur reach, edges replicated
+    std::vector<int> labels((size_t)ex*ey*ez);
+    for(int z=0; z < ez; z++)
+        for(int y=0; y < ey; y++)
+            for(int x=0; x < ex; x++)
+            {
+                int l = labelAt(clamp(x0 + x - rx, 0, m_w - 1),
+                                clamp(y0 + y - ry, 0, m_h - 1),
+                                clamp(z0 + z - rz, 0, m_d - 1));
+                labels[((size_t)z*ey + y)*ex + x] = l;
+                if(std::find(brick.materials.begin(), brick.materials.end(), l) == brick.materials.end())
+                    brick.materials.push_back((unsigned short)l);
+            }
+    std::sort(brick.materials.begin(), brick.materials.end());
+
+    // normalized gaussian taps per axis
+    const double spacing[3] = { m_grid.scale().x, m_grid.scale().y, m_grid.scale().z };
+    std::vector<double> taps[3];
+    for(int a=0; a < 3; a++)
+    {
+        double sum = 0;
+        for(int r = -m_radius[a]; r <= m_radius[a]; r++)
+        {
+            double x = r*spacing[a];
+            taps[a].push_back(std::exp(-x*x / (2*m_sigma*m_sigma)));
+            sum += taps[a].back();
+        }
+        for(size_t t=0; t < taps[a].size(); t++)
+            taps[a][t] /= sum;
+    }
+
+    // blur each indicator separably and map it back to a distance,
+    // sigma * probit(I) is exact for a planar boundary
+    std::vector<double> blurX((size_t)ez*ey*B), blurY((size_t)ez*B*B);
+    brick.values.resize(brick.materials.size()*B*B*B);
+    for(size_t s=0; s < brick.materials.size(); s++)
+    {
+        int m = brick.materials[s];
+
+        for(int z=0; z < ez; z++)
+            for(int y=0; y < ey; y++)
+                for(int x=0; x < B; x++)
+                {
+                    const int *row = &labels[((size_t)z*ey + y)*ex + x];
+                    double sum = 0;
+                    for(int r=0; r <= 2*rx; r++)
+                        if(row[r] == m) sum += taps[0][r];
+                    blurX[((size_t)z*ey + y)*B + x] = sum;
+                }
+
+        for(int z=0; z < ez; z++)
+            for(int y=0; y < B; y++)
+                for(int x=0; x < B; x++)
+                {
+                    double sum = 0;
+                    for(int r=0; r <= 2*ry; r++)
+                        sum += taps[1][r]*blurX[((size_t)z*ey + y + r)*B + x];
+                    blurY[((size_t)z*B + y)*B + x] = sum;
+                }
+
+        float *values = &brick.values[s*B*B*B];
+        for(int z=0; z < B; z++)
+            for(int y=0; y < B; y++)
+                for(int x=0; x < B; x++)
+                {
+                    double I = 0;
+                    for(int r=0; r <= 2*rz; r++)
+                        I += taps[2][r]*blurY[((size_t)(z + r)*B + y)*B + x];
+
+                    double value;
+                    if(I <= 0)
+                        value = -m_band;
+                    else if(I >= 1)
+                        value = m_band;
+                    else
+                        value = std::max(-m_band, std::min(m_band, m_sigma*probit(I)));
+                    values[(z*B + y)*B + x] = (float)value;
+                }
+    }
+}
+
+int LabelVolume::label(size_t index) const
+{
+    return m_labels8.empty() ? m_labels16[index] : m_labels8[index];
+}
+
+int LabelVolume::labelAt(int i, int j, int k) const
+{
+    return label(i + (size_t)j*m_w + (size_t)k*m_w*m_h);
+}
+
+size_t LabelVolume::brickIndex(int i, int j, int k) const
+{
+    return ((size_t)(k / kBrickSize)*m_bricksPerAxis[1] + j / kBrickSize)*m_bricksPerAxis[0] + i / kBrickSize;
+}
+
+void LabelVolume::cornersAt(const vec3 &x, TrilinearStencil &stencil, Corner corners[8]) const
+{
+    BoundingBox grid = m_grid.bounds();
+    m_grid.stencilAt((x.x / bounds().size.x)*grid.size.x,
+                     (x.y / bounds().size.y)*grid.size.y,
+                     (x.z / bounds().size.z)*grid.size.z, stencil);
+
+    for(int c=0; c < 8; c++)
+    {
+        int index = stencil.index[c];
+        int i = index % m_w;
+        int j = (index / m_w) % m_h;
+        int k = index / (m_w*m_h);
+
+        int slot = m_brickSlot[brickIndex(i, j, k)];
+        corners[c].brick = slot < 0 ? nullptr : &m_bricks[slot];
+        corners[c].label = label(index);
+        corners[c].local = ((k % kBrickSize)*kBrickSize + j % kBrickSize)*kBrickSize + i % kBrickSize;
+    }
+}
+
+double LabelVolume::cornerValue(const Corner &corner, int material) const
+{
+    if(!corner.brick)
+        return corner.label == material ? m_band : -m_band;
+
+    const std::vector<unsigned short> &materials = corner.brick->materials;
+    std::vector<unsigned short>::const_iterator slot =
+            std::lower_bound(materials.begin(), materials.end(), material);
+    if(slot == materials.end() || *slot != material)
+        return -m_band;
+
+    size_t offset = (size_t)(slot - materials.begin())*kBrickSize*kBrickSize*kBrickSize;
+    return corner.brick->values[offset + corner.local];
+}
+
+double LabelVolume::interpolate(const TrilinearStencil &stencil, const Corner corners[8], int material) const
+{
+    double value = stencil.weight[0]*cornerValue(corners[0], material);
+    for(int c=1; c < 8; c++)
+        value += stencil.weight[c]*cornerValue(corners[c], material);
+    return value;
+}
+
+double LabelVolume::valueAt(const vec3 &x, int material) const
+{
+    TrilinearStencil stencil;
+    Corner corners[8];
+    cornersAt(x, stencil, corners);
+    return interpolate(stencil, corners, material);
+}
+
+double LabelVolume::valueAt(double x, double y, double z, int material) const
+{
+    return valueAt(vec3(x,y,z), material);
+}
+
+void LabelVolume::valuesAt(const vec3 &x, double *out) const
+{
+    TrilinearStencil stencil;
+    Corner corners[8];
+    cornersAt(x, stencil, corners);
+    for(int m=0; m < m_materials; m++)
+        out[m] = interpolate(stencil, corners, m);
+}
+
+void LabelVolume::valuesAt(const vec3 &x, const int *materials, int count, double *out) const
+{
+    TrilinearStencil stencil;
+    Corner corners[8];
+    cornersAt(x, stencil, corners);
+    for(int i=0; i < count; i++)
+        out[i] = interpolate(stencil, corners, materials[i]);
+}
+
+int LabelVolume::argmaxAt(const vec3 &x) const
+{
+    TrilinearStencil stencil;
+    Corner corners[8];
+    cornersAt(x, stencil, corners);
+
+    // away from boundaries every corner agrees and holds no band values
+    bool homogeneous = true;
+    for(int c=0; c < 8 && homogeneous; c++)
+        homogeneous = !corners[c].brick && corners[c].label == corners[0].label;
+    if(homogeneous)
+        return corners[0].label;
+
+    double maxValue = interpolate(stencil, corners, 0);
+    int    maxLabel = 0;
+    for(int m=1; m < m_materials; m++)
+    {
+        double value = interpolate(stencil, corners, m);
+        if(value > maxValue)
+        {
+            maxValue = value;
+            maxLabel = m;
+        }
+    }
+    return maxLabel;
+}
+
+void LabelVolume::argmaxAt(const vec3 *x, size_t n, int *labels) const
+{
+    for(size_t i=0; i < n; i++)
+        labels[i] = argmaxAt(x[i]);
+}
+
+int LabelVolume::numberOfMaterials() const
+{
+    return m_materials;
+}
+
+void LabelVolume::addMaterial(AbstractScalarField *)
+{
+    throw std::runtime_error("LabelVolume materials come from its label map and can't change.");
+}
+
+void LabelVolume::removeMaterial(AbstractScalarField *)
+{
+    throw std::runtime_error("LabelVolume materials come from its label map and can't change.");
+}
+
+LabelVolume::MaterialField::MaterialField(const LabelVolume *volume, int material) :
+    m_volume(volume), m_material(material)
+{
+    setWarning(false);
+}
+
+double LabelVolume::MaterialField::valueAt(double x, double y, double z) const
+{
+    return m_volume->valueAt(x, y, z, m_material);
+}
+
+BoundingBox LabelVolume::MaterialField::bounds() const
+{
+    return m_volume->bounds();
+}
+
+}
@@ -0,0 +1,143 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- Label Volume Class
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef LABELVOLUME_H
+#define LABELVOLUME_H
+
+#include <vector>
+#include "AbstractScalarField.h"
+#include "Volume.h"
+
+namespace cleaver
+{
+
+class ThreadPool;
+
+// A Volume built straight from a segmentation. The label map is kept
+// as is and smoothed indicator values are stored only in bricks near a
+// label boundary; everywhere else a material is simply +band inside its
+// label and -band outside, so argmaxAt() away from boundaries is a
+// label lookup. Indicator values approximate signed distances to the
+// boundary of each label after a Gaussian blur of width sigma, like the
+// blurred distance maps the segmentation tools produce, clamped to
+// +-band (three sigma). Each material is exposed through getMaterial()
+// as a field named "label N" that samples the volume; the material list
+// is fixed, addMaterial() and removeMaterial() throw.
+class LabelVolume : public Volume
+{
+public:
+    // labels are material indices in [0, materials), one per voxel in
+    // x fastest order, spacing and sigma are in physical units
+    LabelVolume(const unsigned short *labels, int w, int h, int d, int materials,
+                const vec3 &spacing, double sigma, ThreadPool *pool=nullptr);
+
+    virtual double valueAt(const vec3 &x, int material) const;
+    virtual double valueAt(double x, double y, double z, int material) const;
+    virtual void valuesAt(const vec3 &x, double *out) const;
+    virtual void valuesAt(const vec3 &x, const int *materials, int count, double *out) const;
+    virtual int argmaxAt(const vec3 &x) const;
+    virtual void argmaxAt(const vec3 *x, size_t n, int *labels) const;
+    virtual int numberOfMaterials() const;
+
+    virtual void addMaterial(AbstractScalarField *field);
+    virtual void removeMaterial(AbstractScalarField *field);
+
+    int labelAt(int i, int j, int k) const;
+    double band() const { return m_band; }
+    size_t brickCount() const { return m_brickSlot.size(); }
+    size_t bandBrickCount() const { return m_bricks.size(); }
+
+    static const int kBrickSize = 8;
+
+private:
+    // the materials' fields refer back to this volume
+    LabelVolume(const LabelVolume &);
+    LabelVolume& operator=(const LabelVolume &);
+
+    // one material's values, looked up through the volume
+    class MaterialField : public AbstractScalarField
+    {
+    public:
+        MaterialField(const LabelVolume *volume, int material);
+        virtual double valueAt(double x, double y, double z) const;
+        virtual BoundingBox bounds() const;
+    private:
+        const LabelVolume *m_volume;
+        int m_material;
+    };
+
+    struct Brick
+    {
+        std::vector<unsigned short> materials;  // labels within reach of the brick
+        std::vector<float> values;              // one brick of values per material
+    };
+
+    // what a trilinear corner needs to produce any material's value
+    struct Corner
+    {
+        const Brick *brick;
+        int label;
+        int local;
+    };
+
+    int label(size_t index) const;
+    size_t brickIndex(int i, int j, int k) const;
+    void buildBrick(size_t b, Brick &brick) const;
+
+    void cornersAt(const vec3 &x, TrilinearStencil &stencil, Corner corners[8]) const;
+    double cornerValue(const Corner &corner, int material) const;
+    double interpolate(const TrilinearStencil &stencil, const Corner corners[8], int material) const;
+
+    FloatField m_grid;                      // grid geometry of the labels, no data
+    int m_w, m_h, m_d;
+    int m_materials;
+    double m_sigma;
+    double m_band;
+    int m_radius[3];                        // blur reach in voxels per axis
+    int m_bricksPerAxis[3];
+
+    std::vector<unsigned char>  m_labels8;  // used when materials fit a byte
+    std::vector<unsigned short> m_labels16;
+
+    std::vector<int>   m_brickSlot;         // index into m_bricks, -1 if far from boundaries
+    std::vector<Brick> m_bricks;
+
+    std::vector<MaterialField> m_materialFields;
+};
+
+}
+
+#endif // LABELVOLUME_H
@@ -53,7 +53,7 @@ LinearInterfaceCalculator::LinearInterfaceCalculator(
     TetMesh *mesh, AbstractVolume *volume) : m_mesh(mesh), m_volume(volume) {}
 
 
-void LinearInterfaceCalculator::computeCutForEdge(HalfEdge *edge) {
+void LinearInterfaceCalculator::computeCutForEdge(HalfEdge *edge, unsigned int thread) {
 
   // order verts
   Vertex *v2 = edge->vertex;
@@ -83,7 +83,7 @@ void LinearInterfaceCalculator::computeCutForEdge(HalfEdge *edge) {
     }
 
     double t = 1000;
-    Vertex *cut = new Vertex(m_volume->numberOfMaterials());
+    Vertex *cut = m_mesh->createVertex(m_volume->numberOfMaterials(), thread);
 
     if (b.x > m_volume->bounds().maxCorner().x)
     {
@@ -128,8 +128,8 @@ void LinearInterfaceCalculator::computeCutForEdge(HalfEdge *edge) {
       cut->pos() = v1->pos()*(1 - t) + v2->pos()*t;
 
     cut->label = std::min(v1->label, v2->label);
-    cut->lbls[v1->label] = true;
-    cut->lbls[v2->label] = true;
+    cut->lbls.set(v1->label);
+    cut->lbls.set(v2->label);
 
     // check violating condition
     if ((t <= edge->alpha) || (t >= (1 - edge->mate->alpha)))
@@ -161,15 +161,19 @@ void LinearInterfaceCalculator::computeCutForEdge(HalfEdge *edge) {
   int b_mat = v2->label;
 
 
-  double a1 = m_volume->valueAt(v1->pos(), a_mat);
-  double a2 = m_volume->valueAt(v2->pos(), a_mat);
-  double b1 = m_volume->valueAt(v1->pos(), b_mat);
-  double b2 = m_volume->valueAt(v2->pos(), b_mat);
+  const int mats[2] = { a_mat, b_mat };
+  double f1[2], f2[2];
+  m_volume->valuesAt(v1->pos(), mats, 2, f1);
+  m_volume->valuesAt(v2->pos(), mats, 2, f2);
+  double a1 = f1[0];
+  double a2 = f2[0];
+  double b1 = f1[1];
+  double b2 = f2[1];
   double top = (a1 - b1);
   double bot = (b2 - a2 + a1 - b1);
   double t = top / bot;
 
-  Vertex *cut = new Vertex(m_volume->numberOfMaterials());
+  Vertex *cut = m_mesh->createVertex(m_volume->numberOfMaterials(), thread);
   t = std::max(t, 0.0);
   t = std::min(t, 1.0);
   cut->pos() = v1->pos()*(1 - t) + v2->pos()*t;
@@ -181,8 +185,8 @@ void LinearInterfaceCalculator::computeCutForEdge(HalfEdge *edge) {
 
   // doesn't really matter which
   cut->label = a_mat;
-  cut->lbls[v1->label] = true;
-  cut->lbls[v2->label] = true;
+  cut->lbls.set(v1->label);
+  cut->lbls.set(v2->label);
 
   // check violating condition
   if ((t <= edge->alpha) || (t >= (1 - edge->mate->alpha)))
@@ -196,7 +200,7 @@ void LinearInterfaceCalculator::computeCutForEdge(HalfEdge *edge) {
 }
 
 
-void LinearInterfaceCalculator::computeTripleForFace(HalfFace *face) {
+void LinearInterfaceCalculator::computeTripleForFace(HalfFace *face, unsigned int thread) {
   // set as evaluated
   face->evaluated = true;
   if (face->mate)
@@ -242,11 +246,11 @@ void LinearInterfaceCalculator::computeTripleForFace(HalfFace *face) {
     vec3 b = edges[(external_vertex + 2) % 3]->cut->pos();
 
 
-    Vertex *triple = new Vertex(m_volume->numberOfMaterials());
+    Vertex *triple = m_mesh->createVertex(m_volume->numberOfMaterials(), thread);
     triple->pos() = (0.5)*(a + b);
-    triple->lbls[v1->label] = true;
-    triple->lbls[v2->label] = true;
-    triple->lbls[v3->label] = true;
+    triple->lbls.set(v1->label);
+    triple->lbls.set(v2->label);
+    triple->lbls.set(v3->label);
     triple->order() = Order::TRIP;
     triple->violating = false;
     triple->closestGeometry = nullptr;
@@ -257,6 +261,13 @@ void LinearInterfaceCalculator::computeTripleForFace(HalfFace *face) {
     return;
   }
 
+  // sample the three materials at each vertex once
+  const int mats[3] = { m1, m2, m3 };
+  double f1[3], f2[3], f3[3];
+  m_volume->valuesAt(v1->pos(), mats, 3, f1);
+  m_volume->valuesAt(v2->pos(), mats, 3, f2);
+  m_volume->valuesAt(v3->pos(), mats, 3, f3);
+
   // determine orientation, pick an axis
   vec3 n = normalize((v2->pos() - v1->pos()).cross(v3->pos() - v1->pos()));
 
@@ -275,17 +286,17 @@ void LinearInterfaceCalculator::computeTripleForFace(HalfFace *face) {
   if (axis == 1)
   {
 
-    vec3 p1_m1 = vec3(v1->pos().y, m_volume->valueAt(v1->pos(), m1), v1->pos().z);
-    vec3 p2_m1 = vec3(v2->pos().y, m_volume->valueAt(v2->pos(), m1), v2->pos().z);
-    vec3 p3_m1 = vec3(v3->pos().y, m_volume->valueAt(v3->pos(), m1), v3->pos().z);
+    vec3 p1_m1 = vec3(v1->pos().y, f1[0], v1->pos().z);
+    vec3 p2_m1 = vec3(v2->pos().y, f2[0], v2->pos().z);
+    vec3 p3_m1 = vec3(v3->pos().y, f3[0], v3->pos().z);
 
-    vec3 p1_m2 = vec3(v1->pos().y, m_volume->valueAt(v1->pos(), m2), v1->pos().z);
-    vec3 p2_m2 = vec3(v2->pos().y, m_volume->valueAt(v2->pos(), m2), v2->pos().z);
-    vec3 p3_m2 = vec3(v3->pos().y, m_volume->valueAt(v3->pos(), m2), v3->pos().z);
+    vec3 p1_m2 = vec3(v1->pos().y, f1[1], v1->pos().z);
+    vec3 p2_m2 = vec3(v2->pos().y, f2[1], v2->pos().z);
+    vec3 p3_m2 = vec3(v3->pos().y, f3[1], v3->pos().z);
 
-    vec3 p1_m3 = vec3(v1->pos().y, m_volume->valueAt(v1->pos(), m3), v1->pos().z);
-    vec3 p2_m3 = vec3(v2->pos().y, m_volume->valueAt(v2->pos(), m3), v2->pos().z);
-    vec3 p3_m3 = vec3(v3->pos().y, m_volume->valueAt(v3->pos(), m3), v3->pos().z);
+    vec3 p1_m3 = vec3(v1->pos().y, f1[2], v1->pos().z);
+    vec3 p2_m3 = vec3(v2->pos().y, f2[2], v2->pos().z);
+    vec3 p3_m3 = vec3(v3->pos().y, f3[2], v3->pos().z);
 
     Plane plane1 = Plane::throughPoints(p1_m1, p2_m1, p3_m1);
     Plane plane2 = Plane::throughPoints(p1_m2, p2_m2, p3_m2);
@@ -326,17 +337,17 @@ void LinearInterfaceCalculator::computeTripleForFace(HalfFace *face) {
 
   } else if (axis == 2)
   {
-    vec3 p1_m1 = vec3(v1->pos().x, m_volume->valueAt(v1->pos(), m1), v1->pos().z);
-    vec3 p2_m1 = vec3(v2->pos().x, m_volume->valueAt(v2->pos(), m1), v2->pos().z);
-    vec3 p3_m1 = vec3(v3->pos().x, m_volume->valueAt(v3->pos(), m1), v3->pos().z);
+    vec3 p1_m1 = vec3(v1->pos().x, f1[0], v1->pos().z);
+    vec3 p2_m1 = vec3(v2->pos().x, f2[0], v2->pos().z);
+    vec3 p3_m1 = vec3(v3->pos().x, f3[0], v3->pos().z);
 
-    vec3 p1_m2 = vec3(v1->pos().x, m_volume->valueAt(v1->pos(), m2), v1->pos().z);
-    vec3 p2_m2 = vec3(v2->pos().x, m_volume->valueAt(v2->pos(), m2), v2->pos().z);
-    vec3 p3_m2 = vec3(v3->pos().x, m_volume->valueAt(v3->pos(), m2), v3->pos().z);
+    vec3 p1_m2 = vec3(v1->pos().x, f1[1], v1->pos().z);
+    vec3 p2_m2 = vec3(v2->pos().x, f2[1], v2->pos().z);
+    vec3 p3_m2 = vec3(v3->pos().x, f3[1], v3->pos().z);
 
-    vec3 p1_m3 = vec3(v1->pos().x, m_volume->valueAt(v1->pos(), m3), v1->pos().z);
-    vec3 p2_m3 = vec3(v2->pos().x, m_volume->valueAt(v2->pos(), m3), v2->pos().z);
-    vec3 p3_m3 = vec3(v3->pos().x, m_volume->valueAt(v3->pos(), m3), v3->pos().z);
+    vec3 p1_m3 = vec3(v1->pos().x, f1[2], v1->pos().z);
+    vec3 p2_m3 = vec3(v2->pos().x, f2[2], v2->pos().z);
+    vec3 p3_m3 = vec3(v3->pos().x, f3[2], v3->pos().z);
 
     Plane plane1 = Plane::throughPoints(p1_m1, p2_m1, p3_m1);
     Plane plane2 = Plane::throughPoints(p1_m2, p2_m2, p3_m2);
@@ -376,17 +387,17 @@ void LinearInterfaceCalculator::computeTripleForFace(HalfFace *face) {
     }
   } else if (axis == 3)
   {
-    vec3 p1_m1 = vec3(v1->pos().x, m_volume->valueAt(v1->pos(), m1), v1->pos().y);
-    vec3 p2_m1 = vec3(v2->pos().x, m_volume->valueAt(v2->pos(), m1), v2->pos().y);
-    vec3 p3_m1 = vec3(v3->pos().x, m_volume->valueAt(v3->pos(), m1), v3->pos().y);
+    vec3 p1_m1 = vec3(v1->pos().x, f1[0], v1->pos().y);
+    vec3 p2_m1 = vec3(v2->pos().x, f2[0], v2->pos().y);
+    vec3 p3_m1 = vec3(v3->pos().x, f3[0], v3->pos().y);
 
-    vec3 p1_m2 = vec3(v1->pos().x, m_volume->valueAt(v1->pos(), m2), v1->pos().y);
-    vec3 p2_m2 = vec3(v2->pos().x, m_volume->valueAt(v2->pos(), m2), v2->pos().y);
-    vec3 p3_m2 = vec3(v3->pos().x, m_volume->valueAt(v3->pos(), m2), v3->pos().y);
+    vec3 p1_m2 = vec3(v1->pos().x, f1[1], v1->pos().y);
+    vec3 p2_m2 = vec3(v2->pos().x, f2[1], v2->pos().y);
+    vec3 p3_m2 = vec3(v3->pos().x, f3[1], v3->pos().y);
 
-    vec3 p1_m3 = vec3(v1->pos().x, m_volume->valueAt(v1->pos(), m3), v1->pos().y);
-    vec3 p2_m3 = vec3(v2->pos().x, m_volume->valueAt(v2->pos(), m3), v2->pos().y);
-    vec3 p3_m3 = vec3(v3->pos().x, m_volume->valueAt(v3->pos(), m3), v3->pos().y);
+    vec3 p1_m3 = vec3(v1->pos().x, f1[2], v1->pos().y);
+    vec3 p2_m3 = vec3(v2->pos().x, f2[2], v2->pos().y);
+    vec3 p3_m3 = vec3(v3->pos().x, f3[2], v3->pos().y);
 
     Plane plane1 = Plane::throughPoints(p1_m1, p2_m1, p3_m1);
     Plane plane2 = Plane::throughPoints(p1_m2, p2_m2, p3_m2);
@@ -432,11 +443,11 @@ void LinearInterfaceCalculator::computeTripleForFace(HalfFace *face) {
   //-------------------------------------------------------
   // Create the Triple Vertex
   //-------------------------------------------------------
-  Vertex *triple = new Vertex(m_volume->numberOfMaterials());
+  Vertex *triple = m_mesh->createVertex(m_volume->numberOfMaterials(), thread);
   triple->pos() = result;
-  triple->lbls[v1->label] = true;
-  triple->lbls[v2->label] = true;
-  triple->lbls[v3->label] = true;
+  triple->lbls.set(v1->label);
+  triple->lbls.set(v2->label);
+  triple->lbls.set(v3->label);
   triple->order() = Order::TRIP;
   triple->violating = false;
   triple->closestGeometry = nullptr;
@@ -506,11 +517,11 @@ void LinearInterfaceCalculator::computeTripleForFace2(HalfFace *face)
   //-------------------------------------------------------
   // Create the Triple Vertex
   //-------------------------------------------------------
-  Vertex *triple = new Vertex(m_volume->numberOfMaterials());
+  Vertex *triple = m_mesh->createVertex(m_volume->numberOfMaterials());
   triple->pos() = result;
-  triple->lbls[v1->label] = true;
-  triple->lbls[v2->label] = true;
-  triple->lbls[v3->label] = true;
+  triple->lbls.set(v1->label);
+  triple->lbls.set(v2->label);
+  triple->lbls.set(v3->label);
   triple->order() = Order::TRIP;
   triple->violating = false;
   triple->closestGeometry = nullptr;
@@ -521,7 +532,7 @@ void LinearInterfaceCalculator::computeTripleForFace2(HalfFace *face)
 */
 
 
-void LinearInterfaceCalculator::computeQuadrupleForTet(Tet *tet) {
+void LinearInterfaceCalculator::computeQuadrupleForTet(Tet *tet, unsigned int thread) {
   // set as evaluated
   tet->evaluated = true;
 
@@ -540,7 +551,7 @@ void LinearInterfaceCalculator::computeQuadrupleForTet(Tet *tet) {
   // TODO:   Implement Compute Quadruple
   // for now, take middle
 
-  Vertex *quadruple = new Vertex(m_volume->numberOfMaterials());
+  Vertex *quadruple = m_mesh->createVertex(m_volume->numberOfMaterials(), thread);
 
   Vertex *v1 = verts[0];
   Vertex *v2 = verts[1];
@@ -548,10 +559,10 @@ void LinearInterfaceCalculator::computeQuadrupleForTet(Tet *tet) {
   Vertex *v4 = verts[3];
 
   quadruple->pos() = (1.0 / 4.0)*(v1->pos() + v2->pos() + v3->pos() + v4->pos());
-  quadruple->lbls[v1->label] = true;
-  quadruple->lbls[v2->label] = true;
-  quadruple->lbls[v3->label] = true;
-  quadruple->lbls[v4->label] = true;
+  quadruple->lbls.set(v1->label);
+  quadruple->lbls.set(v2->label);
+  quadruple->lbls.set(v3->label);
+  quadruple->lbls.set(v4->label);
   quadruple->label = std::min(v1->label, v2->label);
   tet->quadruple = quadruple;
   tet->quadruple->violating = false;
@@ -0,0 +1,160 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- Object Pool
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+//-------------------------------------------------------------------
+
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <utility>
+#include <cstddef>
+
+namespace cleaver
+{
+
+/**
+ * Slab allocator for objects of a single type. Objects are constructed
+ * in place inside large slabs and are never released individually; all
+ * of them are destroyed together when the pool is cleared or goes out
+ * of scope. This replaces hundreds of thousands of small new/delete
+ * calls with one allocation per slab.
+ */
+template <typename T>
+class ObjectPool
+{
+public:
+    explicit ObjectPool(size_t slabSize = 4096) : m_slabSize(slabSize), m_size(0) {}
+    ~ObjectPool() { clear(); }
+
+    // construct a single object in the pool
+    template <typename... Args>
+    T* create(Args&&... args)
+    {
+        Slab &slab = reserve(1);
+        T *obj = new (slab.data + slab.count) T(std::forward<Args>(args)...);
+        slab.count++;
+        m_size++;
+        return obj;
+    }
+
+    // construct a contiguous, value initialized array of n objects
+    T* allocate(size_t n)
+    {
+        Slab &slab = reserve(n);
+        T *objs = slab.data + slab.count;
+        for (size_t i = 0; i < n; i++) {
+            new (objs + i) T();
+            slab.count++;
+        }
+        m_size += n;
+        return objs;
+    }
+
+    // is this object stored in one of the pool's slabs
+    bool owns(const T *obj) const
+    {
+        std::less<const T*> less;
+        size_t lo = 0, hi = m_sorted.size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            const Slab &slab = m_slabs[m_sorted[mid]];
+            if (less(obj, slab.data))
+                hi = mid;
+            else if (!less(obj, slab.data + slab.capacity))
+                lo = mid + 1;
+            else
+                return true;
+        }
+        return false;
+    }
+
+    size_t size() const { return m_size; }
+
+    // destroy every object and release all slabs
+    void clear()
+    {
+        for (size_t s = 0; s < m_slabs.size(); s++) {
+            for (size_t i = 0; i < m_slabs[s].count; i++)
+                m_slabs[s].data[i].~T();
+            ::operator delete(m_slabs[s].data);
+        }
+        m_slabs.clear();
+        m_sorted.clear();
+        m_size = 0;
+    }
+
+private:
+    ObjectPool(const ObjectPool&);
+    ObjectPool& operator=(const ObjectPool&);
+
+    struct Slab {
+        T *data;
+        size_t count;       // constructed objects
+        size_t capacity;
+    };
+
+    // return a slab with room for n more objects
+    Slab& reserve(size_t n)
+    {
+        if (m_slabs.empty() || m_slabs.back().count + n > m_slabs.back().capacity) {
+            Slab slab;
+            slab.capacity = std::max(m_slabSize, n);
+            slab.data = static_cast<T*>(::operator new(slab.capacity * sizeof(T)));
+            slab.count = 0;
+            m_slabs.push_back(slab);
+
+            // keep slab indices sorted by address for owns()
+            size_t index = m_slabs.size() - 1;
+            std::vector<size_t>::iterator pos = m_sorted.begin();
+            while (pos != m_sorted.end() && std::less<T*>()(m_slabs[*pos].data, slab.data))
+                ++pos;
+            m_sorted.insert(pos, index);
+        }
+        return m_slabs.back();
+    }
+
+    size_t m_slabSize;
+    size_t m_size;
+    std::vector<Slab> m_slabs;       // in allocation order
+    std::vector<size_t> m_sorted;    // slab indices ordered by address
+};
+
+}
+
+#endif // OBJECT_POOL_H
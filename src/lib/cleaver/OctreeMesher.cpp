@@ -3,6 +3,7 @@
 #include "vec3.h"
 #include "Octree.h"
 #include "SizingFieldOracle.h"
+#include "ThreadPool.h"
 
 #include <cmath>
 #include <map>
@@ -13,6 +14,10 @@ namespace cleaver
 {
 
 namespace{
+
+// octree levels adapted serially before the subtrees go to the pool
+const int kSerialDepth = 2;
+
 class vec3order{
 public:
 
@@ -129,7 +134,7 @@ int heightPaths[18][4] =
 class OctreeMesherImp
 {
 public:
-    OctreeMesherImp(const AbstractScalarField *sizing_field = nullptr);
+    OctreeMesherImp(const AbstractScalarField *sizing_field = nullptr, ThreadPool *pool = nullptr);
     ~OctreeMesherImp();
 
     void createOracle();
@@ -139,13 +144,13 @@ public:
     void createBackgroundTets();
     void cleanup();
 
-    void adaptCell(OTCell *cell);
+    void adaptCell(OTCell *cell, std::vector<OTCell*> *subtrees = nullptr, int depth = 0);
     Vertex* vertexForPosition(const vec3 &pos, bool create=true);
     int heightForPath(OTCell *cell, int path, int depth = 0);
 
     const AbstractScalarField *m_sizing_field;
     const SizingFieldOracle   *m_sizing_oracle;
-
+    ThreadPool                *m_pool;
 
 
     cleaver::TetMesh *m_mesh;
@@ -155,8 +160,8 @@ public:
     std::map<vec3,    vec3, vec3order> m_warp_tracker;
 };
 
-OctreeMesherImp::OctreeMesherImp(const cleaver::AbstractScalarField *sizing_field) :
-    m_mesh(nullptr), m_tree(nullptr), m_sizing_field(sizing_field), m_sizing_oracle(nullptr)
+OctreeMesherImp::OctreeMesherImp(const cleaver::AbstractScalarField *sizing_field, ThreadPool *pool) :
+    m_mesh(nullptr), m_tree(nullptr), m_sizing_field(sizing_field), m_sizing_oracle(nullptr), m_pool(pool)
 {
 }
 
@@ -175,7 +180,7 @@ OctreeMesherImp::~OctreeMesherImp()
 void OctreeMesherImp::createOracle()
 {
     const BoundingBox bounds = m_sizing_field->bounds();
-    m_sizing_oracle = new SizingFieldOracle(m_sizing_field, bounds);
+    m_sizing_oracle = new SizingFieldOracle(m_sizing_field, bounds, m_pool);
 }
 
 //============================================
@@ -192,7 +197,21 @@ void OctreeMesherImp::createOctree()
     m_tree = new Octree(bounds);
 
     // breadth first creation
-    adaptCell(m_tree->root());
+    if (m_pool && m_pool->threadCount() > 1)
+    {
+      // cells only split on their own LFS, so the subtrees
+      // below the top levels can be adapted independently
+      std::vector<OTCell*> subtrees;
+      adaptCell(m_tree->root(), &subtrees);
+      m_pool->parallelFor(0, subtrees.size(), 1,
+        [&](size_t begin, size_t end, unsigned int)
+      {
+        for (size_t i = begin; i < end; i++)
+          adaptCell(subtrees[i]);
+      });
+    }
+    else
+      adaptCell(m_tree->root());
 }
 
 //======================================================
@@ -299,12 +318,20 @@ int OctreeMesherImp::heightForPath(OTCell *cell, int path, int depth)
 
 //============================================
 // - adaptCell()
+//
+// If subtrees is given, cells kSerialDepth
+// levels down are collected there instead.
 //============================================
-void OctreeMesherImp::adaptCell(OTCell *cell)
+void OctreeMesherImp::adaptCell(OTCell *cell, std::vector<OTCell*> *subtrees, int depth)
 {
   if(!cell)
     return;
 
+  if(subtrees && depth == kSerialDepth) {
+    subtrees->push_back(cell);
+    return;
+  }
+
   BoundingBox domainBounds = m_sizing_field->bounds();
 
   int max_x = (int)(domainBounds.maxCorner().x);
@@ -340,7 +367,7 @@ void OctreeMesherImp::adaptCell(OTCell *cell)
   if(cell->hasChildren()){
     for(int i=0; i < 8; i++)
     {
-      adaptCell(cell->children[i]);
+      adaptCell(cell->children[i], subtrees, depth + 1);
     }
   }
 }
@@ -643,7 +670,7 @@ Vertex* OctreeMesherImp::vertexForPosition(const vec3 &position, bool create)
   {
     if (create)
     {
-      vertex = new Vertex();
+      vertex = m_mesh->createVertex();
       vertex->pos() = pos;
       m_vertex_tracker[pos] = vertex;
     }
@@ -659,8 +686,8 @@ Vertex* OctreeMesherImp::vertexForPosition(const vec3 &position, bool create)
 
 
 //---------------------- public interface ----------------------
-OctreeMesher::OctreeMesher(const cleaver::AbstractScalarField *sizing_field) :
-    m_pimpl(new OctreeMesherImp(sizing_field))
+OctreeMesher::OctreeMesher(const cleaver::AbstractScalarField *sizing_field, ThreadPool *pool) :
+    m_pimpl(new OctreeMesherImp(sizing_field, pool))
 {
 }
 
@@ -7,11 +7,12 @@
 namespace cleaver {
 
 class OctreeMesherImp;
+class ThreadPool;
 
 class OctreeMesher
 {
 public:
-    OctreeMesher(const cleaver::AbstractScalarField *sizing_field = nullptr);
+    OctreeMesher(const cleaver::AbstractScalarField *sizing_field = nullptr, ThreadPool *pool = nullptr);
     ~OctreeMesher();
 
     void setSizingField(const cleaver::AbstractScalarField *sizing_field);
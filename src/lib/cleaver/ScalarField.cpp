@@ -38,9 +38,175 @@
 //-------------------------------------------------------------------
 
 #include <math.h>
+#include <typeinfo>
 #include "ScalarField.h"
 #include "vec3.h"
 
+// the AVX2 kernel is compiled per function and picked at runtime,
+// so the library itself still builds for any x86 target
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CLEAVER_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+
+
+namespace
+{
+
+// everything the batch kernels need to map a point into the grid
+struct GridParams
+{
+    double origin[3];
+    double scaleInv[3];
+    bool   cellCentered;
+    bool   clamped;
+    int    hi[3];       // largest index the clamp allows on each axis
+    int    w, wh;
+};
+
+#ifdef CLEAVER_AVX2_DISPATCH
+
+bool hasAVX2()
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2") != 0;
+    return avx2;
+}
+
+// clamp(i, 0, hi) exactly as the scalar clamp(), including when hi < 0
+__attribute__((target("avx2")))
+inline __m128i clampIndex(__m128i i, __m128i hi)
+{
+    __m128i lo = _mm_setzero_si128();
+    return _mm_blendv_epi8(_mm_min_epi32(i, hi), lo, _mm_cmplt_epi32(i, lo));
+}
+
+// map one coordinate of four points to cell indices and fractions. The
+// fraction is x - trunc(x) carrying the sign of x, which is what fmod(x,1)
+// returns, so weights match the scalar path bit for bit.
+__attribute__((target("avx2")))
+inline void splitCoordinate(__m256d x, const GridParams &grid, int axis,
+                            __m128i &i0, __m128i &i1, __m256d &t)
+{
+    x = _mm256_mul_pd(_mm256_sub_pd(x, _mm256_set1_pd(grid.origin[axis])),
+                      _mm256_set1_pd(grid.scaleInv[axis]));
+    if(grid.cellCentered)
+        x = _mm256_sub_pd(x, _mm256_set1_pd(0.5));
+
+    __m256d sign = _mm256_and_pd(x, _mm256_set1_pd(-0.0));
+    t = _mm256_sub_pd(x, _mm256_round_pd(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+    t = _mm256_or_pd(t, sign);
+
+    i0 = _mm256_cvttpd_epi32(_mm256_floor_pd(x));
+    i1 = _mm_add_epi32(i0, _mm_set1_epi32(1));
+    if(grid.clamped)
+    {
+        __m128i hi = _mm_set1_epi32(grid.hi[axis]);
+        i0 = clampIndex(i0, hi);
+        i1 = clampIndex(i1, hi);
+    }
+}
+
+// the masked gathers take an explicit zeroed source, the unmasked forms
+// leave it undefined and trip -Wmaybe-uninitialized
+__attribute__((target("avx2")))
+inline __m256d gatherCorner(const float *data, __m128i index)
+{
+    __m128 all = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    return _mm256_cvtps_pd(_mm_mask_i32gather_ps(_mm_setzero_ps(), data, index, all, 4));
+}
+
+__attribute__((target("avx2")))
+inline __m256d gatherCorner(const double *data, __m128i index)
+{
+    __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), data, index, all, 8);
+}
+
+// four points per iteration, returns how many points were evaluated
+template <typename T>
+__attribute__((target("avx2")))
+size_t trilinearAVX2(const T *data, const GridParams &grid,
+                     const cleaver::vec3 *x, size_t n, double *out)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m128i w   = _mm_set1_epi32(grid.w);
+    const __m128i wh  = _mm_set1_epi32(grid.wh);
+
+    size_t p = 0;
+    for(; p + 4 <= n; p += 4)
+    {
+        const cleaver::vec3 *q = x + p;
+        __m256d px = _mm256_set_pd(q[3].x, q[2].x, q[1].x, q[0].x);
+        __m256d py = _mm256_set_pd(q[3].y, q[2].y, q[1].y, q[0].y);
+        __m256d pz = _mm256_set_pd(q[3].z, q[2].z, q[1].z, q[0].z);
+
+        __m128i i0, i1, j0, j1, k0, k1;
+        __m256d t, u, v;
+        splitCoordinate(px, grid, 0, i0, i1, t);
+        splitCoordinate(py, grid, 1, j0, j1, u);
+        splitCoordinate(pz, grid, 2, k0, k1, v);
+
+        __m128i j0w  = _mm_mullo_epi32(j0, w),  j1w  = _mm_mullo_epi32(j1, w);
+        __m128i k0wh = _mm_mullo_epi32(k0, wh), k1wh = _mm_mullo_epi32(k1, wh);
+        __m128i r00  = _mm_add_epi32(j0w, k0wh), r01 = _mm_add_epi32(j0w, k1wh);
+        __m128i r10  = _mm_add_epi32(j1w, k0wh), r11 = _mm_add_epi32(j1w, k1wh);
+
+        __m256d mt = _mm256_sub_pd(one, t);
+        __m256d mu = _mm256_sub_pd(one, u);
+        __m256d mv = _mm256_sub_pd(one, v);
+        __m256d tu[4] = { _mm256_mul_pd(mt, mu), _mm256_mul_pd(mt, u),
+                          _mm256_mul_pd(t,  mu), _mm256_mul_pd(t,  u) };
+
+        // same corner order and summation order as the scalar expansion
+        __m256d value = _mm256_mul_pd(_mm256_mul_pd(tu[0], mv),
+                                      gatherCorner(data, _mm_add_epi32(i0, r00)));
+        value = _mm256_add_pd(value, _mm256_mul_pd(_mm256_mul_pd(tu[0], v),
+                                      gatherCorner(data, _mm_add_epi32(i0, r01))));
+        value = _mm256_add_pd(value, _mm256_mul_pd(_mm256_mul_pd(tu[1], mv),
+                                      gatherCorner(data, _mm_add_epi32(i0, r10))));
+        value = _mm256_add_pd(value, _mm256_mul_pd(_mm256_mul_pd(tu[1], v),
+                                      gatherCorner(data, _mm_add_epi32(i0, r11))));
+        value = _mm256_add_pd(value, _mm256_mul_pd(_mm256_mul_pd(tu[2], mv),
+                                      gatherCorner(data, _mm_add_epi32(i1, r00))));
+        value = _mm256_add_pd(value, _mm256_mul_pd(_mm256_mul_pd(tu[2], v),
+                                      gatherCorner(data, _mm_add_epi32(i1, r01))));
+        value = _mm256_add_pd(value, _mm256_mul_pd(_mm256_mul_pd(tu[3], mv),
+                                      gatherCorner(data, _mm_add_epi32(i1, r10))));
+        value = _mm256_add_pd(value, _mm256_mul_pd(_mm256_mul_pd(tu[3], v),
+                                      gatherCorner(data, _mm_add_epi32(i1, r11))));
+
+        _mm256_storeu_pd(out + p, value);
+    }
+    return p;
+}
+
+#endif
+
+// only float and double grids have a vector kernel, the remaining points
+// (and every other type) go through the scalar stencil
+template <typename T>
+size_t trilinearBatch(const T *, const GridParams &, const cleaver::vec3 *, size_t, double *)
+{
+    return 0;
+}
+
+#ifdef CLEAVER_AVX2_DISPATCH
+template <>
+size_t trilinearBatch<float>(const float *data, const GridParams &grid,
+                             const cleaver::vec3 *x, size_t n, double *out)
+{
+    return hasAVX2() ? trilinearAVX2(data, grid, x, n, out) : 0;
+}
+
+template <>
+size_t trilinearBatch<double>(const double *data, const GridParams &grid,
+                              const cleaver::vec3 *x, size_t n, double *out)
+{
+    return hasAVX2() ? trilinearAVX2(data, grid, x, n, out) : 0;
+}
+#endif
+
+}
 
 namespace cleaver
 {
@@ -50,7 +216,8 @@ cleaver::CenteringType ScalarField<T>::DefaultCenteringType = cleaver::CellCente
 
 template <typename T>
 ScalarField<T>::ScalarField(T *data, int w, int h, int d)
-    : m_w(w), m_h(h), m_d(d), m_data(data)
+    : m_w(w), m_h(h), m_d(d), m_data(data),
+      m_quantScale(1), m_quantOffset(0), m_quantized(false), m_gridRevision(0)
 {
     // default to data bounds
     m_scale = vec3(vec3::unitX.x, vec3::unitY.y, vec3::unitZ.z);
@@ -68,6 +235,54 @@ ScalarField<T>::~ScalarField()
 
 template <typename T>
 double ScalarField<T>::valueAt(double x, double y, double z) const
+{
+    TrilinearStencil stencil;
+    stencilAt(x, y, z, stencil);
+    return valueAt(stencil);
+}
+
+template <typename T>
+void ScalarField<T>::valueAt(const vec3 *x, size_t n, double *out) const
+{
+    // subclasses such as ConstantField override the point lookup and may
+    // have no data, so only a plain ScalarField reads its grid directly
+    if(typeid(*this) != typeid(ScalarField<T>))
+    {
+        for(size_t i=0; i < n; i++)
+            out[i] = valueAt(x[i]);
+        return;
+    }
+
+    GridParams grid;
+    grid.origin[0] = m_bounds.origin.x;  grid.scaleInv[0] = m_scaleInv.x;
+    grid.origin[1] = m_bounds.origin.y;  grid.scaleInv[1] = m_scaleInv.y;
+    grid.origin[2] = m_bounds.origin.z;  grid.scaleInv[2] = m_scaleInv.z;
+    grid.cellCentered = (m_centeringType == CellCentered);
+    grid.clamped = (m_centeringType == CellCentered || m_centeringType == NodeCentered);
+    int pad = (m_centeringType == NodeCentered) ? 2 : 1;
+    grid.hi[0] = m_w - pad;
+    grid.hi[1] = m_h - pad;
+    grid.hi[2] = m_d - pad;
+    grid.w  = m_w;
+    grid.wh = m_w*m_h;
+
+    size_t done = trilinearBatch(m_data, grid, x, n, out);
+    if(m_quantized)
+    {
+        for(size_t i=0; i < done; i++)
+            out[i] = out[i]*m_quantScale + m_quantOffset;
+    }
+
+    TrilinearStencil stencil;
+    for(size_t i=done; i < n; i++)
+    {
+        stencilAt(x[i].x, x[i].y, x[i].z, stencil);
+        out[i] = valueAt(stencil);
+    }
+}
+
+template <typename T>
+void ScalarField<T>::stencilAt(double x, double y, double z, TrilinearStencil &stencil) const
 {
     x = (x - m_bounds.origin.x)*m_scaleInv.x;
     y = (y - m_bounds.origin.y)*m_scaleInv.y;
@@ -109,20 +324,36 @@ double ScalarField<T>::valueAt(double x, double y, double z) const
         k1 = clamp(k1, 0, m_d-2);
     }
 
+    stencil.index[0] = i0 + j0*m_w + k0*m_w*m_h;
+    stencil.index[1] = i0 + j0*m_w + k1*m_w*m_h;
+    stencil.index[2] = i0 + j1*m_w + k0*m_w*m_h;
+    stencil.index[3] = i0 + j1*m_w + k1*m_w*m_h;
+    stencil.index[4] = i1 + j0*m_w + k0*m_w*m_h;
+    stencil.index[5] = i1 + j0*m_w + k1*m_w*m_h;
+    stencil.index[6] = i1 + j1*m_w + k0*m_w*m_h;
+    stencil.index[7] = i1 + j1*m_w + k1*m_w*m_h;
+
+    stencil.weight[0] = (1-t)*(1-u)*(1-v);
+    stencil.weight[1] = (1-t)*(1-u)*(v);
+    stencil.weight[2] = (1-t)*  (u)*(1-v);
+    stencil.weight[3] = (1-t)*  (u)*(v);
+    stencil.weight[4] =   (t)*(1-u)*(1-v);
+    stencil.weight[5] =   (t)*(1-u)*(v);
+    stencil.weight[6] =   (t)*  (u)*(1-v);
+    stencil.weight[7] =   (t)*  (u)*(v);
+}
 
-    double C000 = m_data[i0 + j0*m_w + k0*m_w*m_h];
-    double C001 = m_data[i0 + j0*m_w + k1*m_w*m_h];
-    double C010 = m_data[i0 + j1*m_w + k0*m_w*m_h];
-    double C011 = m_data[i0 + j1*m_w + k1*m_w*m_h];
-    double C100 = m_data[i1 + j0*m_w + k0*m_w*m_h];
-    double C101 = m_data[i1 + j0*m_w + k1*m_w*m_h];
-    double C110 = m_data[i1 + j1*m_w + k0*m_w*m_h];
-    double C111 = m_data[i1 + j1*m_w + k1*m_w*m_h];
-
-    return double((1-t)*(1-u)*(1-v)*C000 + (1-t)*(1-u)*(v)*C001 +
-                 (1-t)*  (u)*(1-v)*C010 + (1-t)*  (u)*(v)*C011 +
-                   (t)*(1-u)*(1-v)*C100 +   (t)*(1-u)*(v)*C101 +
-                   (t)*  (u)*(1-v)*C110 +   (t)*  (u)*(v)*C111);
+template <typename T>
+double ScalarField<T>::valueAt(const TrilinearStencil &stencil) const
+{
+    // summed in the same order as the original expansion so results
+    // are bit-identical to the unbatched evaluation
+    double value = stencil.weight[0]*(double)m_data[stencil.index[0]];
+    for(int c=1; c < 8; c++)
+        value += stencil.weight[c]*(double)m_data[stencil.index[c]];
+    if(m_quantized)
+        value = value*m_quantScale + m_quantOffset;
+    return value;
 }
 
 template <typename T>
@@ -153,6 +384,7 @@ template <typename T>
 void ScalarField<T>::setBounds(const BoundingBox &bounds)
 {
     m_bounds = bounds;
+    m_gridRevision++;
 }
 
 template <typename T>
@@ -191,6 +423,7 @@ void ScalarField<T>::setScale(const vec3 &scale)
     m_bounds.size =    vec3(m_bounds.size.x*m_scale.x,
                             m_bounds.size.y*m_scale.y,
                             m_bounds.size.z*m_scale.z);
+    m_gridRevision++;
 }
 
 template <typename T>
@@ -199,10 +432,37 @@ const vec3& ScalarField<T>::scale() const
     return m_scale;
 }
 
+template <typename T>
+unsigned int ScalarField<T>::gridRevision() const
+{
+    return m_gridRevision;
+}
+
+template <typename T>
+void ScalarField<T>::setQuantization(double scale, double offset)
+{
+    m_quantScale = scale;
+    m_quantOffset = offset;
+    m_quantized = (scale != 1 || offset != 0);
+}
+
+template <typename T>
+double ScalarField<T>::quantizationScale() const
+{
+    return m_quantScale;
+}
+
+template <typename T>
+double ScalarField<T>::quantizationOffset() const
+{
+    return m_quantOffset;
+}
+
 template <typename T>
 void ScalarField<T>::setCenterType(CenteringType center)
 {
     m_centeringType = center;
+    m_gridRevision++;
 }
 
 template <typename T>
@@ -229,4 +489,7 @@ template class ScalarField<unsigned int>;
 template class ScalarField<long int>;
 template class ScalarField<long double>;
 
+template class ScalarField<half>;
+template class ScalarField<int16_t>;
+
 }
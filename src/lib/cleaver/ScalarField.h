@@ -40,8 +40,10 @@
 #ifndef SCALARFIELD_H
 #define SCALARFIELD_H
 
+#include <cstdint>
 #include "AbstractScalarField.h"
 #include "BoundingBox.h"
+#include "Half.h"
 #include "vec3.h"
 
 namespace cleaver
@@ -49,6 +51,17 @@ namespace cleaver
 
 enum CenteringType { NodeCentered, CellCentered };
 
+// storage precision of the loaded indicator and sizing fields
+enum FieldPrecision { Float32, Float16, Int16 };
+
+// The eight data indices and trilinear weights of one sample. They depend
+// only on the grid, so fields sharing a grid can reuse a single stencil.
+struct TrilinearStencil
+{
+    int    index[8];
+    double weight[8];
+};
+
 template <typename T>
 class ScalarField : public AbstractScalarField
 {
@@ -60,6 +73,10 @@ public:
 
     virtual double valueAt(const vec3 &x) const;
     virtual double valueAt(double x, double y, double z) const;
+    virtual void valueAt(const vec3 *x, size_t n, double *out) const;
+
+    void stencilAt(double x, double y, double z, TrilinearStencil &stencil) const;
+    double valueAt(const TrilinearStencil &stencil) const;
 
     void setData(T *data);
     T* data() const;
@@ -76,6 +93,16 @@ public:
     void setScale(const vec3 &scale);
     const vec3& scale() const;
 
+    // bumped whenever the centering, bounds or scale change, so callers
+    // caching grid properties can tell their copy is stale
+    unsigned int gridRevision() const;
+
+    // stored values map to value*scale + offset, applied once per
+    // interpolated sample since the map commutes with the weights
+    void setQuantization(double scale, double offset);
+    double quantizationScale() const;
+    double quantizationOffset() const;
+
 private:
 
     CenteringType m_centeringType;
@@ -84,12 +111,18 @@ private:
     BoundingBox m_bounds;           // spatial dimensions
     int m_w, m_h, m_d;              // data dimensions
     T *m_data;                      // data
+    double m_quantScale;            // dequantization scale
+    double m_quantOffset;           // dequantization offset
+    bool m_quantized;
+    unsigned int m_gridRevision;
 
     static CenteringType DefaultCenteringType;
 };
 
 typedef ScalarField<float>  FloatField;
 typedef ScalarField<double> DoubleField;
+typedef ScalarField<half>   HalfField;
+typedef ScalarField<int16_t> Int16Field;
 
 }
 
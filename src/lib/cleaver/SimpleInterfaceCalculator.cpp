@@ -50,7 +50,7 @@ SimpleInterfaceCalculator::SimpleInterfaceCalculator(
     TetMesh *mesh, AbstractVolume *volume) : m_mesh(mesh), m_volume(volume) {}
 
 
-void SimpleInterfaceCalculator::computeCutForEdge(HalfEdge *edge) {
+void SimpleInterfaceCalculator::computeCutForEdge(HalfEdge *edge, unsigned int thread) {
   // order verts
   Vertex *v2 = edge->vertex;
   Vertex *v1 = edge->mate->vertex;
@@ -63,13 +63,13 @@ void SimpleInterfaceCalculator::computeCutForEdge(HalfEdge *edge) {
   if (v1->label == v2->label)
     return;
 
-  Vertex *cut = new Vertex(m_volume->numberOfMaterials());
+  Vertex *cut = m_mesh->createVertex(m_volume->numberOfMaterials(), thread);
   cut->pos() = 0.5*v1->pos() + 0.5*v2->pos();
 
   // doesn't really matter which
   cut->label = v1->label;
-  cut->lbls[v1->label] = true;
-  cut->lbls[v2->label] = true;
+  cut->lbls.set(v1->label);
+  cut->lbls.set(v2->label);
 
   // should never be in violation
   cut->violating = false;
@@ -81,7 +81,7 @@ void SimpleInterfaceCalculator::computeCutForEdge(HalfEdge *edge) {
 }
 
 
-void SimpleInterfaceCalculator::computeTripleForFace(HalfFace *face) {
+void SimpleInterfaceCalculator::computeTripleForFace(HalfFace *face, unsigned int thread) {
   // set as evaluated
   face->evaluated = true;
   if (face->mate)
@@ -102,11 +102,11 @@ void SimpleInterfaceCalculator::computeTripleForFace(HalfFace *face) {
   //-------------------------------------------------------
   // Create the Triple Vertex
   //-------------------------------------------------------
-  Vertex *triple = new Vertex(m_volume->numberOfMaterials());
+  Vertex *triple = m_mesh->createVertex(m_volume->numberOfMaterials(), thread);
   triple->pos() = (1.0 / 3.0)*(v1->pos() + v2->pos() + v3->pos());
-  triple->lbls[v1->label] = true;
-  triple->lbls[v2->label] = true;
-  triple->lbls[v3->label] = true;
+  triple->lbls.set(v1->label);
+  triple->lbls.set(v2->label);
+  triple->lbls.set(v3->label);
   triple->label = std::min(v1->label, v2->label);
   triple->order() = Order::TRIP;
   triple->violating = false;
@@ -117,7 +117,7 @@ void SimpleInterfaceCalculator::computeTripleForFace(HalfFace *face) {
 }
 
 
-void SimpleInterfaceCalculator::computeQuadrupleForTet(Tet *tet) {
+void SimpleInterfaceCalculator::computeQuadrupleForTet(Tet *tet, unsigned int thread) {
   // set as evaluated
   tet->evaluated = true;
 
@@ -133,16 +133,16 @@ void SimpleInterfaceCalculator::computeQuadrupleForTet(Tet *tet) {
       return;
   }
 
-  Vertex *quadruple = new Vertex(m_volume->numberOfMaterials());
+  Vertex *quadruple = m_mesh->createVertex(m_volume->numberOfMaterials(), thread);
   Vertex *v1 = verts[0];
   Vertex *v2 = verts[1];
   Vertex *v3 = verts[2];
   Vertex *v4 = verts[3];
   quadruple->pos() = (1.0 / 4.0)*(v1->pos() + v2->pos() + v3->pos() + v4->pos());
-  quadruple->lbls[v1->label] = true;
-  quadruple->lbls[v2->label] = true;
-  quadruple->lbls[v3->label] = true;
-  quadruple->lbls[v4->label] = true;
+  quadruple->lbls.set(v1->label);
+  quadruple->lbls.set(v2->label);
+  quadruple->lbls.set(v3->label);
+  quadruple->lbls.set(v4->label);
   quadruple->label = std::min(v1->label, v2->label);
   tet->quadruple = quadruple;
   tet->quadruple->violating = false;
@@ -54,6 +54,9 @@
 #include "Octree.h"
 #include "BoundingBox.h"
 #include "Status.h"
+#include "ThreadPool.h"
+
+#include <atomic>
 
 using namespace std;
 
@@ -151,7 +154,7 @@ namespace cleaver
 
   SizingFieldCreator::SizingFieldCreator(const Volume *volume, float lipschitz,
     float samplingRate, float featureScaling, int padding,
-    bool adaptiveSurface, bool verbose) : m_verbose(verbose),
+    bool adaptiveSurface, bool verbose, ThreadPool *pool) : m_verbose(verbose),
     m_lipschitz(lipschitz), m_samplingRate(samplingRate),
     m_featureScaling(featureScaling), mesh_bdry("Boundary"),
     mesh_feature("Feature"), mesh_padded_feature("Padded")
@@ -162,7 +165,7 @@ namespace cleaver
 
     //Variable Declaration
     int i, j, k, l;//,n;
-    int w, h, d, m;
+    int w, h, d;
     double a,x, y, z, discont = 275e-2, xdist = 1, ydist = 1, zdist = 1;
     vector<vector<vector<double> > > mesh_discont;
     int neighbour[6][3] =
@@ -184,7 +187,6 @@ namespace cleaver
     w = (int)(volume->bounds().size.x*m_samplingRate);
     h = (int)(volume->bounds().size.y*m_samplingRate);
     d = (int)(volume->bounds().size.z*m_samplingRate);
-    m = (int)(volume->numberOfMaterials());
 
     fill3DVector(mesh_discont, 0.0, w, h, d);
 
@@ -195,68 +197,83 @@ namespace cleaver
     mesh_bdry.init(w, h, d);
     mesh_feature.init(w, h, d);
 
+    // without a pool, loops run inline on this thread
+    ThreadPool inline_pool(1);
+    ThreadPool &threads = pool ? *pool : inline_pool;
+
+    // threads take whole slices, only the calling thread reports
     Status status(w*d*h);
-    for (k = 0; k < d; k++)
+    std::atomic<size_t> visited(0);
+    threads.parallelFor(0, d, 1, [&](size_t begin, size_t end, unsigned int thread)
     {
-      for (j = 0; j < h; j++)
+      for (int vk = (int)begin; vk < (int)end; vk++)
       {
-        for (i = 0; i < w; i++)
+        std::vector<vec3> row(w);
+        std::vector<int> dom(w);
+        for (int vj = 0; vj < h; vj++)
         {
-          double ii = (double)(i + 0.5) / m_samplingRate;
-          double jj = (double)(j + 0.5) / m_samplingRate;
-          double kk = (double)(k + 0.5) / m_samplingRate;
-          int dom = 0;
-          double max = volume->valueAt(ii, jj, kk, dom);
-          for (int mat = 1; mat < m; mat++)
+          for (int vi = 0; vi < w; vi++)
           {
-            double val = volume->valueAt(ii, jj, kk, mat);
-            if (val > max)
-            {
-              max = val;
-              dom = mat;
-            }
+            double ii = (double)(vi + 0.5) / m_samplingRate;
+            double jj = (double)(vj + 0.5) / m_samplingRate;
+            double kk = (double)(vk + 0.5) / m_samplingRate;
+            row[vi] = vec3(ii, jj, kk);
           }
-          voxel[i][j][k].mat = dom;
-          if (verbose) status.printStatus();
+          // label the whole row at once
+          volume->argmaxAt(&row[0], w, &dom[0]);
+          for (int vi = 0; vi < w; vi++)
+            voxel[vi][vj][vk].mat = dom[vi];
         }
+        size_t done = visited.fetch_add(w*h) + w*h;
+        if (verbose && thread == 0) status.printStatus(done);
       }
-    }
+    });
     if (verbose) status.done();
     if (verbose) std::cout << "Finding boundary vertices..." << std::endl;
     if (verbose) status = Status(w*h*d * 6);
 
     //Find Boundary Vertices
-    for (i = 0; i < w; i++)
+    // each slice only writes its own voxels, and its zeros are
+    // appended in slice order so the list matches a serial sweep
+    std::vector<std::vector<Triple> > slice_zeros(w);
+    visited = 0;
+    threads.parallelFor(0, w, 1, [&](size_t begin, size_t end, unsigned int thread)
     {
-      for (j = 0; j < h; j++)
+      for (int vi = (int)begin; vi < (int)end; vi++)
       {
-        for (k = 0; k < d; k++)
+        for (int vj = 0; vj < h; vj++)
         {
-          //Compare this voxel with its six neighbours
-          for (l = 0; l < 6; l++)
+          for (int vk = 0; vk < d; vk++)
           {
-            int i1, j1, k1;
-            i1 = i + neighbour[l][0];
-            j1 = j + neighbour[l][1];
-            k1 = k + neighbour[l][2];
-
-            QueueIndex temp_q = make_index(i1, j1, k1);
-            if (exists(temp_q, mesh_bdry) && voxel[i][j][k].mat != voxel[i1][j1][k1].mat)
+            //Compare this voxel with its six neighbours
+            for (int n = 0; n < 6; n++)
             {
-              double i_star, j_star, k_star;
-              double dist = Newton(volume, make_triple(i, j, k), make_triple(i1, j1, k1), voxel[i][j][k].mat, voxel[i1][j1][k1].mat, i_star, j_star, k_star);
-
-              zeros.push_back(make_triple(i, j, k));
-              myBdry[i][j][k] = true;
-              foundBdry = true;
-              if (dist < mesh_bdry.getDist(i,j,k))
-                mesh_bdry.setDist(i,j,k,dist);
+              int i1, j1, k1;
+              i1 = vi + neighbour[n][0];
+              j1 = vj + neighbour[n][1];
+              k1 = vk + neighbour[n][2];
+
+              QueueIndex temp_q = make_index(i1, j1, k1);
+              if (exists(temp_q, mesh_bdry) && voxel[vi][vj][vk].mat != voxel[i1][j1][k1].mat)
+              {
+                double i_star, j_star, k_star;
+                double dist = Newton(volume, make_triple(vi, vj, vk), make_triple(i1, j1, k1), voxel[vi][vj][vk].mat, voxel[i1][j1][k1].mat, i_star, j_star, k_star);
+
+                slice_zeros[vi].push_back(make_triple(vi, vj, vk));
+                myBdry[vi][vj][vk] = true;
+                if (dist < mesh_bdry.getDist(vi,vj,vk))
+                  mesh_bdry.setDist(vi,vj,vk,dist);
+              }
             }
-            if (verbose) status.printStatus();
           }
         }
+        size_t done = visited.fetch_add(h*d * 6) + h*d * 6;
+        if (verbose && thread == 0) status.printStatus(done);
       }
-    }
+    });
+    for (i = 0; i < w; i++)
+      zeros.insert(zeros.end(), slice_zeros[i].begin(), slice_zeros[i].end());
+    foundBdry = !zeros.empty();
 
     if (!foundBdry)
     {
@@ -897,10 +914,10 @@ namespace cleaver
 
   double SizingFieldCreator::Fval(const Volume *volume, double x, double y, double z, int mat1, int mat2)
   {
-    double ret;
-    ret = (volume->valueAt((float)x / m_samplingRate, (float)y / m_samplingRate, (float)z / m_samplingRate, mat1) -
-      volume->valueAt((float)x / m_samplingRate, (float)y / m_samplingRate, (float)z / m_samplingRate, mat2));
-    return (ret);
+    const int mats[2] = { mat1, mat2 };
+    double vals[2];
+    volume->valuesAt(vec3((float)x / m_samplingRate, (float)y / m_samplingRate, (float)z / m_samplingRate), mats, 2, vals);
+    return (vals[0] - vals[1]);
   }
 
   double SizingFieldCreator::Gradval(const Volume *volume, double x, double y, double z, int mat1, int mat2, int n)
@@ -1193,7 +1210,8 @@ namespace cleaver
 
   ScalarField<float>* SizingFieldCreator::createSizingFieldFromVolume(
     const Volume *volume, float lipschitz, float samplingRate,
-    float featureScaling, int padding, bool adaptiveSurface, bool verbose)
+    float featureScaling, int padding, bool adaptiveSurface, bool verbose,
+    ThreadPool *pool)
   {
     if (verbose)
       std::cout << "Creating sizing field at " << samplingRate
@@ -1205,7 +1223,7 @@ namespace cleaver
       << std::endl;
 
     SizingFieldCreator fieldCreator(volume, lipschitz, samplingRate,
-      featureScaling, padding, adaptiveSurface, verbose);
+      featureScaling, padding, adaptiveSurface, verbose, pool);
 
     if (verbose)
       std::cout << "Sizing Field Creating! Returning it.." << std::endl;
@@ -58,6 +58,8 @@
 namespace cleaver
 {
 
+class ThreadPool;
+
 class Voxel
 {
     public:
@@ -165,7 +167,8 @@ class SizingFieldCreator
     public:
     SizingFieldCreator(const Volume*, float lipschitz = 1.0f,
       float samplingRate = 2.0f, float featureScaling = 1.0f,
-      int padding = 0, bool adaptiveSurface=true, bool verbose=false);
+      int padding = 0, bool adaptiveSurface=true, bool verbose=false,
+      ThreadPool *pool = nullptr);
     ~SizingFieldCreator();
 
     double valueAt(double x, double y, double z) const;
@@ -184,7 +187,8 @@ class SizingFieldCreator
 
     static ScalarField<float>* createSizingFieldFromVolume(const Volume *volume,
       float lipschitz = 1.0f, float samplingRate = 2.0f, float featureScaling = 1.0f,
-      int m_padding = 0, bool featureSize=true, bool verbose=false);
+      int m_padding = 0, bool featureSize=true, bool verbose=false,
+      ThreadPool *pool = nullptr);
 
     private:
     bool   m_verbose;
@@ -1,14 +1,39 @@
 #include "SizingFieldOracle.h"
 #include <cstdlib>
 #include "ScalarField.h"
+#include "ThreadPool.h"
 
 namespace cleaver
 {
 
-SizingFieldOracle::SizingFieldOracle(const AbstractScalarField *sizingField, const BoundingBox &bounds) :
-    m_sizingField(sizingField), m_bounds(bounds)
+// octree levels adapted serially before the subtrees go to the pool
+static const int kSerialDepth = 2;
+
+// voxel spacing of the sizing field along x, 1 for fields without a grid
+template <typename T>
+static bool voxelScaleOf(const AbstractScalarField *field, float &scale)
+{
+    const ScalarField<T> *grid = dynamic_cast<const ScalarField<T>*>(field);
+    if(grid)
+        scale = (float)grid->scale().x;
+    return grid != nullptr;
+}
+
+static float voxelScale(const AbstractScalarField *field)
+{
+    float scale = 1;
+    if(!voxelScaleOf<float>(field, scale) && !voxelScaleOf<double>(field, scale) &&
+       !voxelScaleOf<half>(field, scale))
+        voxelScaleOf<int16_t>(field, scale);
+    return scale;
+}
+
+SizingFieldOracle::SizingFieldOracle(const AbstractScalarField *sizingField, const BoundingBox &bounds,
+                                     ThreadPool *pool) :
+    m_sizingField(sizingField), m_bounds(bounds), m_pool(pool)
 {
     m_constructionType = Fast;
+    m_voxelScale = sizingField ? voxelScale(sizingField) : 1;
 
     if(sizingField)
         createOctree();
@@ -163,6 +188,7 @@ void SizingFieldOracle::sanityTest2()
 void SizingFieldOracle::setSizingField(const AbstractScalarField *sizingField)
 {
     m_sizingField = sizingField;
+    m_voxelScale = sizingField ? voxelScale(sizingField) : 1;
 }
 
 void SizingFieldOracle::setBoundingBox(const BoundingBox &bounds)
@@ -182,14 +208,60 @@ void SizingFieldOracle::createOctree()
     m_tree = new Octree(m_bounds);
 
     // breadth first creation
-    adaptCell(m_tree->root());
+    if(m_pool && m_pool->threadCount() > 1)
+    {
+        // subtrees below the top levels sample the field independently,
+        // their minimums are gathered up to the root once all are done
+        std::vector<OTCell*> subtrees;
+        adaptCell(m_tree->root(), &subtrees);
+        m_pool->parallelFor(0, subtrees.size(), 1,
+          [&](size_t begin, size_t end, unsigned int)
+        {
+            for(size_t i = begin; i < end; i++)
+                subtrees[i]->minLFS = adaptCell(subtrees[i]);
+        });
+        gatherMinLFS(m_tree->root());
+    }
+    else
+        adaptCell(m_tree->root());
+}
+
+//============================================
+// - gatherMinLFS()
+//
+// Sets the minLFS of the cells above the
+// subtrees deferred by adaptCell().
+//============================================
+double SizingFieldOracle::gatherMinLFS(OTCell *cell, int depth)
+{
+    if(depth == kSerialDepth || !cell->hasChildren())
+        return cell->minLFS;
+
+    double min = 1e10;
+    for(int i=0; i < 8; i++)
+    {
+        cell->children[i]->minLFS = gatherMinLFS(cell->children[i], depth + 1);
+        if(cell->children[i]->minLFS < min)
+            min = cell->children[i]->minLFS;
+    }
+    cell->minLFS = min;
+    return min;
 }
 
 //============================================
 // - adaptCell()
+//
+// If subtrees is given, cells kSerialDepth
+// levels down are collected there instead,
+// for gatherMinLFS() to finish the minimums.
 //============================================
-double SizingFieldOracle::adaptCell(OTCell *cell)
+double SizingFieldOracle::adaptCell(OTCell *cell, std::vector<OTCell*> *subtrees, int depth)
 {
+    if(subtrees && depth == kSerialDepth)
+    {
+        subtrees->push_back(cell);
+        return 1e10;
+    }
 
     BoundingBox domainBounds = m_bounds;
 
@@ -227,10 +299,7 @@ double SizingFieldOracle::adaptCell(OTCell *cell)
                               // This is still problematic, since octree scale will never match non power of 2 scales...
                               // We need to discuss this.
 
-    // TODO:   What happens if sizing field is not a FloatField ??
-    float voxel_scale = (float) ((cleaver::ScalarField<float>*)m_sizingField)->scale().x;
-
-    if(bounds.size.x > voxel_scale)
+    if(bounds.size.x > m_voxelScale)
         cell->subdivide();
 
     double min=1e10;
@@ -238,7 +307,7 @@ double SizingFieldOracle::adaptCell(OTCell *cell)
     {
         for(int i=0; i < 8; i++)
         {
-            cell->children[i]->minLFS = adaptCell(cell->children[i]);
+            cell->children[i]->minLFS = adaptCell(cell->children[i], subtrees, depth + 1);
             if(cell->children[i]->minLFS < min)
                 min = cell->children[i]->minLFS;
         }
@@ -293,7 +362,7 @@ double SizingFieldOracle::adaptCell(OTCell *cell)
             min=1e10;
             for(int i=0; i < 8; i++)
             {
-                cell->children[i]->minLFS = adaptCell(cell->children[i]);
+                cell->children[i]->minLFS = adaptCell(cell->children[i], subtrees, depth + 1);
                 if(cell->children[i]->minLFS < min)
                     min = cell->children[i]->minLFS;
             }
@@ -43,13 +43,18 @@
 #include "ScalarField.h"
 #include "Octree.h"
 
+#include <vector>
+
 namespace cleaver
 {
 
+class ThreadPool;
+
 class SizingFieldOracle
 {
 public:
-    SizingFieldOracle(const AbstractScalarField *sizingField = nullptr, const BoundingBox &bounds = BoundingBox());
+    SizingFieldOracle(const AbstractScalarField *sizingField = nullptr, const BoundingBox &bounds = BoundingBox(),
+                      ThreadPool *pool = nullptr);
 
     void setSizingField(const AbstractScalarField *sizingField);
     void setBoundingBox(const BoundingBox &bounds);
@@ -64,15 +69,18 @@ protected:
     void sanityTest1(); // test for self-consistency
     void sanityTest2(); // test against sizing field
 
-    double adaptCell(OTCell *cell);
+    double adaptCell(OTCell *cell, std::vector<OTCell*> *subtrees = nullptr, int depth = 0);
+    double gatherMinLFS(OTCell *cell, int depth = 0);
     void printTree(OTCell *myCell, int n);
 
 
     const AbstractScalarField *m_sizingField;
+    float                m_voxelScale;
     BoundingBox          m_bounds;
     Octree              *m_tree;
 
     ConstructionType m_constructionType;
+    ThreadPool      *m_pool;
 };
 
 }
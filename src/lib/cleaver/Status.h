@@ -27,6 +27,11 @@ class Status {
       }
       count_++;
     }
+    // jump to count items done, e.g. as tallied by several threads
+    void printStatus(size_t count) {
+      count_ = int(count);
+      printStatus();
+    }
     void done() { printf("\n"); percent_ = 0; count_ = 0;}
   private:
     double total_;
@@ -40,6 +40,7 @@
 //-------------------------------------------------------------------
 
 #include "TetMesh.h"
+#include "CompactTetMesh.h"
 #include "BoundingBox.h"
 
 #include <iostream>
@@ -55,7 +56,6 @@
 #include <stdint.h>
 #include <jsoncpp/json.h>
 #include "Util.h"
-#include "Matlab.h"
 #include "Status.h"
 
 
@@ -103,23 +103,22 @@ namespace cleaver
   }
 
   TetMesh::~TetMesh() {
-    // Delete of half edges in map of vert pairs
-    for (auto & x : halfEdges)
-    {
-      x.second->halfFaces.clear();
-      delete x.second;
-    }
+    // half edges are owned and released by the halfEdges table
+    halfEdges.clear();
 
     // delete tets verts, faces, etc
+    // pooled verts and tets are released with their pools
     for (size_t f = 0; f < faces.size(); f++) {
       delete faces[f];
     }
 
     for (size_t v = 0; v < verts.size(); v++) {
-      delete verts[v];
+      if (!ownsVertex(verts[v]))
+        delete verts[v];
     }
     for (size_t t = 0; t < tets.size(); t++) {
-      delete tets[t];
+      if (!m_tetPool.owns(tets[t]))
+        delete tets[t];
     }
 
     verts.clear();
@@ -211,21 +210,6 @@ namespace cleaver
   //}
 
 
-  static float INTERFACE_COLORS[12][3] = {
-    {141/255.0f, 211/255.0f, 199/255.0f},
-    {255/255.0f, 255/255.0f, 179/255.0f},
-    {190/255.0f, 186/255.0f, 218/255.0f},
-    {251/255.0f, 128/255.0f, 114/255.0f},
-    {128/255.0f, 177/255.0f, 211/255.0f},
-    {253/255.0f, 180/255.0f, 98/255.0f},
-    {179/255.0f, 222/255.0f, 105/255.0f},
-    {252/255.0f, 205/255.0f, 229/255.0f},
-    {217/255.0f, 217/255.0f, 217/255.0f},
-    {188/255.0f, 128/255.0f, 189/255.0f},
-    {204/255.0f, 235/255.0f, 197/255.0f}
-  };
-
-
   //===================================================
   // writeStencilPly()
   //  This is a debugging function that creates a mesh
@@ -310,24 +294,6 @@ namespace cleaver
     file.close();
   }
 
-  //===================================================
-  // vec3 comparator
-  //
-  //===================================================
-  class vec3_compare {
-    public:
-      bool operator()(const vec3 &a, const vec3 &b) const {
-        if ((a.x < b.x) && (b.x - a.x) > 1e-9) return true;
-        else if ((a.x > b.x) && (a.x - b.x) > 1e-9) return false;
-        if ((a.y < b.y) && (b.y - a.y) > 1e-9) return true;
-        else if ((a.y > b.y) && (a.y - b.y) > 1e-9) return false;
-        if ((a.z < b.z) && (b.z - a.z) > 1e-9) return true;
-        else if ((a.z > b.z) && (a.z - b.z) > 1e-9) return false;
-        return false;
-      }
-  };
-  typedef std::map< const vec3, size_t, vec3_compare > VertMap;
-
   //===================================================
   // writePly()
   //
@@ -336,140 +302,7 @@ namespace cleaver
   //===================================================
   void TetMesh::writePly(const std::string &filename, bool verbose)
   {
-    //-----------------------------------
-    //           Initialize
-    //-----------------------------------
-    if(verbose)
-      cout << "Writing mesh ply file: " << filename + ".ply" << endl;
-    ofstream file((filename + ".ply").c_str());
-
-    std::vector<size_t> interfaces;
-    std::vector<size_t> colors;
-    std::vector<size_t> keys;
-
-    // determine output faces and vertices vertex counts
-    for(size_t f=0; f < faces.size(); f++)
-    {
-      const int t1_index = static_cast<int>(faces[f]->tets[0]);
-      const int t2_index = static_cast<int>(faces[f]->tets[1]);
-
-      if(t1_index < 0 || t2_index < 0){
-        continue;
-      }
-
-      Tet *t1 = this->tets[t1_index];
-      Tet *t2 = this->tets[t2_index];
-
-      if(t1->mat_label != t2->mat_label)
-      {
-        interfaces.push_back(f);
-
-        const int color_key = (1 << (int)t1->mat_label) + (1 << (int)t2->mat_label);
-        int color_index = -1;
-        for(size_t k=0; k < keys.size(); k++)
-        {
-          if(keys[k] == color_key){
-            color_index = static_cast<int>(k);
-            break;
-          }
-        }
-        if(color_index == -1)
-        {
-          keys.push_back(color_key);
-          color_index = static_cast<int>(keys.size() - 1);
-        }
-
-        colors.push_back(color_index);
-      }
-    }
-
-    //-----------------------------------
-    //           Write Header
-    //-----------------------------------
-    file << "ply" << endl;
-    file << "format ascii 1.0" << endl;
-
-    //-----------------------------------
-    //         Create Pruned Vertex List
-    //-----------------------------------
-    VertMap vert_map;
-    std::vector<vec3> pruned_verts;
-    size_t pruned_pos = 0;
-    for(int f=0; f < interfaces.size(); f++)
-    {
-      Face *face = faces[interfaces[f]];
-
-      Vertex *v1 = this->verts[face->verts[0]];
-      Vertex *v2 = this->verts[face->verts[1]];
-      Vertex *v3 = this->verts[face->verts[2]];
-
-      vec3 p1 = v1->pos();
-      vec3 p2 = v2->pos();
-      vec3 p3 = v3->pos();
-
-      if (!vert_map.count(p1)) {
-        vert_map.insert(std::pair<vec3,size_t>(p1,pruned_pos));
-        pruned_pos++;
-        pruned_verts.push_back(p1);
-      }
-      if (!vert_map.count(p2)) {
-        vert_map.insert(std::pair<vec3,size_t>(p2,pruned_pos));
-        pruned_pos++;
-        pruned_verts.push_back(p2);
-      }
-      if (!vert_map.count(p3)) {
-        vert_map.insert(std::pair<vec3,size_t>(p3,pruned_pos));
-        pruned_pos++;
-        pruned_verts.push_back(p3);
-      }
-    }
-    file << "element vertex " << pruned_verts.size() << endl;
-    file << "property float x " << endl;
-    file << "property float y " << endl;
-    file << "property float z " << endl;
-    file << "element face " << interfaces.size() << endl;
-    file << "property list uchar int vertex_index" << endl;
-    file << "property uchar red" << endl;
-    file << "property uchar green" << endl;
-    file << "property uchar blue" << endl;
-    file << "end_header" << endl;
-
-    //-----------------------------------
-    //         Write Vertex List
-    //-----------------------------------
-    for(std::vector<vec3>::iterator it = pruned_verts.begin();
-        it != pruned_verts.end(); ++it) {
-      file << it->x << " " << it->y << " " << it->z << std::endl;
-    }
-
-    //-----------------------------------
-    //         Write Face List
-    //-----------------------------------
-    for(int f=0; f < interfaces.size(); f++)
-    {
-      //Face &face = faces[interfaces[f]];
-
-      Face *face = faces[interfaces[f]];
-
-      Vertex *v1 = this->verts[face->verts[0]];
-      Vertex *v2 = this->verts[face->verts[1]];
-      Vertex *v3 = this->verts[face->verts[2]];
-      size_t i1 = vert_map.find(v1->pos())->second;
-      size_t i2 = vert_map.find(v2->pos())->second;
-      size_t i3 = vert_map.find(v3->pos())->second;
-      // output 3 vertices
-      file << "3 " << i1 << " " << i2 << " " << i3 << " ";
-
-      // output 3 color components
-      file << (int)(255*INTERFACE_COLORS[colors[f]%12][0]) << " ";
-      file << (int)(255*INTERFACE_COLORS[colors[f]%12][1]) << " ";
-      file << (int)(255*INTERFACE_COLORS[colors[f]%12][2]) << endl;
-    }
-
-    //-----------------------------------
-    //          Close  File
-    //-----------------------------------
-    file.close();
+    CompactTetMesh(*this).writePly(filename, verbose);
   }
 
   std::pair<int,int> keyToPair(unsigned int key)
@@ -644,71 +477,7 @@ namespace cleaver
   //===================================================
   void TetMesh::writeNodeEle(const string &filename, bool verbose, bool include_materials, bool include_parents)
   {
-    //-----------------------------------
-    //  Determine Attributes to Include
-    //-----------------------------------
-    int attribute_count = 0;
-    if(include_materials)
-      attribute_count++;
-    if(include_parents)
-      attribute_count++;
-
-
-    //-----------------------------------
-    //         Write Node File
-    //-----------------------------------
-    string node_filename = filename + ".node";
-    if(verbose)
-      cout << "Writing mesh node file: " << node_filename << endl;
-    ofstream node_file(node_filename.c_str());
-
-    //---------------------------------------------------------------------------------------------------------
-    //  First line: <# of points> <dimension (must be 3)> <# of attributes> <# of boundary markers (0 or 1)>
-    //---------------------------------------------------------------------------------------------------------
-    node_file << "# Node count, 3 dim, no attributes, no boundary markers" << endl;
-    node_file << this->verts.size() << " 3  0  0" << endl << endl;
-
-    //-------------------------------------------------------------------------------------------
-    //  Remaining lines list # of points:  <point #> <x> <y> <z> [attributes] [boundary marker]
-    //-------------------------------------------------------------------------------------------
-    for(size_t i=0; i < this->verts.size(); i++)
-    {
-      node_file << i+1 << " " << this->verts[i]->pos().x << " " << this->verts[i]->pos().y << " " << this->verts[i]->pos().z << endl;
-    }
-
-    node_file.close();
-
-
-    //-----------------------------------
-    //        Write Element File
-    //-----------------------------------
-    string elem_filename = filename + ".ele";
-    if(verbose)
-      cout << "Writing mesh ele file: " << elem_filename << endl;
-    ofstream elem_file(elem_filename.c_str());
-
-    //---------------------------------------------------------------------------
-    //  First line: <# of tetrahedra> <nodes per tetrahedron> <# of attributes>
-    //--------------------------------------------------------------------------
-    elem_file << "# Tet count, verts per tet, attribute count" << endl;
-    elem_file << this->tets.size() << " 4 " << attribute_count << endl << endl;
-
-    //-----------------------------------------------------------------------------------------------------------
-    //  Remaining lines list of # of tetrahedra:  <tetrahedron #> <node> <node> <node> <node> ... [attributes]
-    //-----------------------------------------------------------------------------------------------------------
-    for(size_t i=0; i < this->tets.size(); i++)
-    {
-      elem_file << i+1;
-      for(int v=0; v < 4; v++)
-        elem_file << " " << this->tets[i]->verts[v]->tm_v_index + 1;
-      if(include_materials)
-        elem_file << " " << this->tets[i]->mat_label + 1;
-      if(include_parents)
-        elem_file << " " << this->tets[i]->parent + 1;
-      elem_file << endl;
-    }
-
-    elem_file.close();
+    CompactTetMesh(*this).writeNodeEle(filename, verbose, include_materials, include_parents);
   }
 
 
@@ -720,81 +489,103 @@ namespace cleaver
   //===================================================
   void TetMesh::writePtsEle(const std::string &filename, bool verbose)
   {
-    //-----------------------------------
-    //         Create Pts File
-    //-----------------------------------
-    string pts_filename = filename + ".pts";
-    if(verbose)
-      cout << "Writing mesh pts file: " << pts_filename << endl;
-    ofstream pts_file(pts_filename.c_str());
+    CompactTetMesh(*this).writePtsEle(filename, verbose);
+  }
 
-    //-------------------------------------------------------------------------------------------
-    //  Write each line of file <x> <y> <z>
-    //-------------------------------------------------------------------------------------------
-    for(size_t i=0; i < this->verts.size(); i++)
-    {
-      pts_file << this->verts[i]->pos().x << " " << this->verts[i]->pos().y << " " << this->verts[i]->pos().z << endl;
-    }
-    pts_file.close();
 
+  //  If create is set to false, no vertex is created if one is missing
+  //-----------------------------------------------------------------------------------
+  HalfEdge* TetMesh::halfEdgeForVerts(Vertex *v1, Vertex *v2)
+  {
+    // create new one if necessary, or return existing one
+    HalfEdge *half_edge = halfEdges.findOrCreate(v1->tm_v_index, v2->tm_v_index, v1->dual && v2->dual);
 
-    //-----------------------------------
-    //        Create Element File
-    //-----------------------------------
-    string elem_filename = filename + ".elem";
-    if(verbose)
-      cout << "Writing mesh elem file: " << elem_filename << endl;
-    ofstream elem_file(elem_filename.c_str());
+    return half_edge;
+  }
 
+  namespace {
+    struct FaceKey {
+      uint64_t verts;    // two smallest vertex indices
+      uint64_t slot;     // largest vertex index, then 4*tet + face
 
-    //-----------------------------------------------------------------------------------------------------------
-    //  Write each line <node> <node> <node> <node>
-    //-----------------------------------------------------------------------------------------------------------
-    for(size_t i=0; i < this->tets.size(); i++)
-    {
-      elem_file << this->tets[i]->verts[0]->tm_v_index + 1 << " ";
-      elem_file << this->tets[i]->verts[1]->tm_v_index + 1 << " ";
-      elem_file << this->tets[i]->verts[2]->tm_v_index + 1 << " ";
-      elem_file << this->tets[i]->verts[3]->tm_v_index + 1 << endl;
-    }
-    elem_file.close();
+      uint32_t last() const { return static_cast<uint32_t>(slot >> 32); }
+      uint32_t tetFace() const { return static_cast<uint32_t>(slot); }
+      bool sameFace(const FaceKey &other) const {
+        return verts == other.verts && last() == other.last();
+      }
+      bool operator<(const FaceKey &other) const {
+        return verts < other.verts || (verts == other.verts && slot < other.slot);
+      }
+    };
+  }
 
-    //-----------------------------------
-    //        Create Material File
-    //-----------------------------------
-    string mat_filename = filename + ".txt";
-    cout << "Writing mesh material file: " << mat_filename << endl;
-    ofstream mat_file(mat_filename.c_str());
-    for(size_t i=0; i < this->tets.size(); i++)
+  //------------------------------------------------------
+  // - constructTetAdjacency()
+  //
+  // Fills in any missing tet->tets[] links. Every face is
+  // keyed by its sorted vertex indices, the keys are sorted,
+  // and tets holding equal keys are neighbors. Keys for each
+  // tet are independent, and ties are broken by tet and face
+  // index, so the result does not depend on tet ordering
+  // within each vertex's tet list.
+  //------------------------------------------------------
+  bool TetMesh::constructTetAdjacency()
+  {
+    std::vector<FaceKey> keys(FACES_PER_TET*tets.size());
+    for(size_t i=0; i < tets.size(); i++)
     {
-      mat_file << this->tets[i]->mat_label + 1 << endl;
-    }
-    mat_file.close();
-  }
+      for(int f=0; f < FACES_PER_TET; f++)
+      {
+        uint32_t v0 = static_cast<uint32_t>(tets[i]->verts[(f+1) % FACES_PER_TET]->tm_v_index);
+        uint32_t v1 = static_cast<uint32_t>(tets[i]->verts[(f+2) % FACES_PER_TET]->tm_v_index);
+        uint32_t v2 = static_cast<uint32_t>(tets[i]->verts[(f+3) % FACES_PER_TET]->tm_v_index);
 
+        // make sure the 3 vertices are unique
+        if(v0 == v1 || v1 == v2 || v2 == v0)
+        {
+          std::cout << "Degenerate Tet found while building adjacency. Terminating." << std::endl;
+          exit(-7);
+        }
 
-  //  If create is set to false, no vertex is created if one is missing
-  //-----------------------------------------------------------------------------------
-  HalfEdge* TetMesh::halfEdgeForVerts(Vertex *v1, Vertex *v2)
-  {
-    std::pair<int,int> key = std::make_pair(v1->tm_v_index,v2->tm_v_index);
-    std::map<std::pair<int,int>, HalfEdge*>::iterator res = halfEdges.find(key);
-    HalfEdge *half_edge = nullptr;
+        if(v0 > v1) std::swap(v0, v1);
+        if(v1 > v2) std::swap(v1, v2);
+        if(v0 > v1) std::swap(v0, v1);
 
-    // create new one if necessary
-    if (res == halfEdges.end())
-    {
-      half_edge = new HalfEdge(v1->dual && v2->dual);
-      halfEdges[key] = half_edge;
+        FaceKey &key = keys[FACES_PER_TET*i + f];
+        key.verts = (static_cast<uint64_t>(v0) << 32) | v1;
+        key.slot  = (static_cast<uint64_t>(v2) << 32) | static_cast<uint32_t>(FACES_PER_TET*i + f);
+      }
     }
-    // or return existing one
-    else
+
+    std::sort(keys.begin(), keys.end());
+
+    bool manifold = true;
+    for(size_t k=0; k < keys.size(); )
     {
-      half_edge = res->second;
-    }
+      size_t end = k + 1;
+      while(end < keys.size() && keys[end].sameFace(keys[k]))
+        end++;
 
+      if(end - k > 2)
+        manifold = false;
 
-    return half_edge;
+      if(end - k >= 2)
+      {
+        Tet *t0 = tets[keys[k].tetFace() / FACES_PER_TET];
+        Tet *t1 = tets[keys[k+1].tetFace() / FACES_PER_TET];
+        int  f0 = keys[k].tetFace() % FACES_PER_TET;
+        int  f1 = keys[k+1].tetFace() % FACES_PER_TET;
+
+        if(t0->tets[f0] == nullptr)
+          t0->tets[f0] = t1;
+        if(t1->tets[f1] == nullptr)
+          t1->tets[f1] = t0;
+      }
+
+      k = end;
+    }
+
+    return manifold;
   }
 
   void TetMesh::constructFaces()
@@ -822,137 +613,30 @@ namespace cleaver
       }
     }
 
-    bool valid = isValid();
-
     //-----------------------------------
     // Obtain Tet-Tet Adjacency
     //-----------------------------------
-    int nFaces = 0;
+    if(!constructTetAdjacency())
+    {
+      std::cout << "overwriting a tet!! Aborting." << std::endl;
+      //where Cleaver exits when padding is included
+      exit(0);
+    }
+
+    // one face per boundary side, plus one per shared pair
+    int nBoundary = 0;
+    int nShared = 0;
     for(size_t i=0; i < this->tets.size(); i++)
     {
-      // look for a tet sharing three verts opposite vert[j]
       for (int f=0; f < FACES_PER_TET; f++)
       {
-        // if information for adjacent tet is null, attempt to fill it in
         if (this->tets[i]->tets[f] == nullptr)
-        {
-          // first grab the three vertices corresponding to the face[f] opposite vertex j
-          Vertex *v0 = this->tets[i]->verts[(f+1) % FACES_PER_TET];
-          Vertex *v1 = this->tets[i]->verts[(f+2) % FACES_PER_TET];
-          Vertex *v2 = this->tets[i]->verts[(f+3) % FACES_PER_TET];
-          bool found_adjacent = false;
-
-          // make sure the 3 vertices are unique
-          if(v0 == v1 || v1 == v2 || v2 == v0)
-          {
-            std::cout << "Degenerate Tet found while building adjacency. Terminating." << std::endl;
-            exit(-7);
-          }
-
-          // search over adjacent tets touching these verts
-          for (size_t j=0; j < v0->tets.size(); j++)
-          {
-            Tet *tet = v0->tets[j];
-            if(tet == nullptr){
-              std::cout << "PROBLEM! nullptr TET" << std::endl;
-            }
-
-            // Skip self
-            if(tet == this->tets[i])
-              continue;
-
-
-            // check if it is adjacent, i.e. has v1 and v2
-            int shared_count = 0;
-            for (int l=0; l < 4; l++){
-              if (tet->verts[l] == v1 || tet->verts[l] == v2 || tet->verts[l] == v0)
-                shared_count++;
-            }
-
-            // Sanity check (To remove later for optimization)
-            if(shared_count == 4){
-              std::cout << "HUGE PROBLEM building adjacency. Two tets share all four faces!!" << std::endl;
-              exit(9);
-            }
-
-            // if match found
-            if (shared_count == 3)
-            {
-              // new shared face found
-              found_adjacent = true;
-              nFaces++;
-
-              //--------------------
-              //  set for this tet
-              //--------------------
-              this->tets[i]->tets[f] = tet;
-
-
-              //----------------------
-              // set for neighbor tet
-              //----------------------
-              for (int m=0; m<4; m++){  // J.R.B. 3/25/13  (changed index to m=0 to 4, was previously m=1 to 4, why?
-
-                // If we find it
-                if(tet->verts[m] != v0 && tet->verts[m] != v1 && tet->verts[m] != v2)
-                {
-                  // make sure we're not overwriting a value that's already written
-                  if(tet->tets[m] != nullptr)
-                  {
-                    if(tet->tets[m] == this->tets[i])
-                      std::cout << "ALREADY SET! We're Actually SAFE" << std::endl;
-                    else
-                    {
-                      Tet *tet1 = this->tets[i];
-                      Tet *tet2 = tet;
-                      Tet *tet3 = tet->tets[m];
-
-                      std::cout << "overwriting a tet!! Aborting." << std::endl;
-                      std::cout << "The three tets that share this face are: " << std::endl;
-                      std::cout << "Tet1 (" << tet1 << "): {"
-                        << "v1(" << (int)tet1->verts[0]->order() << "), "
-                        << "v2(" << (int)tet1->verts[1]->order() << "), "
-                        << "v3(" << (int)tet1->verts[2]->order() << "), "
-                        << "v4(" << (int)tet1->verts[3]->order() << ")} "
-                        << " parent = " << tet1->parent
-                        << std::endl;
-                      std::cout << "Tet2 (" << tet2 << "): {"
-                        << "v1(" << (int)tet2->verts[0]->order() << "), "
-                        << "v2(" << (int)tet2->verts[1]->order() << "), "
-                        << "v3(" << (int)tet2->verts[2]->order() << "), "
-                        << "v4(" << (int)tet2->verts[3]->order() << ")}"
-                        << " parent = " << tet2->parent
-                        << std::endl;
-                      std::cout << "Tet3 (" << tet3 << "): "
-                        << "v1(" << (int)tet3->verts[0]->order() << "), "
-                        << "v2(" << (int)tet3->verts[1]->order() << "), "
-                        << "v3(" << (int)tet3->verts[2]->order() << "), "
-                        << "v4(" << (int)tet3->verts[3]->order() << ")}"
-                        << " parent = " << tet3->parent
-                        << std::endl;
-					  //where Cleaver exits when padding is included
-                      exit(0);
-                    }
-                  }
-
-                  // set it
-                  tet->tets[m] = this->tets[i];
-                  break;
-                }
-              }
-
-              // done searching adjacent tets
-              break;
-            }
-          }
-
-          //if there is no face, this is a border face, up the face count
-          if (!found_adjacent) {
-            nFaces++;
-          }
-        }
+          nBoundary++;
+        else
+          nShared++;
       }
     }
+    int nFaces = nBoundary + nShared/2;
 
     //----------------------------
     //  Allocate and Fill Faces
@@ -1200,273 +884,25 @@ namespace cleaver
   //
   // Public method to write mesh to file using desired
   // mesh format. The appropriate file writer is called.
+  // With RCMOrder, the written copy is renumbered to
+  // reduce bandwidth; this mesh is left untouched.
   //============================================================
-  void TetMesh::writeMesh(const std::string &filename, MeshFormat format, bool verbose)
+  void TetMesh::writeMesh(const std::string &filename, MeshFormat format, bool verbose, MeshOrdering ordering)
   {
-
-    switch(format) {
-    case cleaver::Tetgen:
-      writeNodeEle(filename, verbose);
-      break;
-    case cleaver::Scirun:
-      writePtsEle(filename, verbose);
-      break;
-    case cleaver::Matlab:
-      writeMatlab(filename, verbose);
-      break;
-    case  cleaver::VtkUSG:
-      writeVtkUnstructuredGrid(filename, verbose);
-      break;
-    case  cleaver::VtkPoly:
-      writeVtkPolyData(filename, verbose);
-      break;
-    case  cleaver::PLY:
-      writePly(filename, verbose);
-      break;
-    default: {
-               std::cerr << "Unsupported Mesh Format. " << std::endl;
-               break;
-             }
-    }
+    CompactTetMesh compact(*this);
+    if(ordering == RCMOrder)
+      compact.reorderRCM(verbose);
+    compact.writeMesh(filename, format, verbose);
   }
 
   void TetMesh::writeVtkPolyData(const std::string &filename, bool verbose)
   {
-    std::string path = filename.substr(0,filename.find_last_of("/")+1);
-    std::string name = filename.substr(filename.find_last_of("/")+1,filename.size() - 1);
-    if (path.empty()) {
-      char cCurrentPath[FILENAME_MAX];
-      if(GetCurrentDir(cCurrentPath, sizeof(cCurrentPath))){}
-      cCurrentPath[sizeof(cCurrentPath) - 1] = '\0';
-      path = std::string(cCurrentPath) + "/";
-    }
-    // get the number of files/mats
-    std::vector<std::ofstream*> output;
-    std::vector<size_t> numTetsPerMat;
-    for(size_t i = 0; i < this->tets.size(); i++) {
-      size_t label = tets.at(i)->mat_label;
-      if (label + 1 > numTetsPerMat.size())
-        numTetsPerMat.resize(label+1);
-      numTetsPerMat.at(label)++;
-    }
-    size_t num = 0;
-    std::vector<std::string> filenames;
-    while (numTetsPerMat.size() != filenames.size()) {
-      std::stringstream ss;
-      ss << path << name << num++ << ".vtk" ;
-      filenames.push_back(ss.str());
-      std::cout << "\t" << ss.str() << std:: endl;
-    }
-    if(verbose) {
-      std::cout << "Writing VTK mesh files(tets): \n";
-      for(size_t i = 0; i < filenames.size(); i++)
-        std::cout << "\t" << filenames.at(i) << std::endl;
-    }
-    //-----------------------------------
-    //         Create Pruned Vertex List
-    //-----------------------------------
-    std::vector<VertMap> vert_maps;
-    vert_maps.resize(numTetsPerMat.size());
-    std::vector<std::vector<vec3> > pruned_verts;
-    pruned_verts.resize(numTetsPerMat.size());
-    std::vector<size_t> pruned_pos;
-    pruned_pos.resize(numTetsPerMat.size());
-    for(size_t i = 0; i < numTetsPerMat.size();i++)
-      pruned_pos[i] = 0;
-    for(size_t t=0; t < this->tets.size(); t++) {
-      Tet* tet = this->tets[t];
-      size_t label = tet->mat_label;
-
-      Vertex *v1 = tet->verts[0];
-      Vertex *v2 = tet->verts[1];
-      Vertex *v3 = tet->verts[2];
-      Vertex *v4 = tet->verts[3];
-
-      vec3 p1 = v1->pos();
-      vec3 p2 = v2->pos();
-      vec3 p3 = v3->pos();
-      vec3 p4 = v4->pos();
-
-      if (!vert_maps[label].count(p1)) {
-        vert_maps[label].insert(std::pair<vec3,size_t>(p1,pruned_pos[label]));
-        pruned_pos[label]++;
-        pruned_verts[label].push_back(p1);
-      }
-      if (!vert_maps[label].count(p2)) {
-        vert_maps[label].insert(std::pair<vec3,size_t>(p2,pruned_pos[label]));
-        pruned_pos[label]++;
-        pruned_verts[label].push_back(p2);
-      }
-      if (!vert_maps[label].count(p3)) {
-        vert_maps[label].insert(std::pair<vec3,size_t>(p3,pruned_pos[label]));
-        pruned_pos[label]++;
-        pruned_verts[label].push_back(p3);
-      }
-      if (!vert_maps[label].count(p4)) {
-        vert_maps[label].insert(std::pair<vec3,size_t>(p4,pruned_pos[label]));
-        pruned_pos[label]++;
-        pruned_verts[label].push_back(p4);
-      }
-    }
-    //-----------------------------------
-    //         Write Headers
-    //-----------------------------------
-    for(size_t i=0; i < numTetsPerMat.size(); i++) {
-      output.push_back(new std::ofstream(filenames.at(i).c_str()));
-      *output.at(i) << "# vtk DataFile Version 2.0\n";
-      *output.at(i) << filenames.at(i) << " Tet Mesh\n";
-      *output.at(i) << "ASCII\n";
-      *output.at(i) << "DATASET POLYDATA\n";
-      *output.at(i) << "POINTS " << pruned_verts[i].size() << " float\n";
-    }
-    //-----------------------------------
-    //         Write Vertex List
-    //-----------------------------------
-    for(size_t f=0; f < numTetsPerMat.size(); f++) {
-      for(size_t i=0; i < pruned_verts[f].size(); i++)
-      {
-        *output.at(f) << pruned_verts[f][i].x << " "
-          << pruned_verts[f][i].y << " "
-          << pruned_verts[f][i].z << std::endl;
-      }
-      size_t num_tets = numTetsPerMat.at(f);
-      *output.at(f) << "POLYGONS " << num_tets*4 << " "
-        << (num_tets*16) <<"\n";
-    }
-    //-----------------------------------
-    //         Write Cell/Face List
-    //-----------------------------------
-    for(size_t f=0; f < this->tets.size(); f++)
-    {
-      Tet* t = this->tets.at(f);
-
-      Vertex *v1 = t->verts[0];
-      Vertex *v2 = t->verts[1];
-      Vertex *v3 = t->verts[2];
-      Vertex *v4 = t->verts[3];
-      size_t i1 = vert_maps[t->mat_label].find(v1->pos())->second;
-      size_t i2 = vert_maps[t->mat_label].find(v2->pos())->second;
-      size_t i3 = vert_maps[t->mat_label].find(v3->pos())->second;
-      size_t i4 = vert_maps[t->mat_label].find(v4->pos())->second;
-
-      *output.at(t->mat_label) << 3 << " " << i1 <<  " " << i2 << " " << i3 << "\n";
-      *output.at(t->mat_label) << 3 << " " << i2 <<  " " << i3 << " " << i4 << "\n";
-      *output.at(t->mat_label) << 3 << " " << i3 <<  " " << i4 << " " << i1 << "\n";
-      *output.at(t->mat_label) << 3 << " " << i4 <<  " " << i1 << " " << i2 << "\n";
-    }
-    //CLOSE
-    for(size_t i=0; i < numTetsPerMat.size(); i++) {
-      (*output.at(i)).close();
-      delete output.at(i);
-    }
+    CompactTetMesh(*this).writeVtkPolyData(filename, verbose);
   }
 
   void TetMesh::writeVtkUnstructuredGrid(const std::string &filename, bool verbose)
   {
-    std::string filepath = filename + ".vtk";
-    std::ofstream output(filepath.c_str(), std::ios::out | std::ios::binary);
-    if(verbose)
-      std::cout << "Writing mesh vtk file: " << filepath << std::endl;
-    //-----------------------------------
-    //         Create Pruned Vertex List
-    //-----------------------------------
-    VertMap vert_map;
-    std::vector<vec3> pruned_verts;
-    size_t pruned_pos = 0;
-    for(size_t t=0; t < this->tets.size(); t++) {
-      Tet* tet = this->tets[t];
-
-      Vertex *v1 = tet->verts[0];
-      Vertex *v2 = tet->verts[1];
-      Vertex *v3 = tet->verts[2];
-      Vertex *v4 = tet->verts[3];
-
-      vec3 p1 = v1->pos();
-      vec3 p2 = v2->pos();
-      vec3 p3 = v3->pos();
-      vec3 p4 = v4->pos();
-
-      if (!vert_map.count(p1)) {
-        vert_map.insert(std::pair<vec3,size_t>(p1,pruned_pos));
-        pruned_pos++;
-        pruned_verts.push_back(p1);
-      }
-      if (!vert_map.count(p2)) {
-        vert_map.insert(std::pair<vec3,size_t>(p2,pruned_pos));
-        pruned_pos++;
-        pruned_verts.push_back(p2);
-      }
-      if (!vert_map.count(p3)) {
-        vert_map.insert(std::pair<vec3,size_t>(p3,pruned_pos));
-        pruned_pos++;
-        pruned_verts.push_back(p3);
-      }
-      if (!vert_map.count(p4)) {
-        vert_map.insert(std::pair<vec3,size_t>(p4,pruned_pos));
-        pruned_pos++;
-        pruned_verts.push_back(p4);
-      }
-    }
-
-    //-----------------------------------
-    //         Write Header
-    //-----------------------------------
-    output << "# vtk DataFile Version 2.0\n";
-    output << filepath << " Tet Mesh\n";
-    output << "ASCII\n";
-    output << "DATASET UNSTRUCTURED_GRID\n";
-    output << "POINTS " << pruned_verts.size() << " float\n";
-    //-----------------------------------
-    //         Write Vertex List
-    //-----------------------------------
-    for(size_t i=0; i < pruned_verts.size(); i++)
-    {
-      output << pruned_verts[i].x << " "
-        << pruned_verts[i].y << " "
-        << pruned_verts[i].z << std::endl;
-    }
-
-    //-----------------------------------
-    //         Write Cell/Face List
-    //-----------------------------------
-    // \todo make writing background optional
-    output << "CELLS " << this->tets.size() << " " << this->tets.size()*5 << "\n";
-    for(size_t f=0; f < this->tets.size(); f++)
-    {
-      Tet* t = this->tets.at(f);
-
-      Vertex* v1 = t->verts[0];
-      Vertex* v2 = t->verts[1];
-      Vertex* v3 = t->verts[2];
-      Vertex* v4 = t->verts[3];
-      size_t i1 = vert_map.find(v1->pos())->second;
-      size_t i2 = vert_map.find(v2->pos())->second;
-      size_t i3 = vert_map.find(v3->pos())->second;
-      size_t i4 = vert_map.find(v4->pos())->second;
-      output << 4 << " " << i1 <<  " " << i2 << " " << i3 << " " << i4 << "\n";
-    }
-
-    output << "CELL_TYPES " << this->tets.size() << "\n";
-    for(size_t f=0; f < this->tets.size(); f++)
-    {
-      Tet* t = this->tets.at(f);
-      output << 10 << "\n";
-    }
-
-    //-----------------------------------
-    //         Write Labels
-    //-----------------------------------
-    output << "CELL_DATA " << this->tets.size() << "\n";
-    output << "SCALARS labels int 1\n";
-    output << "LOOKUP_TABLE default\n";
-    for(size_t f=0; f < this->tets.size(); f++)
-    {
-      Tet* t = this->tets.at(f);
-      output << (int)t->mat_label << "\n";
-    }
-
-    //CLOSE
-    output.close();
+    CompactTetMesh(*this).writeVtkUnstructuredGrid(filename, verbose);
   }
 
   //==================================================================
@@ -1477,420 +913,54 @@ namespace cleaver
   //==================================================================
   void TetMesh::writeMatlab(const std::string &filename, bool verbose)
   {
-#ifdef _WIN32
-#define float_t float
-#endif
-    //-------------------------------
-    //         Create File
-    //-------------------------------
-    std::ofstream file((filename + ".mat").c_str(), std::ios::out | std::ios::binary);
-    if(verbose)
-      std::cout << "Writing mesh matlab file: " << (filename + ".mat").c_str() << std::endl;
+    CompactTetMesh(*this).writeMatlab(filename, verbose);
+  }
 
-    if(!file.is_open())
-    {
-      std::cerr << "Failed to create file." << std::endl;
-      return;
-    }
-    Status status(verts.size() + 2*tets.size());
-
-    //--------------------------------------------------------------
-    //        Write Header (128 bytes)
-    //
-    //      Bytes   1 - 116  : Descriptive Text (116 bytes)
-    //      Bytes 117 - 124  : Subsystem Offset (8 bytes)
-    //      Bytes 125 - 126  : Matlab Version   ( 2 bytes)
-    //      Bytes 127 - 128  : Endian Indicator ( 2 bytes)
-    //--------------------------------------------------------------
-
-    // write description
-    std::string description = "MATLAB 5.0 MAT-file, SCIRun-TetMesh Created using Cleaver. SCI/Utah | http://www.sci.utah.edu";
-    description.resize(116, ' ');
-    file.write((char*)description.c_str(), description.length());
-
-    // write offset
-    char zeros[32] = {0};
-    file.write(zeros, 8);
-
-    // write version
-    int16_t version = 0x0100;
-    file.write((char*)&version, sizeof(int16_t));
-
-    // write endian
-    char endian[2] = {'I','M'};
-    file.write(endian, sizeof(int16_t));
-
-    //----------------------------------------------------------
-    //  Write Containing Structure
-    //  8 byte Tag for Matrix Element
-    //  6 Structure SubElements as Data
-    //          1 - Array Flags         (8 bytes)
-    //          2 - Dimensions Array    numberOfDimensions * sizeOfDataType
-    //          3 - Array Name          numberOfCharacters * sizeOfDataType
-    //          4 - Field Name Length   (4 bytes)
-    //          5 - Field Names         numberOfFields * FieldNameLength;
-    //          6 - Node Field
-    //          7 - Cell Field
-    //          8 - Field Field
-    //----------------------------------------------------------
-    int32_t mainType  = miMATRIX;
-    int32_t totalSize = 0;
-
-    // save location, when total size known, come back and fill it in
-    long totalSizeAddress = (long)file.tellp();
-    totalSizeAddress += sizeof(int32_t);
-
-
-    file.write((char*)&mainType, sizeof(int32_t));
-    file.write((char*)&totalSize, sizeof(int32_t));
-
-    //---------------------------------------------
-    //       Write Array Flags SubElement
-    //
-    //   bytes 1 - 2  : undefined (2 bytes)
-    //   byte  3      : flags  (1 byte)
-    //   byte  4      : class  (1 byte)
-    //   bytes 5 - 8  : undefined (4 bytes)
-    //---------------------------------------------
-
-    int32_t flagsType = miUINT32;
-    int32_t flagsSize = 8;
-
-    file.write((char*)&flagsType, sizeof(int32_t));
-    file.write((char*)&flagsSize, sizeof(int32_t));
-
-    int8_t flagsByte = 0;
-    int8_t classByte = mxSTRUCT_CLASS;
-
-    file.write((char*)&classByte, sizeof(int8_t));
-    file.write((char*)&flagsByte, sizeof(int8_t));
-    file.write(zeros, 2);
-    file.write(zeros, 4);
-
-    //---------------------------------------------
-    //     Write Dimensions Array SubElement
-    //
-    //---------------------------------------------
-    int32_t dimensionsType = miINT32;
-    int32_t dimensionsSize = 8;
-    int32_t dimension = 1;
-
-    file.write((char*)&dimensionsType, sizeof(int32_t));
-    file.write((char*)&dimensionsSize, sizeof(int32_t));
-    file.write((char*)&dimension, sizeof(int32_t));
-    file.write((char*)&dimension, sizeof(int32_t));
-
-    //---------------------------------------------
-    //     Write Array Name SubElement
-    //---------------------------------------------
-    int8_t  arrayName[8] = {'t','e','t','m','e','s','h','\0'};
-    int32_t arrayNameType = miINT8;
-    int32_t arrayNameSize = 7;
-
-    file.write((char*)&arrayNameType, sizeof(int32_t));
-    file.write((char*)&arrayNameSize, sizeof(int32_t));
-    file.write((char*)arrayName,    8*sizeof(int8_t));
-
-
-    //---------------------------------------------
-    //  Write Field Name Length SubElement
-    //---------------------------------------------
-    int16_t fieldNameLengthSize = sizeof(int32_t);
-    int16_t fieldNameLengthType = miINT32;
-    int32_t fieldNameLengthData = 8;
-
-    file.write((char*)&fieldNameLengthType, sizeof(int16_t));
-    file.write((char*)&fieldNameLengthSize, sizeof(int16_t));
-    file.write((char*)&fieldNameLengthData, sizeof(int32_t));
-
-    //---------------------------------------------
-    //  Write Field Names
-    //---------------------------------------------
-    int32_t fieldNamesType = miINT8;
-    int32_t fieldNamesSize = 8*3;
-
-    file.write((char*)&fieldNamesType, sizeof(int32_t));
-    file.write((char*)&fieldNamesSize, sizeof(int32_t));
-
-    strcpy(zeros, "node");
-    file.write(zeros, 8*sizeof(char));
-    memset(zeros, 0, 32);
-
-    strcpy(zeros, "cell");
-    file.write(zeros, 8*sizeof(char));
-    memset(zeros, 0, 32);
-
-    strcpy(zeros, "field");
-    file.write(zeros, 8*sizeof(char));
-    memset(zeros, 0, 32);
-
-    //---------------------------------------------
-    //  Write Field Cells
-    //---------------------------------------------
-
-    //-------------------------------
-    //         Write .node
-    //-------------------------------
-    int32_t nodeType = miMATRIX;
-    int32_t nodeSize = 0;
-
-    long nodeSizeAddress = (long)file.tellp();
-    nodeSizeAddress += sizeof(int32_t);
-
-    file.write((char*)&nodeType, sizeof(int32_t));
-    file.write((char*)&nodeSize, sizeof(int32_t));
-
-    //--------------------------------
-    //  Write Node Array flags
-    //
-    //   bytes 1 - 2  : undefined (2 bytes)
-    //   byte  3      : flags  (1 byte)
-    //   byte  4      : class  (1 byte)
-    //   bytes 5 - 8  : undefined (4 bytes)
-    //--------------------------------
-    int32_t nodeFlagsType = miUINT32;
-    int32_t nodeFlagsSize = 8;
-
-    file.write((char*)&nodeFlagsType, sizeof(int32_t));
-    file.write((char*)&nodeFlagsSize, sizeof(int32_t));
-
-    int8_t nodeFlagsByte = 0;
-    int8_t nodeClassByte = mxSINGLE_CLASS;
-
-    file.write((char*)&nodeClassByte, sizeof(int8_t));
-    file.write((char*)&nodeFlagsByte, sizeof(int8_t));
-    file.write(zeros, 2);
-    file.write(zeros, 4);
-
-    //---------------------------------------------
-    //   Write Node Dimensions Array
-    //---------------------------------------------
-    int32_t nodeDimensionType = miINT32;
-    int32_t nodeDimensionSize = 8;
-    int32_t nodeDimensionRows = 3;
-    int32_t nodeDimensionCols = static_cast<int32_t>(verts.size());
-
-    file.write((char*)&nodeDimensionType, sizeof(int32_t));
-    file.write((char*)&nodeDimensionSize, sizeof(int32_t));
-    file.write((char*)&nodeDimensionRows, sizeof(int32_t));
-    file.write((char*)&nodeDimensionCols, sizeof(int32_t));
-
-    //---------------------------------------------
-    //     Write Node Array Name SubElement
-    //---------------------------------------------
-    int32_t nodeArrayNameType = miINT8;
-    int32_t nodeArrayNameSize = 0;
-
-    file.write((char*)&nodeArrayNameType, sizeof(int32_t));
-    file.write((char*)&nodeArrayNameSize, sizeof(int32_t));
-
-    //----------------------------------------------
-    //     Write Node Pr Array Data SubElement
-    //----------------------------------------------
-    int32_t nodeDataType = miSINGLE;
-    int32_t nodeDataSize = nodeDimensionRows*nodeDimensionCols*sizeof(float_t);
-    int32_t nodePadding = (8 - (nodeDataSize % 8)) % 8;
-
-    file.write((char*)&nodeDataType, sizeof(int32_t));
-    file.write((char*)&nodeDataSize, sizeof(int32_t));
-
-    for(size_t i=0; i < verts.size(); i++)
-    {
-      if (verbose) status.printStatus();
-      float_t x = (float_t)verts[i]->pos().x;
-      float_t y = (float_t)verts[i]->pos().y;
-      float_t z = (float_t)verts[i]->pos().z;
-
-      file.write((char*)&x, sizeof(float_t));
-      file.write((char*)&y, sizeof(float_t));
-      file.write((char*)&z, sizeof(float_t));
-    }
-    if(nodePadding)
-      file.write((char*)zeros, nodePadding);
-    long nodeEndAddress = (long)file.tellp();
-
-    //-------------------------------
-    //         Write .cell
-    //-------------------------------
-    int32_t cellType = miMATRIX;
-    int32_t cellSize = 0;
-
-    long cellSizeAddress = (long)file.tellp();
-    cellSizeAddress += sizeof(int32_t);
-
-    file.write((char*)&cellType, sizeof(int32_t));
-    file.write((char*)&cellSize, sizeof(int32_t));
-
-    //--------------------------------
-    //  Write Cell Array flags
-    //
-    //   bytes 1 - 2  : undefined (2 bytes)
-    //   byte  3      : flags  (1 byte)
-    //   byte  4      : class  (1 byte)
-    //   bytes 5 - 8  : undefined (4 bytes)
-    //--------------------------------
-    int32_t cellFlagsType = miUINT32;
-    int32_t cellFlagsSize = 8;
-
-    file.write((char*)&cellFlagsType, sizeof(int32_t));
-    file.write((char*)&cellFlagsSize, sizeof(int32_t));
-
-    int8_t cellFlagsByte = 0;
-    int8_t cellClassByte = mxINT32_CLASS;
-
-    file.write((char*)&cellClassByte, sizeof(int8_t));
-    file.write((char*)&cellFlagsByte, sizeof(int8_t));
-    file.write(zeros, 2);
-    file.write(zeros, 4);
-
-    //---------------------------------------------
-    //   Write Cell Dimensions Array
-    //---------------------------------------------
-    int32_t cellDimensionType = miINT32;
-    int32_t cellDimensionSize = 8;
-    int32_t cellDimensionRows = 4;
-    int32_t cellDimensionCols = static_cast<int32_t>(tets.size());
-
-    file.write((char*)&cellDimensionType, sizeof(int32_t));
-    file.write((char*)&cellDimensionSize, sizeof(int32_t));
-    file.write((char*)&cellDimensionRows, sizeof(int32_t));
-    file.write((char*)&cellDimensionCols, sizeof(int32_t));
-
-    //---------------------------------------------
-    //     Write Cell Array Name SubElement
-    //---------------------------------------------
-    int32_t cellArrayNameType = miINT8;
-    int32_t cellArrayNameSize = 0;
-
-    file.write((char*)&cellArrayNameType, sizeof(int32_t));
-    file.write((char*)&cellArrayNameSize, sizeof(int32_t));
-
-    //----------------------------------------------
-    //     Write Cell Pr Array Data SubElement
-    //----------------------------------------------
-    int32_t cellDataType = miINT32;
-    int32_t cellDataSize = cellDimensionRows*cellDimensionCols*sizeof(int32_t);
-    int32_t cellPadding  = (8 - (cellDataSize % 8)) % 8;
-
-    file.write((char*)&cellDataType, sizeof(int32_t));
-    file.write((char*)&cellDataSize, sizeof(int32_t));
+  //===================================================================================
+  // - createVertex()
+  //
+  //  Vertices made through the mesh are allocated from its vertex pool. They are
+  // freed when the mesh is destroyed and must not be deleted individually.
+  //===================================================================================
+  Vertex* TetMesh::createVertex()
+  {
+    return m_vertexPool.create();
+  }
 
-    for(size_t i=0; i < tets.size(); i++)
-    {
-      if (verbose) status.printStatus();
-      for(int v=0; v < 4; v++){
-        int32_t index = tets[i]->verts[v]->tm_v_index + 1;
-        file.write((char*)&index, sizeof(int32_t));
-      }
-    }
-    if(cellPadding)
-      file.write((char*)zeros, cellPadding);
-    long cellEndAddress = (long)file.tellp();
-
-    //----------------------------------
-    //         Write .field
-    //----------------------------------
-    int32_t fieldType = miMATRIX;
-    int32_t fieldSize = 0;
-
-    long fieldSizeAddress = (long)file.tellp();
-    fieldSizeAddress += sizeof(int32_t);
-
-    file.write((char*)&fieldType, sizeof(int32_t));
-    file.write((char*)&fieldSize, sizeof(int32_t));
-
-    //--------------------------------
-    //  Write Field Array flags
-    //
-    //   bytes 1 - 2  : undefined (2 bytes)
-    //   byte  3      : flags  (1 byte)
-    //   byte  4      : class  (1 byte)
-    //   bytes 5 - 8  : undefined (4 bytes)
-    //--------------------------------
-    int32_t fieldFlagsType = miUINT32;
-    int32_t fieldFlagsSize = 8;
-
-    file.write((char*)&fieldFlagsType, sizeof(int32_t));
-    file.write((char*)&fieldFlagsSize, sizeof(int32_t));
-
-    int8_t fieldFlagsByte = 0;
-    int8_t fieldClassByte = mxUINT8_CLASS;
-
-    file.write((char*)&fieldClassByte, sizeof(int8_t));
-    file.write((char*)&fieldFlagsByte, sizeof(int8_t));
-    file.write(zeros, 2);
-    file.write(zeros, 4);
-
-    //---------------------------------------------
-    //   Write Field Dimensions Array
-    //---------------------------------------------
-    int32_t fieldDimensionType = miINT32;
-    int32_t fieldDimensionSize = 8;
-    int32_t fieldDimensionRows = 1;
-    int32_t fieldDimensionCols = static_cast<int32_t>(tets.size());
-
-    file.write((char*)&fieldDimensionType, sizeof(int32_t));
-    file.write((char*)&fieldDimensionSize, sizeof(int32_t));
-    file.write((char*)&fieldDimensionRows, sizeof(int32_t));
-    file.write((char*)&fieldDimensionCols, sizeof(int32_t));
-
-    //---------------------------------------------
-    //     Write Field Array Name SubElement
-    //---------------------------------------------
-    int32_t fieldArrayNameType = miINT8;
-    int32_t fieldArrayNameSize = 0;
-
-    file.write((char*)&fieldArrayNameType, sizeof(int32_t));
-    file.write((char*)&fieldArrayNameSize, sizeof(int32_t));
-
-    //----------------------------------------------
-    //     Write Field Pr Array Data SubElement
-    //----------------------------------------------
-    int32_t fieldDataType = miUINT8;
-    int32_t fieldDataSize = fieldDimensionRows*fieldDimensionCols*sizeof(int8_t);
-    int32_t fieldPadding  = (8 - (fieldDataSize % 8)) % 8;
-
-    file.write((char*)&fieldDataType, sizeof(int32_t));
-    file.write((char*)&fieldDataSize, sizeof(int32_t));
+  Vertex* TetMesh::createVertex(int materials)
+  {
+    return m_vertexPool.create(materials);
+  }
 
-    for(size_t i=0; i < tets.size(); i++)
-    {
-      if (verbose) status.printStatus();
-      unsigned char m = tets[i]->mat_label;
-      file.write((char*)&m, sizeof(int8_t));
-    }
-    if(fieldPadding)
-      file.write(zeros, fieldPadding);
-    long fieldEndAddress = (long)file.tellp();
-    long fileEndAddress = (long)file.tellp();
-
-    //-------------------------------
-    //  Finally, Compute Sizes and
-    //         Write Them
-    //-------------------------------
-    totalSize = fileEndAddress -  (totalSizeAddress + sizeof(int32_t));
-    nodeSize  = nodeEndAddress -  (nodeSizeAddress  + sizeof(int32_t));
-    cellSize  = cellEndAddress -  (cellSizeAddress  + sizeof(int32_t));
-    fieldSize = fieldEndAddress - (fieldSizeAddress + sizeof(int32_t));
-
-    file.seekp(totalSizeAddress);
-    file.write((char*)&totalSize, sizeof(int32_t));
-
-    file.seekp(nodeSizeAddress);
-    file.write((char*)&nodeSize,  sizeof(int32_t));
-
-    file.seekp(cellSizeAddress);
-    file.write((char*)&cellSize,  sizeof(int32_t));
-
-    file.seekp(fieldSizeAddress);
-    file.write((char*)&fieldSize, sizeof(int32_t));
-
-    //-------------------------------
-    //   Done
-    //-------------------------------
-    file.flush();
-    file.close();
-    if (verbose) status.done();
+  Vertex* TetMesh::createVertex(int materials, unsigned int thread)
+  {
+    if (thread == 0)
+      return m_vertexPool.create(materials);
+    return m_threadVertexPools[thread - 1]->create(materials);
+  }
+
+  //===================================================================================
+  // - setAllocationThreads()
+  //
+  //  Makes sure there is one vertex pool per thread, so that createVertex(m, thread)
+  // can be called concurrently from up to the given number of threads. Must not be
+  // called while another thread is allocating.
+  //===================================================================================
+  void TetMesh::setAllocationThreads(unsigned int threads)
+  {
+    while (m_threadVertexPools.size() + 1 < threads)
+      m_threadVertexPools.push_back(std::unique_ptr<ObjectPool<Vertex> >(new ObjectPool<Vertex>()));
+  }
+
+  bool TetMesh::ownsVertex(const Vertex *vertex) const
+  {
+    if (m_vertexPool.owns(vertex))
+      return true;
+    for (size_t p = 0; p < m_threadVertexPools.size(); p++) {
+      if (m_threadVertexPools[p]->owns(vertex))
+        return true;
+    }
+    return false;
   }
 
   //===================================================================================
@@ -1913,7 +983,7 @@ namespace cleaver
     //  Create Tet + Add to List
     //----------------------------
 
-    Tet *tet = new Tet(v1, v2, v3, v4, material);
+    Tet *tet = m_tetPool.create(v1, v2, v3, v4, material);
     tet->tm_index = static_cast<int>(tets.size());
     tets.push_back(tet);
 
@@ -1993,7 +1063,8 @@ namespace cleaver
         }
 
         // then free the tet
-        delete tet;
+        if(!m_tetPool.owns(tet))
+          delete tet;
         tets[t] = nullptr;
       }
     }
@@ -2008,7 +1079,8 @@ namespace cleaver
     // free the vertices, once
     std::set<Vertex*>::iterator it;
     for (it = delete_list.begin(); it != delete_list.end(); ++it) {
-      delete *it;
+      if(!ownsVertex(*it))
+        delete *it;
     }
 
     // resize tet list
@@ -2099,7 +1171,7 @@ namespace cleaver
   //==========================================================
   //  return edges incident to vertex v (visually verified)
   //==========================================================
-  std::vector<HalfEdge*> TetMesh::edgesAroundVertex(Vertex *v)
+  const std::vector<HalfEdge*>& TetMesh::edgesAroundVertex(Vertex *v)
   {
     return v->halfEdges;
   }
@@ -2117,6 +1189,13 @@ namespace cleaver
   std::vector<HalfFace*> TetMesh::facesAroundVertex(Vertex *v)
   {
     std::vector<HalfFace*> facelist;
+    facesAroundVertex(v, facelist);
+    return facelist;
+  }
+
+  void TetMesh::facesAroundVertex(Vertex *v, std::vector<HalfFace*> &facelist)
+  {
+    facelist.clear();
 
     for(size_t e=0; e < v->halfEdges.size(); e++)
     {
@@ -2136,14 +1215,12 @@ namespace cleaver
         }
       }
     }
-
-    return facelist;
   }
 
   //=====================================================
   // return tets incident to vertex v (must work)
   //=====================================================
-  std::vector<Tet*>  TetMesh::tetsAroundVertex(Vertex *v)
+  const std::vector<Tet*>&  TetMesh::tetsAroundVertex(Vertex *v)
   {
     return v->tets;
   }
@@ -2154,9 +1231,13 @@ namespace cleaver
   std::vector<HalfFace*> TetMesh::facesAroundEdge(HalfEdge *e)
   {
     std::vector<HalfFace*> facelist;
+    facesAroundEdge(e, facelist);
+    return facelist;
+  }
 
-    for(size_t f=0; f < e->halfFaces.size(); f++)
-      facelist.push_back(e->halfFaces[f]);
+  void TetMesh::facesAroundEdge(HalfEdge *e, std::vector<HalfFace*> &facelist)
+  {
+    facelist.assign(e->halfFaces.begin(), e->halfFaces.end());
 
     // now look at mate edge, add any incident faces that don't have face-mates
     HalfEdge *me = e->mate;
@@ -2165,8 +1246,6 @@ namespace cleaver
         facelist.push_back(me->halfFaces[f]);
       }
     }
-
-    return facelist;
   }
 
   //=====================================================
@@ -2175,6 +1254,13 @@ namespace cleaver
   std::vector<Tet*>  TetMesh::tetsAroundEdge(HalfEdge *e)
   {
     std::vector<Tet*> tetlist;
+    tetsAroundEdge(e, tetlist);
+    return tetlist;
+  }
+
+  void TetMesh::tetsAroundEdge(HalfEdge *e, std::vector<Tet*> &tetlist)
+  {
+    tetlist.clear();
 
     for(size_t f=0; f < e->halfFaces.size(); f++){
       size_t index = (e->halfFaces[f] - &this->halfFaces[0]) / 4;
@@ -2189,8 +1275,6 @@ namespace cleaver
         tetlist.push_back(tets[index]);
       }
     }
-
-    return tetlist;
   }
 
   //---------------------------------------------------------
@@ -2198,17 +1282,24 @@ namespace cleaver
   //---------------------------------------------------------
   std::vector<Tet*>  TetMesh::tetsAroundFace(HalfFace *f)
   {
-    std::vector<Tet*> tetlist;
+    Tet *tetlist[2];
+    int count = tetsAroundFace(f, tetlist);
+    return std::vector<Tet*>(tetlist, tetlist + count);
+  }
 
+  int TetMesh::tetsAroundFace(HalfFace *f, Tet *tetlist[2])
+  {
     size_t index1 = (f - &this->halfFaces[0]) / 4;
-    tetlist.push_back(tets[index1]);
+    tetlist[0] = tets[index1];
 
     if(f->mate){
       size_t index2 = (f->mate - &this->halfFaces[0]) / 4;
-      tetlist.push_back(tets[index2]);
+      tetlist[1] = tets[index2];
+      return 2;
     }
 
-    return tetlist;
+    tetlist[1] = nullptr;
+    return 1;
   }
 
   //========================================================
@@ -2216,13 +1307,16 @@ namespace cleaver
   //========================================================
   std::vector<Vertex*> TetMesh::vertsAroundFace(HalfFace *f)
   {
-    std::vector<Vertex*> vertlist;
-
-    vertlist.push_back(f->halfEdges[0]->vertex);
-    vertlist.push_back(f->halfEdges[1]->vertex);
-    vertlist.push_back(f->halfEdges[2]->vertex);
+    Vertex *vertlist[3];
+    vertsAroundFace(f, vertlist);
+    return std::vector<Vertex*>(vertlist, vertlist + 3);
+  }
 
-    return vertlist;
+  void TetMesh::vertsAroundFace(HalfFace *f, Vertex *vertlist[3])
+  {
+    vertlist[0] = f->halfEdges[0]->vertex;
+    vertlist[1] = f->halfEdges[1]->vertex;
+    vertlist[2] = f->halfEdges[2]->vertex;
   }
 
   //==================================================
@@ -2230,14 +1324,15 @@ namespace cleaver
   //==================================================
   std::vector<Vertex*> TetMesh::vertsAroundTet(Tet *t)
   {
-    std::vector<Vertex*> vertlist;
-
-    vertlist.push_back(t->verts[0]);
-    vertlist.push_back(t->verts[1]);
-    vertlist.push_back(t->verts[2]);
-    vertlist.push_back(t->verts[3]);
+    return std::vector<Vertex*>(t->verts, t->verts + 4);
+  }
 
-    return vertlist;
+  void TetMesh::vertsAroundTet(Tet *t, Vertex *vertlist[4])
+  {
+    vertlist[0] = t->verts[0];
+    vertlist[1] = t->verts[1];
+    vertlist[2] = t->verts[2];
+    vertlist[3] = t->verts[3];
   }
 
   //====================================================
@@ -2245,14 +1340,17 @@ namespace cleaver
   //====================================================
   std::vector<HalfFace*> TetMesh::facesAroundTet(Tet *t)
   {
-    std::vector<HalfFace*> facelist;
-
-    facelist.push_back(&halfFaces[4*t->tm_index + 0]);
-    facelist.push_back(&halfFaces[4*t->tm_index + 1]);
-    facelist.push_back(&halfFaces[4*t->tm_index + 2]);
-    facelist.push_back(&halfFaces[4*t->tm_index + 3]);
+    HalfFace *facelist[4];
+    facesAroundTet(t, facelist);
+    return std::vector<HalfFace*>(facelist, facelist + 4);
+  }
 
-    return facelist;
+  void TetMesh::facesAroundTet(Tet *t, HalfFace *facelist[4])
+  {
+    facelist[0] = &halfFaces[4*t->tm_index + 0];
+    facelist[1] = &halfFaces[4*t->tm_index + 1];
+    facelist[2] = &halfFaces[4*t->tm_index + 2];
+    facelist[3] = &halfFaces[4*t->tm_index + 3];
   }
 
   //====================================================
@@ -2260,22 +1358,22 @@ namespace cleaver
   //====================================================
   std::vector<HalfEdge*> TetMesh::edgesAroundTet(Tet *t)
   {
-    HalfFace *faces[4];
-    faces[0] = &halfFaces[(4*t->tm_index)+0];
-    faces[1] = &halfFaces[(4*t->tm_index)+1];
-    faces[2] = &halfFaces[(4*t->tm_index)+2];
-    faces[3] = &halfFaces[(4*t->tm_index)+3];
-
-    std::vector<HalfEdge*> edgelist;
-
-    edgelist.push_back(faces[2]->halfEdges[1]);  // edge 0-1
-    edgelist.push_back(faces[3]->halfEdges[0]);  // edge 0-2
-    edgelist.push_back(faces[1]->halfEdges[1]);  // edge 0-3
-    edgelist.push_back(faces[0]->halfEdges[0]);  // edge 1-2
-    edgelist.push_back(faces[2]->halfEdges[2]);  // edge 1-3
-    edgelist.push_back(faces[0]->halfEdges[1]);  // edge 2-3
+    HalfEdge *edgelist[6];
+    edgesAroundTet(t, edgelist);
+    return std::vector<HalfEdge*>(edgelist, edgelist + 6);
+  }
 
-    return edgelist;
+  void TetMesh::edgesAroundTet(Tet *t, HalfEdge *edgelist[6])
+  {
+    HalfFace *faces[4];
+    facesAroundTet(t, faces);
+
+    edgelist[0] = faces[2]->halfEdges[1];  // edge 0-1
+    edgelist[1] = faces[3]->halfEdges[0];  // edge 0-2
+    edgelist[2] = faces[1]->halfEdges[1];  // edge 0-3
+    edgelist[3] = faces[0]->halfEdges[0];  // edge 1-2
+    edgelist[4] = faces[2]->halfEdges[2];  // edge 1-3
+    edgelist[5] = faces[0]->halfEdges[1];  // edge 2-3
   }
 
   std::vector<HalfFace*> TetMesh::facesIncidentToBothTetAndEdge(Tet *tet, HalfEdge *edge)
@@ -2392,64 +1490,16 @@ namespace cleaver
     //-----------------------------------
     //  First Obtain Tet-Tet Adjacency
     //-----------------------------------
-    for(size_t i=0; i < this->tets.size(); i++)
-    {
-      // look for a tet sharing three verts opposite vert[j]
-      for (int j=0; j < 4; j++)
-      {
-        if (this->tets[i]->tets[j] == nullptr)
-        {
-          // grab three vertices to compare against
-          Vertex *v0 = this->tets[i]->verts[(j+1)%4];
-          Vertex *v1 = this->tets[i]->verts[(j+2)%4];
-          Vertex *v2 = this->tets[i]->verts[(j+3)%4];
-          //bool found_adjacent = false;
-
-          // search over adjacent tets touching these verts
-          for (size_t k=0; k < v0->tets.size(); k++)
-          {
-            Tet* tet = v0->tets[k];
-            if(tet != this->tets[i])
-            {
-              // check if it is adjacent, i.e. has v2 and v3
-              int shared_count = 0;
-              for (int l=0; l < 4; l++){
-                if (tet->verts[l] == v1 || tet->verts[l] == v2)
-                  shared_count++;
-              }
-
-              // if match found
-              if (shared_count == 2)
-              {
-                //--------------------
-                //  set for this tet
-                //--------------------
-                this->tets[i]->tets[j] = tet;
-
-                //----------------------
-                // set for neighbor tet
-                //----------------------
-                // first figure out reversed face
-                int shared_face = 0;
-                for (int m=0; m<4; m++){
-                  if(tet->verts[m] != v0 && tet->verts[m] != v1 && tet->verts[m] != v2){
-                    shared_face = m;
-                  }
-                }
-                // then set it
-                tet->tets[shared_face] = this->tets[i];
-
-                // done searching adjacent tets
-                break;
-              }
-            }
-          }
-        }
-      }
-    }
+    constructTetAdjacency();
+
     // allocate sufficient space
     halfFaces = std::vector<HalfFace>(4*tets.size());
     halfEdges.clear();
+    halfEdges.reserve(2*(verts.size() + tets.size()));
+
+    // previous edges were released above, drop stale references
+    for(size_t v=0; v < verts.size(); v++)
+      verts[v]->halfEdges.clear();
 
     std::queue<Tet*> tq;
 
@@ -2531,6 +1581,9 @@ namespace cleaver
 
     }
 
+    // visit edges in vertex index order, independent of the BFS above
+    halfEdges.sortByIndex();
+
     //------- Begin DEBUGGING CODE FOR VIS ---------/
     // go through all faces and see if any were disconnected from mesh
     // if they were, temporarily give them edges so we can visualize them.
@@ -2605,7 +1658,9 @@ namespace cleaver
     double xmin = 1.0e16, xmax = -1.0e16,
            ymin = 1.0e16, ymax = -1.0e16,
            zmin = 1.0e16, zmax = -1.0e16;
-    vector< Vertex*> verts(nv);
+    TetMesh *mesh = new TetMesh();
+    vector< Vertex*> &verts = mesh->verts;
+    verts.resize(nv);
 
     for(int i = 0; i < nv; i++)
     {
@@ -2625,13 +1680,11 @@ namespace cleaver
       if(z < zmin) zmin = z;
       if(z > zmax) zmax = z;
 
-      verts[i] = new Vertex();
+      verts[i] = mesh->createVertex();
       verts[i]->pos() = vec3(x,y,z);
       verts[i]->tm_v_index = i;
     }
 
-    TetMesh *mesh = new TetMesh(verts,vector< Tet*>());
-
     mesh->bounds = BoundingBox(xmin, ymin, zmin, xmax - xmin, ymax - ymin, zmax - zmin);
 
 
@@ -2704,21 +1757,17 @@ namespace cleaver
   //------------------------------------
   void TetMesh::removeExternalTets()
   {
-    // loop over all tets in the mesh
-    std::vector<Tet*>::iterator iter = tets.begin();
-    while(iter != tets.end())
+    // mark all tets in the mesh
+    std::vector<bool> remove(tets.size(), false);
+    for(size_t t=0; t < tets.size(); t++)
     {
-      Tet *tet = *iter;
+      Tet *tet = tets[t];
 
       // erase only if all 4 vertices are exterior
-      if(tet->verts[0]->isExterior && tet->verts[1]->isExterior &&
-          tet->verts[2]->isExterior && tet->verts[3]->isExterior)
-      {
-        iter = removeTet(iter);
-      }
-      else
-        iter++;
+      remove[t] = tet->verts[0]->isExterior && tet->verts[1]->isExterior &&
+                  tet->verts[2]->isExterior && tet->verts[3]->isExterior;
     }
+    removeTets(remove);
 
     constructFaces();
     constructBottomUpIncidences();
@@ -2734,11 +1783,11 @@ namespace cleaver
   //------------------------------
   void TetMesh::removeLockedTets()
   {
-    // loop over all tets in the mesh
-    std::vector<Tet*>::iterator iter = tets.begin();
-    while(iter != tets.end())
+    // mark all tets in the mesh
+    std::vector<bool> remove(tets.size(), false);
+    for(size_t t=0; t < tets.size(); t++)
     {
-      Tet *tet = *iter;
+      Tet *tet = tets[t];
 
       // check tets incident to the 4 vertices
       bool safe = true;
@@ -2762,16 +1811,9 @@ namespace cleaver
       }
 
       // if no cuts incident, safe to delete
-      if(safe)
-        iter = removeTet(iter);
-      else
-        iter++;
-    }
-    // fix tm indices
-    for(size_t t=0; t < tets.size(); t++)
-    {
-      tets[t]->tm_index = static_cast<int>(t);
+      remove[t] = safe;
     }
+    removeTets(remove);
 
     constructFaces();
     constructBottomUpIncidences();
@@ -2786,18 +1828,11 @@ namespace cleaver
   //------------------------------
   void TetMesh::removeMaterial(int m)
   {
-    // loop over all tets in the mesh
-    std::vector<Tet*>::iterator iter = tets.begin();
-    while(iter != tets.end())
-    {
-      Tet *tet = *iter;
-
-      // erase only if all 4 vertices are exterior
-      if(tet->mat_label == m)
-        iter = removeTet(iter);
-      else
-        iter++;
-    }
+    // mark all tets in the mesh
+    std::vector<bool> remove(tets.size(), false);
+    for(size_t t=0; t < tets.size(); t++)
+      remove[t] = (tets[t]->mat_label == m);
+    removeTets(remove);
 
     constructFaces();
     constructBottomUpIncidences();
@@ -2813,11 +1848,11 @@ namespace cleaver
   //------------------------------
   void TetMesh::removeOutsideBox(BoundingBox &box)
   {
-    // loop over all tets in the mesh
-    std::vector<Tet*>::iterator iter = tets.begin();
-    while(iter != tets.end())
+    // mark all tets in the mesh
+    std::vector<bool> remove(tets.size(), false);
+    for(size_t t=0; t < tets.size(); t++)
     {
-      Tet *tet = *iter;
+      Tet *tet = tets[t];
 
       bool outside = true;
       for(int v=0; v < 4; v++)
@@ -2828,16 +1863,124 @@ namespace cleaver
         }
       }
 
-      if(outside)
-        iter = removeTet(iter);
-      else
-        iter++;
+      remove[t] = outside;
     }
+    removeTets(remove);
 
     constructFaces();
     constructBottomUpIncidences(true);
   }
 
+  namespace {
+    // spread the low 21 bits of x so there are two zero bits between each
+    uint64_t spreadBits(uint64_t x)
+    {
+      x &= 0x1fffff;
+      x = (x | x << 32) & 0x1f00000000ffffULL;
+      x = (x | x << 16) & 0x1f0000ff0000ffULL;
+      x = (x | x << 8)  & 0x100f00f00f00f00fULL;
+      x = (x | x << 4)  & 0x10c30c30c30c30c3ULL;
+      x = (x | x << 2)  & 0x1249249249249249ULL;
+      return x;
+    }
+
+    // 63 bit Morton code of p, quantized over the given box
+    uint64_t mortonCode(const vec3 &p, const vec3 &origin, const vec3 &scale)
+    {
+      const double cells = static_cast<double>(0x1fffff);
+      uint64_t x = static_cast<uint64_t>(std::max(0.0, std::min(cells, (p.x - origin.x)*scale.x)));
+      uint64_t y = static_cast<uint64_t>(std::max(0.0, std::min(cells, (p.y - origin.y)*scale.y)));
+      uint64_t z = static_cast<uint64_t>(std::max(0.0, std::min(cells, (p.z - origin.z)*scale.z)));
+      return spreadBits(x) | (spreadBits(y) << 1) | (spreadBits(z) << 2);
+    }
+  }
+
+  //----------------------------------------------------------------
+  // - reorderSpatially()
+  //
+  // Sorts verts and tets along a Morton (Z-order) curve through the
+  // bounds of the vertices, so elements that are close in space are
+  // close in the lists, and renumbers tm_v_index / tm_index to match.
+  // Faces are remapped. Half-faces are stored by tet index and are
+  // not; rebuild them with constructBottomUpIncidences() if needed.
+  //----------------------------------------------------------------
+  void TetMesh::reorderSpatially(bool verbose)
+  {
+    if(verts.empty())
+      return;
+
+    vec3 lo = verts[0]->pos();
+    vec3 hi = verts[0]->pos();
+    for(size_t v=1; v < verts.size(); v++)
+    {
+      lo = vec3::min(lo, verts[v]->pos());
+      hi = vec3::max(hi, verts[v]->pos());
+    }
+    vec3 extent = hi - lo;
+    const double cells = static_cast<double>(0x1fffff);
+    vec3 scale(extent.x > 0 ? cells / extent.x : 0,
+               extent.y > 0 ? cells / extent.y : 0,
+               extent.z > 0 ? cells / extent.z : 0);
+
+    //----------------------------
+    //  Sort Vertices
+    //----------------------------
+    std::vector<std::pair<uint64_t, size_t> > order(verts.size());
+    for(size_t v=0; v < verts.size(); v++)
+      order[v] = std::make_pair(mortonCode(verts[v]->pos(), lo, scale), v);
+    std::sort(order.begin(), order.end());
+
+    std::vector<int> vert_map(verts.size());
+    std::vector<Vertex*> sorted_verts(verts.size());
+    for(size_t v=0; v < order.size(); v++)
+    {
+      sorted_verts[v] = verts[order[v].second];
+      sorted_verts[v]->tm_v_index = static_cast<int>(v);
+      vert_map[order[v].second] = static_cast<int>(v);
+    }
+    verts.swap(sorted_verts);
+
+    //----------------------------
+    //  Sort Tets by Centroid
+    //----------------------------
+    order.resize(tets.size());
+    for(size_t t=0; t < tets.size(); t++)
+    {
+      Tet *tet = tets[t];
+      vec3 centroid = 0.25*(tet->verts[0]->pos() + tet->verts[1]->pos() +
+                            tet->verts[2]->pos() + tet->verts[3]->pos());
+      order[t] = std::make_pair(mortonCode(centroid, lo, scale), t);
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<int> tet_map(tets.size());
+    std::vector<Tet*> sorted_tets(tets.size());
+    for(size_t t=0; t < order.size(); t++)
+    {
+      sorted_tets[t] = tets[order[t].second];
+      sorted_tets[t]->tm_index = static_cast<int>(t);
+      tet_map[order[t].second] = static_cast<int>(t);
+    }
+    tets.swap(sorted_tets);
+
+    //----------------------------
+    //  Remap Faces
+    //----------------------------
+    for(size_t f=0; f < faces.size(); f++)
+    {
+      Face *face = faces[f];
+      for(int v=0; v < 3; v++)
+        face->verts[v] = vert_map[face->verts[v]];
+      for(int t=0; t < 2; t++)
+        if(face->tets[t] >= 0)
+          face->tets[t] = tet_map[face->tets[t]];
+    }
+
+    if(verbose)
+      std::cout << "Reordered " << verts.size() << " verts and "
+                << tets.size() << " tets along Morton curve." << std::endl;
+  }
+
   //----------------------------------------------------------------
   // - removeTet()
   //
@@ -2879,12 +2022,82 @@ namespace cleaver
   //-----------------------------
   void TetMesh::removeTet(int t)
   {
-    int i = 0;
-    std::vector<Tet*>::iterator iter = tets.begin();
-    while(iter != tets.end() && i < t) { i++; ++iter; }
-    if (iter != tets.end())
-      removeTet(iter);
+    if (t >= 0 && t < static_cast<int>(tets.size()))
+      removeTet(tets.begin() + t);
+  }
+
+  //----------------------------------------------------------------
+  // - removeTets()
+  //
+  // Removes every tet whose entry in the remove mask is set, in a
+  // single pass over the mesh. Surviving tets and vertices keep
+  // their relative order and have tm_index / tm_v_index renumbered.
+  // Vertices left with no tets are dropped from the mesh. Faces and
+  // half-edges are left stale; callers rebuild them with
+  // constructFaces() and constructBottomUpIncidences().
+  //
+  // Returns the number of tets removed.
+  //----------------------------------------------------------------
+  size_t TetMesh::removeTets(const std::vector<bool> &remove)
+  {
+    // flag doomed tets, and the vertices that may lose them
+    std::vector<Vertex*> touched;
+    for(size_t t=0; t < tets.size() && t < remove.size(); t++)
+    {
+      if(remove[t]) {
+        tets[t]->tm_index = -1;
+        for(int v=0; v < 4; v++)
+          touched.push_back(tets[t]->verts[v]);
+      }
+    }
+
+    // drop flagged tets from vertex lists, flag orphaned vertices
+    for(size_t v=0; v < touched.size(); v++)
+    {
+      std::vector<Tet*> &vtets = touched[v]->tets;
+      size_t kept = 0;
+      for(size_t j=0; j < vtets.size(); j++) {
+        if(vtets[j]->tm_index >= 0)
+          vtets[kept++] = vtets[j];
+      }
+      vtets.resize(kept);
+
+      if(vtets.empty())
+        touched[v]->tm_v_index = -1;
+    }
+
+    // compact tets
+    size_t tet_count = 0;
+    for(size_t t=0; t < tets.size(); t++)
+    {
+      Tet *tet = tets[t];
+      if(tet->tm_index < 0) {
+        if(!m_tetPool.owns(tet))
+          delete tet;
+        continue;
+      }
+      tet->tm_index = static_cast<int>(tet_count);
+      tets[tet_count++] = tet;
+    }
+    size_t removed = tets.size() - tet_count;
+    tets.resize(tet_count);
+
+    // compact vertices
+    size_t vert_count = 0;
+    for(size_t v=0; v < verts.size(); v++)
+    {
+      Vertex *vertex = verts[v];
+      if(vertex->tm_v_index < 0) {
+        if(!ownsVertex(vertex))
+          delete vertex;
+        continue;
+      }
+      vertex->tm_v_index = static_cast<int>(vert_count);
+      verts[vert_count++] = vertex;
+    }
+    verts.resize(vert_count);
 
+    return removed;
   }
 
 }
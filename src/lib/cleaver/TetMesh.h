@@ -46,8 +46,11 @@
 #include <string>
 #include <map>
 #include <set>
+#include <memory>
 #include "Vertex.h"
 #include "HalfEdge.h"
+#include "HalfEdgeTable.h"
+#include "ObjectPool.h"
 #include "HalfFace.h"
 #include "Tet.h"
 #include "BoundingBox.h"
@@ -65,6 +68,7 @@ namespace cleaver
 //              BCCLattice   BCCOctree
 enum MeshType { Constant,    Adaptive };
 enum MeshFormat { Tetgen, Scirun, Matlab, VtkUSG, VtkPoly, PLY };
+enum MeshOrdering { NaturalOrder, RCMOrder };
 
 class TetMesh
 {
@@ -77,12 +81,17 @@ public:
 
     size_t fixVertexWindup(bool verbose);
 
+    Vertex* createVertex();
+    Vertex* createVertex(int materials);
+    Vertex* createVertex(int materials, unsigned int thread);  // from the given thread's pool
+    void setAllocationThreads(unsigned int threads);
     Tet* createTet(Vertex *v1, Vertex *v2, Vertex *v3, Vertex *v4, int material);
     void removeTet(int t);
     std::vector<Tet*>::iterator removeTet(std::vector<Tet*>::iterator);
+    size_t removeTets(const std::vector<bool> &remove);  // remove every tets[t] with remove[t] set
 
     //void writeOff(const std::string &filename);
-    void writeMesh(const std::string &filename, MeshFormat format, bool verbose = false);
+    void writeMesh(const std::string &filename, MeshFormat format, bool verbose = false, MeshOrdering ordering = NaturalOrder);
     void writeVtkPolyData(const std::string &filename, bool verbose = false);
     void writeVtkUnstructuredGrid(const std::string &filename, bool verbose = false);
     void writeMatlab(const std::string &filename, bool verbose = false);   // matlab format
@@ -112,6 +121,8 @@ public:
     void removeMaterial(int m);  // remove all tets of material i
     void removeOutsideBox(BoundingBox &box);
 
+    void reorderSpatially(bool verbose = false);  // sort verts & tets along a Morton curve
+
     std::vector<Vertex*> verts;           // these arrays are probably cache-inefficient
     std::vector<Tet*> tets;               // these arrays are probably cache-inefficient   // consider testing with non-pointer based arrays
     std::vector<Face*> faces;             // these arrays are probably cache-inefficient
@@ -120,7 +131,7 @@ public:
     static TetMesh* createFromNodeElePair(const std::string &nodeFileName, const std::string &eleFileName, bool verbose = false);
 
     std::vector<HalfFace> halfFaces;
-    std::map<std::pair<int, int>, HalfEdge*> halfEdges;
+    HalfEdgeTable halfEdges;
     HalfEdge* halfEdgeForVerts(Vertex *v1, Vertex *v2);
 
     bool imported;
@@ -137,9 +148,9 @@ public:
     void getAdjacencyListsForTet(Tet *tet, Vertex *verts[4], HalfEdge *edges[6], HalfFace *faces[4]);
     void getRightHandedVertexList(Tet *tet, Vertex *verts[15]);
 
-    std::vector<HalfEdge*> edgesAroundVertex(Vertex *v);
+    const std::vector<HalfEdge*>& edgesAroundVertex(Vertex *v);
     std::vector<HalfFace*> facesAroundVertex(Vertex *v);
-    std::vector<Tet*>      tetsAroundVertex(Vertex *v);
+    const std::vector<Tet*>&      tetsAroundVertex(Vertex *v);
     std::vector<HalfFace*> facesAroundEdge(HalfEdge *e);
     std::vector<Tet*>      tetsAroundEdge(HalfEdge *e);
     std::vector<Tet*>      tetsAroundFace(HalfFace *f);
@@ -151,6 +162,34 @@ public:
     std::vector<HalfFace*> facesIncidentToBothTetAndEdge(Tet *tet, HalfEdge *edge);
 
     Tet* oppositeTetAcrossFace(Tet *tet, HalfFace *face);
+
+    // Adjacency Queries into caller-provided storage. Lists are cleared
+    // and refilled, so reusing them across calls avoids reallocation.
+    void facesAroundVertex(Vertex *v, std::vector<HalfFace*> &faces);
+    void facesAroundEdge(HalfEdge *e, std::vector<HalfFace*> &faces);
+    void tetsAroundEdge(HalfEdge *e, std::vector<Tet*> &tets);
+    int  tetsAroundFace(HalfFace *f, Tet *tets[2]);
+    static void vertsAroundFace(HalfFace *f, Vertex *verts[3]);
+    static void vertsAroundTet(Tet *t, Vertex *verts[4]);
+    void facesAroundTet(Tet *t, HalfFace *faces[4]);
+    void edgesAroundTet(Tet *t, HalfEdge *edges[6]);
+
+private:
+    // pairs tets across shared faces, returns false if any face is
+    // shared by more than two tets
+    bool constructTetAdjacency();
+
+    // was this vertex allocated from one of the mesh's vertex pools
+    bool ownsVertex(const Vertex *vertex) const;
+
+    // storage for objects made by createVertex() and createTet(),
+    // released all at once when the mesh is destroyed
+    ObjectPool<Vertex> m_vertexPool;
+    ObjectPool<Tet>    m_tetPool;
+
+    // extra vertex pools so worker threads can allocate without locking,
+    // thread 0 always allocates from m_vertexPool
+    std::vector<std::unique_ptr<ObjectPool<Vertex> > > m_threadVertexPools;
 };
 
 }
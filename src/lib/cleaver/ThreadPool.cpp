@@ -0,0 +1,176 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- Thread Pool
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+//-------------------------------------------------------------------
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace cleaver
+{
+  ThreadPool::ThreadPool(unsigned int threads) :
+    m_busy(false), m_body(nullptr), m_end(0), m_grain(1), m_next(0),
+    m_generation(0), m_running(0), m_stop(false)
+  {
+    start(threads);
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+    stop();
+  }
+
+  void ThreadPool::setThreadCount(unsigned int threads)
+  {
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    if (threads == threadCount())
+      return;
+
+    stop();
+    start(threads);
+  }
+
+  void ThreadPool::start(unsigned int threads)
+  {
+    if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+
+    m_stop = false;
+    for (unsigned int t = 1; t < threads; t++)
+      m_workers.push_back(std::thread(&ThreadPool::workerLoop, this, t));
+  }
+
+  void ThreadPool::stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    for (size_t t = 0; t < m_workers.size(); t++)
+      m_workers[t].join();
+    m_workers.clear();
+  }
+
+  //===================================================
+  // - parallelFor()
+  //
+  // Runs body over [begin,end) in chunks of at most
+  // grain iterations and returns once every chunk is
+  // done. An exception thrown by the body is rethrown
+  // here after the remaining chunks are abandoned.
+  //===================================================
+  void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, const RangeFunction &body)
+  {
+    if (begin >= end)
+      return;
+    grain = std::max<size_t>(grain, 1);
+
+    // run inline if there is nothing to share, or we are already
+    // inside a parallel loop and the workers are taken
+    if (m_workers.empty() || end - begin <= grain || m_busy.exchange(true)) {
+      body(begin, end, 0);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_body = &body;
+      m_end = end;
+      m_grain = grain;
+      m_next = begin;
+      m_error = nullptr;
+      m_running = static_cast<unsigned int>(m_workers.size());
+      m_generation++;
+    }
+    m_wake.notify_all();
+
+    runChunks(0);
+
+    std::exception_ptr error;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_finished.wait(lock, [this]{ return m_running == 0; });
+      m_body = nullptr;
+      error = m_error;
+      m_error = nullptr;
+    }
+    m_busy = false;
+
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+  void ThreadPool::runChunks(unsigned int thread)
+  {
+    try {
+      for (;;) {
+        size_t first = m_next.fetch_add(m_grain);
+        if (first >= m_end)
+          break;
+        (*m_body)(first, std::min(first + m_grain, m_end), thread);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_error)
+        m_error = std::current_exception();
+      m_next = m_end;
+    }
+  }
+
+  void ThreadPool::workerLoop(unsigned int thread)
+  {
+    unsigned int seen = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [&]{ return m_stop || m_generation != seen; });
+        if (m_stop)
+          return;
+        seen = m_generation;
+      }
+
+      runChunks(thread);
+
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_running == 0)
+          m_finished.notify_one();
+      }
+    }
+  }
+}
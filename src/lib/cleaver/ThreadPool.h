@@ -0,0 +1,104 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- Thread Pool
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+//-------------------------------------------------------------------
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+namespace cleaver
+{
+
+/**
+ * Fixed set of worker threads that execute parallel loops. A loop
+ * over [begin,end) is cut into chunks of 'grain' iterations which
+ * the workers and the calling thread claim until the range is done.
+ * The body receives its chunk and the index of the thread running
+ * it, 0 always being the calling thread, so callers can keep
+ * per-thread state or restrict progress output to one thread.
+ * With a single thread, or when called from inside another loop,
+ * the body simply runs inline on the calling thread.
+ */
+class ThreadPool
+{
+public:
+    typedef std::function<void(size_t begin, size_t end, unsigned int thread)> RangeFunction;
+
+    explicit ThreadPool(unsigned int threads = 1);
+    ~ThreadPool();
+
+    // 0 selects one thread per hardware thread
+    void setThreadCount(unsigned int threads);
+    unsigned int threadCount() const { return static_cast<unsigned int>(m_workers.size()) + 1; }
+
+    void parallelFor(size_t begin, size_t end, size_t grain, const RangeFunction &body);
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    void start(unsigned int threads);
+    void stop();
+    void workerLoop(unsigned int thread);
+    void runChunks(unsigned int thread);
+
+    std::vector<std::thread> m_workers;
+    std::mutex               m_mutex;
+    std::condition_variable  m_wake;
+    std::condition_variable  m_finished;
+    std::atomic<bool>        m_busy;
+
+    // current loop, guarded by m_mutex
+    const RangeFunction *m_body;
+    size_t               m_end;
+    size_t               m_grain;
+    std::atomic<size_t>  m_next;
+    unsigned int         m_generation;
+    unsigned int         m_running;
+    bool                 m_stop;
+    std::exception_ptr   m_error;
+};
+
+}
+
+#endif // THREAD_POOL_H
@@ -57,7 +57,7 @@ TopologicalInterfaceCalculator::TopologicalInterfaceCalculator(
     TetMesh *mesh, AbstractVolume *volume) : m_mesh(mesh), m_volume(volume) {}
 
 
-void TopologicalInterfaceCalculator::computeCutForEdge(HalfEdge *edge) {
+void TopologicalInterfaceCalculator::computeCutForEdge(HalfEdge *edge, unsigned int thread) {
   double t_ab;
   double t_ac;
   double t_bc;
@@ -283,7 +283,7 @@ void TopologicalInterfaceCalculator::computeCutForEdge(HalfEdge *edge) {
       // put topological cut haflway between ac/bc interfaces
       double tt = 0.5f*(t_ac + t_bc);
 
-      Vertex *cut = new Vertex(m_volume->numberOfMaterials());
+      Vertex *cut = m_mesh->createVertex(m_volume->numberOfMaterials(), thread);
       tt = std::max(tt, 0.0);
       tt = std::min(tt, 1.0);
 
@@ -303,7 +303,7 @@ void TopologicalInterfaceCalculator::computeCutForEdge(HalfEdge *edge) {
 
       // doesn't really matter which
       cut->label = c_mat;
-      cut->lbls[c_mat] = true;
+      cut->lbls.set(c_mat);
 
       // check violating condition
       if ((tt <= edge->alpha) || (tt >= (1 - edge->mate->alpha)))
@@ -323,7 +323,7 @@ void TopologicalInterfaceCalculator::computeCutForEdge(HalfEdge *edge) {
   }
 }
 
-void TopologicalInterfaceCalculator::computeTripleForFace(HalfFace *face) {
+void TopologicalInterfaceCalculator::computeTripleForFace(HalfFace *face, unsigned int /*thread*/) {
  // set as evaluated
   face->evaluated = true;
   if (face->mate)
@@ -548,7 +548,7 @@ void TopologicalInterfaceCalculator::computeTripleForFace(HalfFace *face) {
 }
 
 
-void TopologicalInterfaceCalculator::computeQuadrupleForTet(Tet *tet) {
+void TopologicalInterfaceCalculator::computeQuadrupleForTet(Tet *tet, unsigned int thread) {
   // set as evaluated
   tet->evaluated = true;
 
@@ -564,7 +564,7 @@ void TopologicalInterfaceCalculator::computeQuadrupleForTet(Tet *tet) {
       return;
   }
 
-  Vertex *quadruple = new Vertex(m_volume->numberOfMaterials());
+  Vertex *quadruple = m_mesh->createVertex(m_volume->numberOfMaterials(), thread);
 
   Vertex *v1 = verts[0];
   Vertex *v2 = verts[1];
@@ -572,10 +572,10 @@ void TopologicalInterfaceCalculator::computeQuadrupleForTet(Tet *tet) {
   Vertex *v4 = verts[3];
 
   quadruple->pos() = (1.0 / 4.0)*(v1->pos() + v2->pos() + v3->pos() + v4->pos());
-  quadruple->lbls[v1->label] = true;
-  quadruple->lbls[v2->label] = true;
-  quadruple->lbls[v3->label] = true;
-  quadruple->lbls[v4->label] = true;
+  quadruple->lbls.set(v1->label);
+  quadruple->lbls.set(v2->label);
+  quadruple->lbls.set(v3->label);
+  quadruple->lbls.set(v4->label);
   quadruple->label = std::min(v1->label, v2->label);
   tet->quadruple = quadruple;
   tet->quadruple->phantom = true;
@@ -54,9 +54,9 @@ class TopologicalInterfaceCalculator : public InterfaceCalculator
 {
   public:
     TopologicalInterfaceCalculator(TetMesh *mesh, AbstractVolume *volume);
-    virtual void computeCutForEdge(HalfEdge *edge);
-    virtual void computeTripleForFace(HalfFace *face);
-    virtual void computeQuadrupleForTet(Tet *tet);
+    virtual void computeCutForEdge(HalfEdge *edge, unsigned int thread);
+    virtual void computeTripleForFace(HalfFace *face, unsigned int thread);
+    virtual void computeQuadrupleForTet(Tet *tet, unsigned int thread);
 
   private:
     TetMesh *m_mesh;
@@ -266,4 +266,22 @@ Json::Value tet_to_json(Tet *tet, TetMesh *mesh, bool includeInterfaces) {
 }
 
 
+//-------------------------------------------------------------------
+//  Interface colors, indexed by material pair
+//-------------------------------------------------------------------
+float INTERFACE_COLORS[12][3] = {
+  {141/255.0f, 211/255.0f, 199/255.0f},
+  {255/255.0f, 255/255.0f, 179/255.0f},
+  {190/255.0f, 186/255.0f, 218/255.0f},
+  {251/255.0f, 128/255.0f, 114/255.0f},
+  {128/255.0f, 177/255.0f, 211/255.0f},
+  {253/255.0f, 180/255.0f, 98/255.0f},
+  {179/255.0f, 222/255.0f, 105/255.0f},
+  {252/255.0f, 205/255.0f, 229/255.0f},
+  {217/255.0f, 217/255.0f, 217/255.0f},
+  {188/255.0f, 128/255.0f, 189/255.0f},
+  {204/255.0f, 235/255.0f, 197/255.0f}
+};
+
+
 }
@@ -54,6 +54,9 @@ namespace cleaver
 {
     enum ordering { row , col };
 
+    // surface colors used by the PLY writers
+    extern float INTERFACE_COLORS[12][3];
+
     double pow2(int p);
 
     bool triangle_intersection(Vertex *v1, Vertex *v2, Vertex *v3,
@@ -57,6 +57,84 @@ enum class Order : int8_t {
     QUAD = 3
 };
 
+//-------------------------------------------------------------------
+// Set of material labels attached to an interface vertex. Labels
+// 0-63 are stored inline in a single word; since labels are bytes,
+// the remaining 192 possible labels spill into a lazily allocated
+// block that only meshes with more than 63 materials ever touch.
+//-------------------------------------------------------------------
+class MaterialLabels
+{
+public:
+    MaterialLabels() : m_bits(0), m_high(nullptr) {}
+    explicit MaterialLabels(int count) : m_bits(0), m_high(nullptr) {
+        if (count > 64)
+            allocateHigh();
+    }
+    MaterialLabels(const MaterialLabels &other) : m_bits(other.m_bits), m_high(nullptr) {
+        if (other.m_high) {
+            allocateHigh();
+            memcpy(m_high, other.m_high, kHighWords*sizeof(uint64_t));
+        }
+    }
+    MaterialLabels& operator=(const MaterialLabels &other) {
+        m_bits = other.m_bits;
+        if (other.m_high) {
+            if (!m_high)
+                allocateHigh();
+            memcpy(m_high, other.m_high, kHighWords*sizeof(uint64_t));
+        } else if (m_high) {
+            memset(m_high, 0, kHighWords*sizeof(uint64_t));
+        }
+        return *this;
+    }
+    ~MaterialLabels() { delete [] m_high; }
+
+    inline void set(int m) {
+        if (m < 64) {
+            m_bits |= (uint64_t(1) << m);
+        } else {
+            if (!m_high)
+                allocateHigh();
+            m_high[(m - 64) >> 6] |= (uint64_t(1) << (m & 63));
+        }
+    }
+
+    inline bool test(int m) const {
+        if (m < 64)
+            return (m_bits >> m) & 1;
+        return m_high && ((m_high[(m - 64) >> 6] >> (m & 63)) & 1);
+    }
+
+    inline bool operator[](int m) const { return test(m); }
+
+    // compare only labels [0, count)
+    inline bool equals(const MaterialLabels &other, int count) const {
+        if (count <= 64) {
+            uint64_t mask = (count == 64) ? ~uint64_t(0) : ((uint64_t(1) << count) - 1);
+            return ((m_bits ^ other.m_bits) & mask) == 0;
+        }
+        if (m_bits != other.m_bits)
+            return false;
+        for (int m = 64; m < count; m++) {
+            if (test(m) != other.test(m))
+                return false;
+        }
+        return true;
+    }
+
+private:
+    static const int kHighWords = 3;
+
+    void allocateHigh() {
+        m_high = new uint64_t[kHighWords];
+        memset(m_high, 0, kHighWords*sizeof(uint64_t));
+    }
+
+    uint64_t  m_bits;      // labels 0-63
+    uint64_t *m_high;      // labels 64-255, when needed
+};
+
 class OTCell;
 class HalfEdge;
 class HalfFace;
@@ -67,45 +145,57 @@ class Vertex : public Geometry{
 
 public:
     Vertex(int materials) : parent(nullptr), conformedVertex(nullptr), conformedEdge(nullptr), conformedFace(nullptr),
-        isExterior(false), violating(false), warped(false), tm_v_index(-1), lbls(new bool[materials+1]), dual(false),
+        isExterior(false), violating(false), warped(false), tm_v_index(-1), lbls(materials+1), dual(false),
         m_order(Order::VERT), m_pos(vec3::zero), m_pos_next(vec3::zero)
     {
         // increases lbls by 1 to account for background feb 20
-        memset(lbls, 0, (materials+1)*sizeof(bool));
     }
     Vertex() : parent(nullptr), conformedVertex(nullptr), conformedEdge(nullptr), conformedFace(nullptr),
-        isExterior(false), violating(false), warped(false), tm_v_index(-1), lbls(0), dual(false),
+        isExterior(false), violating(false), warped(false), tm_v_index(-1), dual(false),
         m_order(Order::VERT), m_pos(vec3::zero),m_pos_next(vec3::zero){ }
     ~Vertex();
 
     inline vec3& pos(){
-        Vertex* ptr = this;
-        while(ptr->parent)
-            ptr = ptr->parent;
-        return ptr->m_pos;
+        return root()->m_pos;
     }
     inline vec3& pos_next(){
-        Vertex* ptr = this;
-        while(ptr->parent)
-            ptr = ptr->parent;
-        return ptr->m_pos_next;
+        return root()->m_pos_next;
     }
     inline Order& order(){
-        Vertex *ptr = this;
-        while(ptr->parent)
-            ptr = ptr->parent;
-        return ptr->m_order;
+        return root()->m_order;
     }
 
     const Order original_order(){
         return m_order;
     }
 
+    // Returns the vertex this one has been snapped to. Parent chains
+    // are compressed on the way out, so that every vertex visited
+    // points directly at the root and later lookups cost one hop.
     inline Vertex* root() {
+        if(!parent)
+            return this;
+        if(!parent->parent)
+            return parent;
+        Vertex *root = parent->parent;
+        while(root->parent)
+            root = root->parent;
         Vertex *ptr = this;
-        while(ptr->parent)
-            ptr = ptr->parent;
-        return ptr;
+        while(ptr->parent != root){
+            Vertex *next = ptr->parent;
+            ptr->parent = root;
+            ptr = next;
+        }
+        return root;
+    }
+
+    // Same lookup as root() without compressing the chain, so it
+    // can be used by several threads at once.
+    inline Vertex* findRoot() {
+        Vertex *root = this;
+        while(root->parent)
+            root = root->parent;
+        return root;
     }
 
     inline bool isEqualTo(Vertex* vert)
@@ -127,7 +217,7 @@ public:
     bool warped:1;               // has this edge been warped
     int tm_v_index;
     unsigned char label;       // single label (for generating texture image)
-    bool  *lbls;               // material labels
+    MaterialLabels lbls;       // material labels
     bool dual;
     bool phantom;
 
@@ -40,6 +40,7 @@
 
 #include "Volume.h"
 #include "BoundingBox.h"
+#include <typeinfo>
 
 namespace cleaver
 {
@@ -53,6 +54,8 @@ Volume::Volume(const cleaver::Volume &volume)
     this->m_bounds      = volume.m_bounds;
     this->m_sizingField = volume.m_sizingField;
     this->m_valueFields = volume.m_valueFields;
+    this->m_sharedGrid  = volume.m_sharedGrid;
+    this->m_sharedGridRevisions = volume.m_sharedGridRevisions;
 }
 
 Volume::Volume(const std::vector<AbstractScalarField*> &fields, int width, int height, int depth) :
@@ -70,6 +73,7 @@ Volume::Volume(const std::vector<AbstractScalarField*> &fields, int width, int h
         m_bounds = BoundingBox(vec3::zero, vec3(width, height, depth));
 
     }
+    updateSharedGrid();
 }
 
 Volume::Volume(const std::vector<AbstractScalarField*> &fields, vec3 &size) :
@@ -87,6 +91,7 @@ Volume::Volume(const std::vector<AbstractScalarField*> &fields, vec3 &size) :
         m_bounds = BoundingBox(vec3::zero, size);
 
     }
+    updateSharedGrid();
 }
 
 Volume& Volume::operator= (const Volume &volume)
@@ -94,6 +99,8 @@ Volume& Volume::operator= (const Volume &volume)
     this->m_bounds      = volume.m_bounds;
     this->m_sizingField = volume.m_sizingField;
     this->m_valueFields = volume.m_valueFields;
+    this->m_sharedGrid  = volume.m_sharedGrid;
+    this->m_sharedGridRevisions = volume.m_sharedGridRevisions;
     return *this;
 }
 
@@ -102,6 +109,11 @@ void Volume::setSize(int width, int height, int depth)
     m_bounds.size = vec3(width, height, depth);
 }
 
+void Volume::setSize(const vec3 &size)
+{
+    m_bounds.size = size;
+}
+
 void Volume::setSizingField(AbstractScalarField *field)
 {
     this->m_sizingField = field;
@@ -129,6 +141,62 @@ int Volume::maxAt(float x, float y, float z) const
 
 int Volume::maxAt(const vec3 &x) const
 {
+    return argmaxAt(x);
+}
+
+void Volume::valuesAt(const vec3 &x, double *out) const
+{
+    if(sharedGridValid())
+    {
+        TrilinearStencil stencil;
+        sharedStencilAt(x, stencil);
+
+        for(size_t m=0; m < m_sharedGrid.size(); m++)
+            out[m] = m_sharedGrid[m]->valueAt(stencil);
+        return;
+    }
+
+    for(int m=0; m < numberOfMaterials(); m++)
+        out[m] = valueAt(x, m);
+}
+
+void Volume::valuesAt(const vec3 &x, const int *materials, int count, double *out) const
+{
+    if(sharedGridValid())
+    {
+        TrilinearStencil stencil;
+        sharedStencilAt(x, stencil);
+
+        for(int i=0; i < count; i++)
+            out[i] = m_sharedGrid[materials[i]]->valueAt(stencil);
+        return;
+    }
+
+    for(int i=0; i < count; i++)
+        out[i] = valueAt(x, materials[i]);
+}
+
+int Volume::argmaxAt(const vec3 &x) const
+{
+    if(sharedGridValid())
+    {
+        TrilinearStencil stencil;
+        sharedStencilAt(x, stencil);
+
+        double maxValue = m_sharedGrid[0]->valueAt(stencil);
+        int    maxLabel = 0;
+        for(size_t m=1; m < m_sharedGrid.size(); m++)
+        {
+            double value = m_sharedGrid[m]->valueAt(stencil);
+            if(value > maxValue)
+            {
+                maxValue = value;
+                maxLabel = (int)m;
+            }
+        }
+        return maxLabel;
+    }
+
     double maxValue = valueAt(x,0);
     unsigned int   maxLabel = 0;
 
@@ -145,6 +213,47 @@ int Volume::maxAt(const vec3 &x) const
     return maxLabel;
 }
 
+void Volume::argmaxAt(const vec3 *x, size_t n, int *labels) const
+{
+    if(n == 0 || m_valueFields.empty())
+        return;
+
+    std::vector<vec3>   tx(n);
+    std::vector<double> maxValue(n), value(n);
+    bool shared = sharedGridValid();
+
+    for(int m=0; m < numberOfMaterials(); m++)
+    {
+        // fields on a shared grid only need the points mapped once
+        if(m == 0 || !shared)
+        {
+            BoundingBox field = m_valueFields[m]->bounds();
+            for(size_t i=0; i < n; i++)
+                tx[i] = vec3((x[i].x / m_bounds.size.x)*field.size.x,
+                             (x[i].y / m_bounds.size.y)*field.size.y,
+                             (x[i].z / m_bounds.size.z)*field.size.z);
+        }
+
+        if(m == 0)
+        {
+            m_valueFields[0]->valueAt(&tx[0], n, &maxValue[0]);
+            for(size_t i=0; i < n; i++)
+                labels[i] = 0;
+            continue;
+        }
+
+        m_valueFields[m]->valueAt(&tx[0], n, &value[0]);
+        for(size_t i=0; i < n; i++)
+        {
+            if(value[i] > maxValue[i])
+            {
+                maxValue[i] = value[i];
+                labels[i] = m;
+            }
+        }
+    }
+}
+
 double Volume::valueAt(const vec3 &x, int material) const
 {
     vec3 tx = vec3((x.x / m_bounds.size.x)*m_valueFields[material]->bounds().size.x,
@@ -182,6 +291,7 @@ void Volume::addMaterial(AbstractScalarField *field)
 
     // otherwise, add it
     m_valueFields.push_back(field);
+    updateSharedGrid();
 }
 
 void Volume::removeMaterial(AbstractScalarField *field)
@@ -197,6 +307,64 @@ void Volume::removeMaterial(AbstractScalarField *field)
                 break;
         }
     }
+    updateSharedGrid();
+}
+
+void Volume::sharedStencilAt(const vec3 &x, TrilinearStencil &stencil) const
+{
+    // same volume to field mapping as valueAt(), done once for all materials
+    BoundingBox grid = m_sharedGrid[0]->bounds();
+    m_sharedGrid[0]->stencilAt((x.x / m_bounds.size.x)*grid.size.x,
+                               (x.y / m_bounds.size.y)*grid.size.y,
+                               (x.z / m_bounds.size.z)*grid.size.z, stencil);
+}
+
+bool Volume::sharedGridValid() const
+{
+    if(m_sharedGrid.empty())
+        return false;
+
+    for(size_t m=0; m < m_sharedGrid.size(); m++)
+    {
+        if(m_sharedGrid[m]->gridRevision() != m_sharedGridRevisions[m])
+            return false;
+    }
+    return true;
+}
+
+void Volume::updateSharedGrid()
+{
+    m_sharedGrid.clear();
+    m_sharedGridRevisions.clear();
+    if(m_valueFields.empty())
+        return;
+
+    std::vector<const FloatField*> fields;
+    std::vector<unsigned int> revisions;
+    for(size_t m=0; m < m_valueFields.size(); m++)
+    {
+        // subclasses such as ConstantField override valueAt() and may have
+        // no data, only a plain FloatField can be read through a stencil
+        if(!m_valueFields[m] || typeid(*m_valueFields[m]) != typeid(FloatField))
+            return;
+        const FloatField *field = static_cast<const FloatField*>(m_valueFields[m]);
+
+        if(m > 0)
+        {
+            const FloatField *first = fields[0];
+            BoundingBox a = first->bounds(), b = field->bounds();
+            BoundingBox da = first->dataBounds(), db = field->dataBounds();
+            if(!(a.origin == b.origin) || !(a.size == b.size) ||
+               !(da.size == db.size) || !(first->scale() == field->scale()) ||
+               first->getCenterType() != field->getCenterType())
+                return;
+        }
+        fields.push_back(field);
+        revisions.push_back(field->gridRevision());
+    }
+
+    m_sharedGrid.swap(fields);
+    m_sharedGridRevisions.swap(revisions);
 }
 
 }
@@ -66,6 +66,17 @@ public:
     virtual double valueAt(double x, double y, double z, int material) const;
     virtual int maxAt(float x, float y, float z) const;
     virtual int maxAt(const vec3 &x) const;
+
+    // evaluate every material at x into out[0..numberOfMaterials()), or
+    // only the listed materials into out[0..count)
+    virtual void valuesAt(const vec3 &x, double *out) const;
+    virtual void valuesAt(const vec3 &x, const int *materials, int count, double *out) const;
+    virtual int argmaxAt(const vec3 &x) const;
+
+    // label a batch of points, each material is evaluated over the whole
+    // batch so vectorized field kernels can be used
+    virtual void argmaxAt(const vec3 *x, size_t n, int *labels) const;
+
     virtual int numberOfMaterials() const;
     virtual const BoundingBox& bounds() const;
 
@@ -73,15 +84,30 @@ public:
     float lfsAt(float x, float y, float z) const;
 
     void setSize(int width, int height, int depth);
+    void setSize(const vec3 &size);
     void setSizingField(AbstractScalarField *field);
 
     AbstractScalarField* getSizingField() const;
     AbstractScalarField* getMaterial(int i) const { return m_valueFields[i]; }
 
-    void addMaterial(AbstractScalarField *field);
-    void removeMaterial(AbstractScalarField *field);
+    virtual void addMaterial(AbstractScalarField *field);
+    virtual void removeMaterial(AbstractScalarField *field);
+
+protected:
+    // material fields as FloatFields, filled only when they are all plain
+    // FloatFields on one grid so a sample's stencil can be computed once
+    // for every material
+    std::vector<const FloatField*> m_sharedGrid;
+
+    // false once a cached field's grid changed after it was cached
+    bool sharedGridValid() const;
 
 private:
+    void sharedStencilAt(const vec3 &x, TrilinearStencil &stencil) const;
+    void updateSharedGrid();
+
+    std::vector<unsigned int> m_sharedGridRevisions;
+
     std::string m_name;
     std::vector<AbstractScalarField*> m_valueFields;
     AbstractScalarField* m_sizingField;
@@ -32,13 +32,19 @@
 #include <string>
 #include <vector>
 #include <cleaver/ScalarField.h>
+#include <cleaver/LabelVolume.h>
 
 class NRRDTools {
 public:
   static std::vector<cleaver::AbstractScalarField*>
-    segmentationToIndicatorFunctions(std::string file, double sigma = 1.);
+    segmentationToIndicatorFunctions(std::string file, double sigma = 1.,
+    cleaver::FieldPrecision precision = cleaver::Float32);
+  static cleaver::LabelVolume*
+    loadLabelVolume(std::string file, double sigma = 1.,
+    cleaver::ThreadPool *pool = nullptr);
   static std::vector<cleaver::AbstractScalarField*>
-    loadNRRDFiles(std::vector<std::string> files, double sigma = 1.);
+    loadNRRDFiles(std::vector<std::string> files, double sigma = 1.,
+    cleaver::FieldPrecision precision = cleaver::Float32);
   static void saveNRRDFile(const cleaver::FloatField *field,
     const std::string &name);
 };
@@ -29,6 +29,7 @@
 
 #include <cstdio>
 #include <NRRDTools.h>
+#include <cleaver/Cleaver.h>
 #include <itkImage.h>
 #include <itkImageFileReader.h>
 #include <itkImageFileWriter.h>
@@ -72,7 +73,8 @@ bool checkImageSize(ImageType::Pointer inputImg, double sigma)
 }
 
 std::vector<cleaver::AbstractScalarField*>
-NRRDTools::segmentationToIndicatorFunctions(std::string filename, double sigma) {
+NRRDTools::segmentationToIndicatorFunctions(std::string filename, double sigma,
+  cleaver::FieldPrecision precision) {
   // read file using ITK
   if (filename.find(".nrrd") != std::string::npos) {
     itk::NrrdImageIOFactory::RegisterOneFactory();
@@ -184,12 +186,60 @@ NRRDTools::segmentationToIndicatorFunctions(std::string filename, double sigma)
     ((cleaver::FloatField*)fields[num])->setScale(
       cleaver::vec3(spacing[0], spacing[1], spacing[2]));
   }
+  cleaver::quantizeFields(fields, precision);
   return fields;
 }
 
+cleaver::LabelVolume*
+NRRDTools::loadLabelVolume(std::string filename, double sigma,
+  cleaver::ThreadPool *pool) {
+  // read file using ITK
+  if (filename.find(".nrrd") != std::string::npos) {
+    itk::NrrdImageIOFactory::RegisterOneFactory();
+  } else if (filename.find(".mha") != std::string::npos) {
+    itk::MetaImageIOFactory::RegisterOneFactory();
+  }
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(filename);
+  reader->Update();
+  ImageType::Pointer image = reader->GetOutput();
+
+  //determine the number of labels in the segmentations
+  ImageCalculatorFilterType::Pointer imageCalculatorFilter
+    = ImageCalculatorFilterType::New();
+  imageCalculatorFilter->SetImage(image);
+  imageCalculatorFilter->Compute();
+  auto maxLabel = static_cast<long>(imageCalculatorFilter->GetMaximum());
+  auto minLabel = static_cast<long>(imageCalculatorFilter->GetMinimum());
+  if (maxLabel - minLabel >= 65536) {
+    std::cerr << "Fatal Error: segmentation spans more than 65536 labels." << std::endl;
+    return nullptr;
+  }
+
+  // labels become material indices counted from the smallest label
+  auto region = image->GetLargestPossibleRegion();
+  std::vector<unsigned short> materials(region.GetNumberOfPixels());
+  itk::ImageRegionConstIterator<ImageType> imageIterator(image, region);
+  size_t pixel = 0;
+  while (!imageIterator.IsAtEnd()) {
+    auto label = static_cast<long>(std::floor(imageIterator.Get() + 0.5f));
+    materials[pixel++] = static_cast<unsigned short>(label - minLabel);
+    ++imageIterator;
+  }
+
+  auto spacing = image->GetSpacing();
+  auto x = region.GetSize()[0], y = region.GetSize()[1], z = region.GetSize()[2];
+  auto volume = new cleaver::LabelVolume(materials.data(), x, y, z,
+    static_cast<int>(maxLabel - minLabel + 1),
+    cleaver::vec3(spacing[0], spacing[1], spacing[2]), sigma, pool);
+  auto beg = filename.find_last_of("/") + 1;
+  volume->setName(filename.substr(beg, filename.size() - beg));
+  return volume;
+}
+
 std::vector<cleaver::AbstractScalarField*>
 NRRDTools::loadNRRDFiles(std::vector<std::string> files,
-  double sigma) {
+  double sigma, cleaver::FieldPrecision precision) {
   std::vector<cleaver::AbstractScalarField*> fields;
   size_t num = 0;
   for (auto file : files) {
@@ -261,6 +311,7 @@ NRRDTools::loadNRRDFiles(std::vector<std::string> files,
     ((cleaver::FloatField*)fields[num])->setScale(cleaver::vec3(spacing[0], spacing[1], spacing[2]));
     num++;
   }
+  cleaver::quantizeFields(fields, precision);
   return fields;
 }
 
@@ -4,7 +4,10 @@
 #include <teem/nrrd.h>
 #include <iostream>
 #include <fstream>
+#include <cleaver/Cleaver.h>
 #include <cleaver/ScalarField.h>
+#include <cleaver/LabelVolume.h>
+#include <cmath>
 #include <cleaver/Status.h>
 
 using namespace cleaver;
@@ -21,12 +24,76 @@ std::string condensed(const std::string &filename)
 // Provide no-op implementation for unsupported method.
 std::vector<cleaver::AbstractScalarField*>
 
-NRRDTools::segmentationToIndicatorFunctions(std::string file, double sigma)
+NRRDTools::segmentationToIndicatorFunctions(std::string file, double sigma,
+                                            FieldPrecision precision)
 {
   cerr << "NRRD file read error: Cleaver does not currently support segmentation files with teem. Please use ITK." << endl;
     return {};
 }
 
+LabelVolume* NRRDTools::loadLabelVolume(std::string file, double sigma, ThreadPool *pool)
+{
+    Nrrd* nin = nrrdNew();
+    if(nrrdLoad(nin, file.c_str(), NULL))
+    {
+        char *err = biffGetDone(NRRD);
+        cerr << "Trouble Reading File: " << file << " : " << err << endl;
+        free(err);
+        nrrdNuke(nin);
+        return NULL;
+    }
+
+    if(nin->dim != 3)
+    {
+        cerr << "Fatal Error: volume dimension " << nin->dim << ", expected 3." << endl;
+        nrrdNuke(nin);
+        return NULL;
+    }
+
+    int w = nin->axis[0].size;
+    int h = nin->axis[1].size;
+    int d = nin->axis[2].size;
+    size_t voxels = (size_t)w*h*d;
+
+    // labels become material indices counted from the smallest label
+    float (*lup)(const void *, size_t I);
+    lup = nrrdFLookup[nin->type];
+    std::vector<int> labels(voxels);
+    int minLabel = 0, maxLabel = 0;
+    for(size_t v=0; v < voxels; v++)
+    {
+        labels[v] = (int)floor(lup(nin->data, v) + 0.5f);
+        if(v == 0 || labels[v] < minLabel) minLabel = labels[v];
+        if(v == 0 || labels[v] > maxLabel) maxLabel = labels[v];
+    }
+    if(maxLabel - minLabel >= 65536)
+    {
+        cerr << "Fatal Error: segmentation spans more than 65536 labels." << endl;
+        nrrdNuke(nin);
+        return NULL;
+    }
+
+    std::vector<unsigned short> materials(voxels);
+    for(size_t v=0; v < voxels; v++)
+        materials[v] = (unsigned short)(labels[v] - minLabel);
+
+    double xs = nin->axis[0].spacing;
+    double ys = nin->axis[1].spacing;
+    double zs = nin->axis[2].spacing;
+
+    // handle NaN cases
+    if(xs != xs) xs = 1;
+    if(ys != ys) ys = 1;
+    if(zs != zs) zs = 1;
+
+    nrrdNuke(nin);
+
+    LabelVolume *volume = new LabelVolume(&materials[0], w, h, d, maxLabel - minLabel + 1,
+                                          vec3(xs, ys, zs), sigma, pool);
+    volume->setName(condensed(file));
+    return volume;
+}
+
 AbstractScalarField* loadNRRDFile(const std::string &filename, bool verbose)
 {
     //--------------------------------------------
@@ -124,7 +191,8 @@ AbstractScalarField* loadNRRDFile(const std::string &filename, bool verbose)
 }
 
 std::vector<AbstractScalarField*>
-NRRDTools::loadNRRDFiles(std::vector<std::string> filenames, double sigma)
+NRRDTools::loadNRRDFiles(std::vector<std::string> filenames, double sigma,
+                         FieldPrecision precision)
 {
     bool verbose = false;
     bool pad = false;
@@ -335,6 +403,7 @@ NRRDTools::loadNRRDFiles(std::vector<std::string> filenames, double sigma)
         status.done();
     }
 
+    cleaver::quantizeFields(fields, precision);
     return fields;
 }
 
@@ -94,4 +94,64 @@ protected:
 TEST_F(MesherTest, BasicTest)
 {
     ASSERT_TRUE(true);
-}
\ No newline at end of file
+}
+
+TEST_F(MesherTest, ColorWarpConflicts)
+{
+    // vertices sharing a tet always conflict
+    std::vector<cleaver::Vertex*> candidates(verts, verts + VERTS_PER_TET);
+    std::vector<std::vector<cleaver::Vertex*> > classes;
+    mesher->colorWarpConflicts(candidates, classes);
+
+    ASSERT_EQ(4u, classes.size());
+    for (int c = 0; c < 4; c++) {
+        ASSERT_EQ(1u, classes[c].size());
+        ASSERT_EQ(verts[c], classes[c][0]);
+    }
+}
+
+TEST_F(MesherTest, IsVertexViolated)
+{
+    // a cut violating one end of its edge
+    cleaver::Vertex cut;
+    cut.order() = cleaver::Order::CUT;
+    cut.violating = true;
+    cut.closestGeometry = edges[0]->vertex;
+    edges[0]->cut = &cut;
+    edges[0]->mate->cut = &cut;
+
+    ASSERT_TRUE(mesher->isVertexViolated(edges[0]->vertex));
+    ASSERT_FALSE(mesher->isVertexViolated(edges[0]->mate->vertex));
+
+    // snapped cuts no longer violate
+    cut.parent = edges[0]->vertex;
+    ASSERT_FALSE(mesher->isVertexViolated(edges[0]->vertex));
+
+    edges[0]->cut = nullptr;
+    edges[0]->mate->cut = nullptr;
+}
+
+TEST_F(MesherTest, ClassifyInterfaceTets)
+{
+    // no cuts, nothing to stencil
+    ASSERT_EQ(0u, mesher->classifyInterfaceTets());
+    ASSERT_EQ(0, mesher->m_interfaceTets[0]);
+
+    // virtual cuts don't count
+    edges[0]->cut = edges[0]->vertex;
+    edges[0]->mate->cut = edges[0]->vertex;
+    ASSERT_EQ(0u, mesher->classifyInterfaceTets());
+
+    // a real cut does
+    cleaver::Vertex cut;
+    cut.order() = cleaver::Order::CUT;
+    edges[1]->cut = &cut;
+    edges[1]->mate->cut = &cut;
+    ASSERT_EQ(1u, mesher->classifyInterfaceTets());
+    ASSERT_EQ(1, mesher->m_interfaceTets[0]);
+
+    edges[0]->cut = nullptr;
+    edges[0]->mate->cut = nullptr;
+    edges[1]->cut = nullptr;
+    edges[1]->mate->cut = nullptr;
+}
@@ -0,0 +1,153 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- ScalarField Unit Tests
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+#include "Cleaver.h"
+#include "ConstantField.h"
+#include "ScalarField.h"
+#include <cmath>
+#include <vector>
+
+template <typename T>
+void checkBatchMatchesPointwise(cleaver::CenteringType center)
+{
+    const int w = 5, h = 4, d = 3;
+    std::vector<T> data;
+    for (int i = 0; i < w*h*d; i++)
+        data.push_back((T)((i*7) % 11) - (T)4);
+
+    cleaver::ScalarField<T> field(&data[0], w, h, d);
+    field.setCenterType(center);
+    field.setBounds(cleaver::BoundingBox(cleaver::vec3(-1, 0.5, 2), cleaver::vec3(w, h, d)));
+    field.setScale(cleaver::vec3(0.5, 2, 1.25));
+
+    // odd count so the batch has a remainder, some points outside the grid
+    std::vector<cleaver::vec3> points;
+    for (int p = 0; p < 37; p++)
+        points.push_back(cleaver::vec3(-2.0 + 0.37*p, 8.5 - 0.29*p, 1.0 + 0.21*p));
+
+    std::vector<double> batch(points.size());
+    field.valueAt(&points[0], points.size(), &batch[0]);
+    for (size_t p = 0; p < points.size(); p++)
+        ASSERT_EQ(field.valueAt(points[p]), batch[p]);
+}
+
+TEST(ScalarFieldTests, BatchMatchesPointwise)
+{
+    checkBatchMatchesPointwise<float>(cleaver::CellCentered);
+    checkBatchMatchesPointwise<float>(cleaver::NodeCentered);
+    checkBatchMatchesPointwise<double>(cleaver::CellCentered);
+    checkBatchMatchesPointwise<double>(cleaver::NodeCentered);
+    checkBatchMatchesPointwise<int>(cleaver::CellCentered);
+}
+
+TEST(ScalarFieldTests, BatchUsesSubclassLookups)
+{
+    // ConstantField has no data, the batch must go through its valueAt()
+    cleaver::ConstantFloatField field(3.0f, 4, 4, 4);
+    const cleaver::vec3 points[5] = {
+        cleaver::vec3(0.5, 0.5, 0.5), cleaver::vec3(1.5, 2.5, 3.5),
+        cleaver::vec3(3.9, 0.1, 2.2), cleaver::vec3(2, 2, 2),
+        cleaver::vec3(0.1, 3.3, 1.7) };
+
+    double batch[5];
+    const cleaver::AbstractScalarField &base = field;
+    base.valueAt(points, 5, batch);
+    for (int p = 0; p < 5; p++)
+        ASSERT_EQ(3.0, batch[p]);
+}
+
+TEST(ScalarFieldTests, HalfRoundTrip)
+{
+    // every finite and infinite half survives a trip through float
+    for (unsigned int bits = 0; bits < 0x10000; bits++) {
+        float value = cleaver::half::fromBits((unsigned short)bits);
+        if (value != value)
+            continue;
+        ASSERT_EQ(bits, cleaver::half(value).bits());
+    }
+
+    ASSERT_EQ(0x3c00, cleaver::half(1.0f).bits());
+    ASSERT_EQ(0x7bff, cleaver::half(65504.0f).bits());
+    ASSERT_EQ(0x7c00, cleaver::half(65520.0f).bits());
+    ASSERT_EQ(0x0001, cleaver::half(std::ldexp(1.0f, -24)).bits());
+    ASSERT_EQ(0x0000, cleaver::half(std::ldexp(1.0f, -25)).bits());
+    // ties round to even
+    ASSERT_EQ(0x3c00, cleaver::half(1.0f + std::ldexp(1.0f, -11)).bits());
+    ASSERT_EQ(0x3c02, cleaver::half(1.0f + 3*std::ldexp(1.0f, -11)).bits());
+}
+
+TEST(ScalarFieldTests, QuantizedFieldsTrackFloat)
+{
+    const int n = 6;
+    std::vector<float> data;
+    for (int i = 0; i < n*n*n; i++)
+        data.push_back(0.37f*(float)((i*7) % 23) - 3.1f);
+
+    cleaver::FloatField field(&data[0], n, n, n);
+    field.setScale(cleaver::vec3(0.5, 1, 2));
+    field.setName("field");
+
+    std::vector<cleaver::vec3> points;
+    for (int p = 0; p < 41; p++)
+        points.push_back(cleaver::vec3(0.07*p, 5.9 - 0.13*p, 0.29*p));
+
+    const cleaver::FieldPrecision precisions[] = { cleaver::Float16, cleaver::Int16 };
+    for (cleaver::FieldPrecision precision : precisions) {
+        cleaver::AbstractScalarField *quantized =
+          cleaver::createQuantizedField(&field, precision);
+        ASSERT_TRUE(quantized != nullptr);
+        ASSERT_EQ("field", quantized->name());
+        ASSERT_TRUE(field.bounds().size == quantized->bounds().size);
+
+        std::vector<double> batch(points.size());
+        quantized->valueAt(&points[0], points.size(), &batch[0]);
+        for (size_t p = 0; p < points.size(); p++) {
+            ASSERT_NEAR(field.valueAt(points[p]), quantized->valueAt(points[p]), 4e-3);
+            ASSERT_EQ(quantized->valueAt(points[p]), batch[p]);
+        }
+
+        if (precision == cleaver::Float16)
+            delete[] ((cleaver::HalfField*)quantized)->data();
+        else
+            delete[] ((cleaver::Int16Field*)quantized)->data();
+        delete quantized;
+    }
+
+    ASSERT_TRUE(cleaver::createQuantizedField(&field, cleaver::Float32) == nullptr);
+}
@@ -39,8 +39,15 @@
 //  //-------------------------------------------------------------------
 //  //-------------------------------------------------------------------
 #include "TetMesh.h"
+#include "CompactTetMesh.h"
+#include "ThreadPool.h"
 #include "gtest/gtest.h"
 #include <cmath>
+#include <cstdio>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
 
 using namespace cleaver;
 
@@ -96,3 +103,449 @@ TEST(AngleTests,Flat) {
   ASSERT_TRUE(tet2.minAngle() == 0.f || tet2.minAngle() == 180.f);
   ASSERT_TRUE(tet2.maxAngle() == 0.f || tet2.maxAngle() == 180.f);
 }
+
+TEST(HalfEdgeTableTests, FindOrCreate) {
+  HalfEdgeTable table;
+  ASSERT_EQ(nullptr, table.find(0, 1));
+  HalfEdge *e01 = table.findOrCreate(0, 1, true);
+  HalfEdge *e10 = table.findOrCreate(1, 0, false);
+  ASSERT_NE(e01, e10);
+  ASSERT_EQ(e01, table.findOrCreate(0, 1, false));
+  ASSERT_EQ(e10, table.find(1, 0));
+  ASSERT_TRUE(e01->m_long_edge);
+  ASSERT_FALSE(e10->m_long_edge);
+  ASSERT_EQ(2u, table.size());
+
+  // grow well past the initial capacity and page size
+  for (int i = 0; i < 10000; i++)
+    table.findOrCreate(i + 2, i, false);
+  ASSERT_EQ(10002u, table.size());
+  ASSERT_EQ(e01, table.find(0, 1));
+  for (int i = 0; i < 10000; i++)
+    ASSERT_NE(nullptr, table.find(i + 2, i));
+
+  table.sortByIndex();
+  ASSERT_EQ(e01, table[0]);
+  ASSERT_EQ(e10, table[1]);
+
+  table.clear();
+  ASSERT_TRUE(table.empty());
+  ASSERT_EQ(nullptr, table.find(0, 1));
+}
+
+TEST(CompactTetMeshTests, StripMaterial) {
+  // two tets sharing the face (v1,v2,v3)
+  TetMesh mesh;
+  Vertex *v0 = new Vertex(), *v1 = new Vertex(), *v2 = new Vertex();
+  Vertex *v3 = new Vertex(), *v4 = new Vertex();
+  v0->pos() = vec3(0,0,-1);
+  v1->pos() = vec3(1,0,0);
+  v2->pos() = vec3(0,1,0);
+  v3->pos() = vec3(0,0,0);
+  v4->pos() = vec3(0,0,1);
+  mesh.createTet(v0, v1, v2, v3, 0);
+  mesh.createTet(v4, v1, v2, v3, 1);
+  mesh.constructFaces();
+
+  CompactTetMesh compact(mesh);
+  ASSERT_EQ(5u, compact.vertCount());
+  ASSERT_EQ(2u, compact.tetCount());
+  ASSERT_EQ(7u, compact.faceCount());
+  ASSERT_EQ(1, compact.labels[1]);
+  ASSERT_EQ(4, compact.tets[4]);
+
+  compact.constructAdjacency();
+  ASSERT_EQ(2, compact.tetsAroundVertexEnd(1) - compact.tetsAroundVertexBegin(1));
+  ASSERT_EQ(1, compact.tetsAroundVertexEnd(4) - compact.tetsAroundVertexBegin(4));
+
+  compact.stripMaterial(0);
+  ASSERT_EQ(4u, compact.vertCount());
+  ASSERT_EQ(1u, compact.tetCount());
+  ASSERT_EQ(4u, compact.faceCount());
+  ASSERT_EQ(1, compact.labels[0]);
+  ASSERT_EQ(vec3(0,0,1), compact.position(compact.tets[0]));
+  ASSERT_EQ(1, compact.tetsAroundVertexEnd(3) - compact.tetsAroundVertexBegin(3));
+}
+
+TEST(ObjectPoolTests, CreateAndOwn) {
+  ObjectPool<Vertex> pool(16);
+  std::vector<Vertex*> verts;
+  for (int i = 0; i < 100; i++) {
+    verts.push_back(pool.create());
+    verts.back()->tm_v_index = i;
+  }
+  ASSERT_EQ(100u, pool.size());
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(pool.owns(verts[i]));
+    ASSERT_EQ(i, verts[i]->tm_v_index);
+  }
+  Vertex outside;
+  ASSERT_FALSE(pool.owns(&outside));
+
+  ObjectPool<bool> labels(8);
+  bool *lbls = labels.allocate(20);
+  for (int i = 0; i < 20; i++)
+    ASSERT_FALSE(lbls[i]);
+  ASSERT_TRUE(labels.owns(lbls + 19));
+
+  pool.clear();
+  ASSERT_EQ(0u, pool.size());
+  ASSERT_FALSE(pool.owns(verts[0]));
+}
+
+TEST(MaterialLabelsTests, SetTestCompare) {
+  MaterialLabels a(5), b(5);
+  a.set(1); a.set(3);
+  b.set(3); b.set(1);
+  ASSERT_TRUE(a[1] && a[3]);
+  ASSERT_FALSE(a[0] || a[2] || a[4]);
+  ASSERT_TRUE(a.equals(b, 4));
+
+  // background label is ignored when comparing material labels only
+  b.set(4);
+  ASSERT_TRUE(a.equals(b, 4));
+  ASSERT_FALSE(a.equals(b, 5));
+
+  // labels beyond the inline word
+  MaterialLabels c(100);
+  c.set(1); c.set(3); c.set(99);
+  ASSERT_TRUE(c[99]);
+  ASSERT_FALSE(c[98]);
+  ASSERT_TRUE(c.equals(a, 64));
+  ASSERT_FALSE(c.equals(a, 100));
+  MaterialLabels d(c);
+  ASSERT_TRUE(d.equals(c, 256));
+}
+
+TEST(VertexTests, RootCompressesParentChain) {
+  Vertex a, b, c, d;
+  a.pos() = vec3(1, 2, 3);
+  b.parent = &a;
+  c.parent = &b;
+  d.parent = &c;
+
+  ASSERT_EQ(&a, d.root());
+  ASSERT_EQ(&a, d.parent);
+  ASSERT_EQ(&a, c.parent);
+  ASSERT_EQ(&a, b.parent);
+  ASSERT_EQ(nullptr, a.parent);
+  ASSERT_EQ(vec3(1, 2, 3), d.pos());
+  ASSERT_TRUE(d.isEqualTo(&b));
+}
+
+TEST(VertexTests, FindRootLeavesChain) {
+  Vertex a, b, c;
+  b.parent = &a;
+  c.parent = &b;
+
+  ASSERT_EQ(&a, c.findRoot());
+  ASSERT_EQ(&b, c.parent);
+  ASSERT_EQ(&a, a.findRoot());
+}
+
+TEST(TetMeshTests, RemoveTetsCompacts) {
+  // two tets sharing the face (v1,v2,v3)
+  TetMesh mesh;
+  Vertex *v0 = mesh.createVertex(), *v1 = mesh.createVertex();
+  Vertex *v2 = mesh.createVertex(), *v3 = mesh.createVertex();
+  Vertex *v4 = mesh.createVertex();
+  v0->pos() = vec3(0,0,-1);
+  v1->pos() = vec3(1,0,0);
+  v2->pos() = vec3(0,1,0);
+  v3->pos() = vec3(0,0,0);
+  v4->pos() = vec3(0,0,1);
+  mesh.createTet(v0, v1, v2, v3, 0);
+  Tet *kept = mesh.createTet(v4, v1, v2, v3, 1);
+  mesh.constructFaces();
+  mesh.constructBottomUpIncidences();
+
+  mesh.removeMaterial(0);
+  ASSERT_EQ(1u, mesh.tets.size());
+  ASSERT_EQ(kept, mesh.tets[0]);
+  ASSERT_EQ(0, kept->tm_index);
+  ASSERT_EQ(4u, mesh.verts.size());
+  ASSERT_EQ(-1, v0->tm_v_index);
+  ASSERT_EQ(v1, mesh.verts[0]);
+  ASSERT_EQ(v4, mesh.verts[3]);
+  for (size_t v = 0; v < mesh.verts.size(); v++) {
+    ASSERT_EQ(static_cast<int>(v), mesh.verts[v]->tm_v_index);
+    ASSERT_EQ(1u, mesh.verts[v]->tets.size());
+  }
+  ASSERT_EQ(4u, mesh.faces.size());
+}
+
+TEST(TetMeshTests, ConstructFacesLinksNeighbors) {
+  // a fan of three tets: a and b share (v1,v2,v3), b and c share (v1,v2,v4)
+  TetMesh mesh;
+  Vertex *v0 = mesh.createVertex(), *v1 = mesh.createVertex();
+  Vertex *v2 = mesh.createVertex(), *v3 = mesh.createVertex();
+  Vertex *v4 = mesh.createVertex(), *v5 = mesh.createVertex();
+  v0->pos() = vec3(0,0,-1);
+  v1->pos() = vec3(1,0,0);
+  v2->pos() = vec3(0,1,0);
+  v3->pos() = vec3(0,0,0);
+  v4->pos() = vec3(0,0,1);
+  v5->pos() = vec3(1,1,1);
+  Tet *a = mesh.createTet(v0, v1, v2, v3, 0);
+  Tet *b = mesh.createTet(v4, v1, v2, v3, 0);
+  Tet *c = mesh.createTet(v1, v2, v4, v5, 0);
+  mesh.constructFaces();
+
+  // tets[f] is the neighbor across the face opposite verts[f]
+  ASSERT_EQ(b, a->tets[0]);
+  ASSERT_EQ(a, b->tets[0]);
+  ASSERT_EQ(c, b->tets[3]);
+  ASSERT_EQ(b, c->tets[3]);
+
+  // the remaining faces are on the boundary
+  for (int f = 1; f < 4; f++)
+    ASSERT_EQ(nullptr, a->tets[f]);
+  ASSERT_EQ(nullptr, b->tets[1]);
+  ASSERT_EQ(nullptr, b->tets[2]);
+  for (int f = 0; f < 3; f++)
+    ASSERT_EQ(nullptr, c->tets[f]);
+
+  // 12 tet faces, two pairs of them shared
+  ASSERT_EQ(10u, mesh.faces.size());
+}
+
+TEST(TetMeshTests, AdjacencyBuffersMatchLists) {
+  // two tets sharing the face (v1,v2,v3)
+  TetMesh mesh;
+  Vertex *v0 = mesh.createVertex(), *v1 = mesh.createVertex();
+  Vertex *v2 = mesh.createVertex(), *v3 = mesh.createVertex();
+  Vertex *v4 = mesh.createVertex();
+  v0->pos() = vec3(0,0,-1);
+  v1->pos() = vec3(1,0,0);
+  v2->pos() = vec3(0,1,0);
+  v3->pos() = vec3(0,0,0);
+  v4->pos() = vec3(0,0,1);
+  mesh.createTet(v0, v1, v2, v3, 0);
+  mesh.createTet(v4, v1, v2, v3, 1);
+  mesh.constructFaces();
+  mesh.constructBottomUpIncidences();
+  ASSERT_LT(0u, mesh.halfEdges.size());
+
+  // buffers are reused across every call, so stale entries would show
+  std::vector<HalfFace*> faces(1, &mesh.halfFaces[0]);
+  std::vector<Tet*> tets(1, mesh.tets[0]);
+
+  for (size_t v = 0; v < mesh.verts.size(); v++) {
+    Vertex *vertex = mesh.verts[v];
+    mesh.facesAroundVertex(vertex, faces);
+    ASSERT_EQ(mesh.facesAroundVertex(vertex), faces);
+
+    // const references to the vertex's own lists
+    ASSERT_EQ(&vertex->halfEdges, &mesh.edgesAroundVertex(vertex));
+    ASSERT_EQ(&vertex->tets, &mesh.tetsAroundVertex(vertex));
+  }
+
+  for (size_t e = 0; e < mesh.halfEdges.size(); e++) {
+    HalfEdge *edge = mesh.halfEdges[e];
+    mesh.facesAroundEdge(edge, faces);
+    ASSERT_EQ(mesh.facesAroundEdge(edge), faces);
+    mesh.tetsAroundEdge(edge, tets);
+    ASSERT_EQ(mesh.tetsAroundEdge(edge), tets);
+  }
+
+  for (size_t f = 0; f < 4*mesh.tets.size(); f++) {
+    HalfFace *face = &mesh.halfFaces[f];
+    Tet *pair[2];
+    int count = mesh.tetsAroundFace(face, pair);
+    ASSERT_EQ(mesh.tetsAroundFace(face), std::vector<Tet*>(pair, pair + count));
+
+    Vertex *verts[3];
+    TetMesh::vertsAroundFace(face, verts);
+    ASSERT_EQ(mesh.vertsAroundFace(face), std::vector<Vertex*>(verts, verts + 3));
+  }
+
+  for (size_t t = 0; t < mesh.tets.size(); t++) {
+    Tet *tet = mesh.tets[t];
+    Vertex *verts[4];
+    TetMesh::vertsAroundTet(tet, verts);
+    ASSERT_EQ(mesh.vertsAroundTet(tet), std::vector<Vertex*>(verts, verts + 4));
+
+    HalfFace *tet_faces[4];
+    mesh.facesAroundTet(tet, tet_faces);
+    ASSERT_EQ(mesh.facesAroundTet(tet), std::vector<HalfFace*>(tet_faces, tet_faces + 4));
+
+    HalfEdge *edges[6];
+    mesh.edgesAroundTet(tet, edges);
+    ASSERT_EQ(mesh.edgesAroundTet(tet), std::vector<HalfEdge*>(edges, edges + 6));
+  }
+}
+
+TEST(TetMeshTests, ReorderSpatiallyRemapsIndices) {
+  // two tets sharing the face (v1,v2,v3), created far end first
+  TetMesh mesh;
+  Vertex *v0 = mesh.createVertex(), *v1 = mesh.createVertex();
+  Vertex *v2 = mesh.createVertex(), *v3 = mesh.createVertex();
+  Vertex *v4 = mesh.createVertex();
+  v0->pos() = vec3(1,1,1);
+  v1->pos() = vec3(1,0,0);
+  v2->pos() = vec3(0,1,0);
+  v3->pos() = vec3(0,0,1);
+  v4->pos() = vec3(0,0,0);
+  mesh.createTet(v0, v1, v2, v3, 0);
+  Tet *near = mesh.createTet(v4, v1, v2, v3, 1);
+  mesh.constructFaces();
+
+  mesh.reorderSpatially();
+  ASSERT_EQ(v4, mesh.verts[0]);
+  ASSERT_EQ(v0, mesh.verts[4]);
+  ASSERT_EQ(near, mesh.tets[0]);
+  for (size_t v = 0; v < mesh.verts.size(); v++)
+    ASSERT_EQ(static_cast<int>(v), mesh.verts[v]->tm_v_index);
+  for (size_t t = 0; t < mesh.tets.size(); t++)
+    ASSERT_EQ(static_cast<int>(t), mesh.tets[t]->tm_index);
+
+  // every face still references verts of the tets it names
+  for (size_t f = 0; f < mesh.faces.size(); f++) {
+    Face *face = mesh.faces[f];
+    Tet *tet = mesh.tets[face->tets[0]];
+    Vertex *opposite = tet->verts[face->face_index[0]];
+    for (int v = 0; v < 3; v++) {
+      ASSERT_TRUE(tet->contains(mesh.verts[face->verts[v]]));
+      ASSERT_NE(opposite, mesh.verts[face->verts[v]]);
+    }
+  }
+}
+
+TEST(CompactTetMeshTests, ReorderRCM) {
+  // strip of tets along x, vertices created in scrambled order
+  TetMesh mesh;
+  const int n = 12;
+  std::vector<Vertex*> verts(2*n);
+  for (int i = 0; i < n; i++) {
+    int a = (7*i) % n;
+    verts[2*a+0] = mesh.createVertex();
+    verts[2*a+0]->pos() = vec3(a, 0, 0);
+    verts[2*a+1] = mesh.createVertex();
+    verts[2*a+1]->pos() = vec3(a, 1, (a % 2) ? 1 : 0);
+  }
+  for (int i = 0; i + 1 < n; i++) {
+    int a = (5*i) % (n - 1);
+    mesh.createTet(verts[2*a], verts[2*a+1], verts[2*a+2], verts[2*a+3], a % 3);
+  }
+  mesh.constructFaces();
+
+  CompactTetMesh compact(mesh);
+  // tag each tet so it can be followed through the reordering
+  std::vector<double> signature(compact.tetCount());
+  for (size_t t = 0; t < compact.tetCount(); t++) {
+    compact.parents[t] = static_cast<int32_t>(t);
+    signature[t] = compact.position(compact.tets[4*t]).x + compact.labels[t];
+  }
+  size_t before = compact.bandwidth();
+
+  compact.reorderRCM();
+  ASSERT_LE(compact.bandwidth(), before);
+  ASSERT_LE(compact.bandwidth(), 3u);
+
+  // tets sorted by lowest vertex, and carried their attributes along
+  int32_t last = -1;
+  for (size_t t = 0; t < compact.tetCount(); t++) {
+    const int32_t *tet = &compact.tets[4*t];
+    int32_t lo = std::min(std::min(tet[0], tet[1]), std::min(tet[2], tet[3]));
+    ASSERT_LE(last, lo);
+    last = lo;
+    ASSERT_EQ(signature[compact.parents[t]], compact.position(tet[0]).x + compact.labels[t]);
+  }
+
+  // faces still name verts of their tets
+  for (size_t f = 0; f < compact.faceCount(); f++) {
+    const int32_t *tet = &compact.tets[4*compact.faceTets[2*f]];
+    for (int v = 0; v < 3; v++) {
+      int32_t vert = compact.faces[3*f+v];
+      ASSERT_TRUE(vert == tet[0] || vert == tet[1] || vert == tet[2] || vert == tet[3]);
+    }
+  }
+}
+
+TEST(ThreadPoolTests, ParallelForCoversRange) {
+  ThreadPool pool(4);
+  ASSERT_EQ(4u, pool.threadCount());
+
+  std::vector<int> hits(10000, 0);
+  std::atomic<size_t> callerItems(0);
+  pool.parallelFor(0, hits.size(), 64, [&](size_t begin, size_t end, unsigned int thread) {
+    ASSERT_LT(thread, 4u);
+    ASSERT_LE(end - begin, 64u);
+    for (size_t i = begin; i < end; i++)
+      hits[i]++;
+    if (thread == 0)
+      callerItems += end - begin;
+  });
+  for (size_t i = 0; i < hits.size(); i++)
+    ASSERT_EQ(1, hits[i]);
+
+  // nested loops run inline instead of deadlocking
+  std::atomic<int> inner(0);
+  pool.parallelFor(0, 8, 1, [&](size_t, size_t, unsigned int) {
+    pool.parallelFor(0, 100, 10, [&](size_t begin, size_t end, unsigned int) {
+      inner += static_cast<int>(end - begin);
+    });
+  });
+  ASSERT_EQ(800, inner.load());
+
+  // errors reach the caller
+  ASSERT_THROW(pool.parallelFor(0, 1000, 10, [](size_t begin, size_t, unsigned int) {
+    if (begin == 500) throw std::runtime_error("fail");
+  }), std::runtime_error);
+
+  pool.setThreadCount(1);
+  ASSERT_EQ(1u, pool.threadCount());
+}
+
+TEST(CompactTetMeshTests, PooledWritersMatchSerial) {
+  // enough lines that the pooled writer formats several batches
+  CompactTetMesh mesh;
+  const size_t n = 100003;
+  for (size_t i = 0; i < n; i++) {
+    mesh.positions.push_back(0.1 * i);
+    mesh.positions.push_back(-1.7 * i);
+    mesh.positions.push_back(1.0 / (i + 1));
+    for (int v = 0; v < 4; v++)
+      mesh.tets.push_back(static_cast<int32_t>((i + v) % n));
+    mesh.labels.push_back(static_cast<char>(i % 5));
+    mesh.parents.push_back(static_cast<int32_t>(i / 3));
+  }
+
+  ThreadPool pool(3);
+  mesh.writeNodeEle("serial_writer", false, true, true);
+  mesh.writeNodeEle("pooled_writer", false, true, true, &pool);
+
+  const char *extensions[] = { ".node", ".ele" };
+  for (int e = 0; e < 2; e++) {
+    std::string serial = std::string("serial_writer") + extensions[e];
+    std::string pooled = std::string("pooled_writer") + extensions[e];
+    std::ifstream a(serial.c_str()), b(pooled.c_str());
+    std::stringstream sa, sb;
+    sa << a.rdbuf();
+    sb << b.rdbuf();
+    a.close();
+    b.close();
+    std::remove(serial.c_str());
+    std::remove(pooled.c_str());
+    ASSERT_FALSE(sa.str().empty());
+    ASSERT_EQ(sa.str(), sb.str());
+  }
+}
+
+TEST(TetMeshTests, ThreadVertexPools) {
+  TetMesh mesh;
+  mesh.setAllocationThreads(4);
+
+  // each thread allocates from its own pool
+  std::vector<Vertex*> made(4, nullptr);
+  ThreadPool pool(4);
+  pool.parallelFor(0, 4, 1, [&](size_t begin, size_t, unsigned int thread) {
+    made[begin] = mesh.createVertex(2, thread);
+  });
+  for (size_t i = 0; i < made.size(); i++) {
+    ASSERT_NE(nullptr, made[i]);
+    made[i]->tm_v_index = static_cast<int>(i);
+    mesh.verts.push_back(made[i]);
+  }
+  // pooled vertices are released with the mesh, not deleted individually
+}
@@ -0,0 +1,260 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- Volume Unit Tests
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//  University of Utah
+//
+//  Permission is  hereby  granted, free  of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files  ( the "Software" ),  to  deal in  the  Software without
+//  restriction, including  without limitation the rights to  use,
+//  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  sell copies of the Software, and to permit persons to whom the
+//  Software is  furnished  to do  so,  subject  to  the following
+//  conditions:
+//
+//  The above  copyright notice  and  this permission notice shall
+//  be included  in  all copies  or  substantial  portions  of the
+//  Software.
+//
+//  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  USE OR OTHER DEALINGS IN THE SOFTWARE.
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+#include "ConstantField.h"
+#include "ScalarField.h"
+#include "Volume.h"
+#include "InterleavedVolume.h"
+#include "LabelVolume.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+TEST(VolumeTests, BatchedLookupsMatchPerMaterial)
+{
+    const int n = 4;
+    std::vector<float> data[3];
+    std::vector<cleaver::AbstractScalarField*> fields;
+    for (int m = 0; m < 3; m++) {
+        for (int i = 0; i < n*n*n; i++)
+            data[m].push_back((float)((i*(m + 3)) % 7) - 3.0f);
+        fields.push_back(new cleaver::FloatField(&data[m][0], n, n, n));
+    }
+
+    const cleaver::vec3 samples[] = {
+        cleaver::vec3(0.5, 0.5, 0.5), cleaver::vec3(1.3, 2.7, 0.9),
+        cleaver::vec3(3.9, 0.1, 2.2), cleaver::vec3(-1.0, 5.0, 2.0) };
+    const int subset[2] = { 2, 0 };
+
+    // shared grid, then a rescaled field forcing per-material lookups
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1)
+            ((cleaver::FloatField*)fields[1])->setScale(cleaver::vec3(2, 2, 2));
+        cleaver::Volume volume(fields);
+
+        for (const cleaver::vec3 &x : samples) {
+            double all[3], some[2];
+            volume.valuesAt(x, all);
+            volume.valuesAt(x, subset, 2, some);
+
+            int label = 0;
+            for (int m = 0; m < 3; m++) {
+                ASSERT_EQ(volume.valueAt(x, m), all[m]);
+                if (all[m] > all[label])
+                    label = m;
+            }
+            ASSERT_EQ(all[2], some[0]);
+            ASSERT_EQ(all[0], some[1]);
+            ASSERT_EQ(label, volume.argmaxAt(x));
+            ASSERT_EQ(label, volume.maxAt(x));
+        }
+
+        int labels[4];
+        volume.argmaxAt(samples, 4, labels);
+        for (int i = 0; i < 4; i++)
+            ASSERT_EQ(volume.argmaxAt(samples[i]), labels[i]);
+    }
+
+    for (size_t m = 0; m < fields.size(); m++)
+        delete fields[m];
+}
+
+TEST(VolumeTests, SubclassedFieldsUsePointLookups)
+{
+    // constant fields have no data, their own valueAt() must be used
+    cleaver::BoundingBox bounds(cleaver::vec3::zero, cleaver::vec3(4, 4, 4));
+    std::vector<cleaver::AbstractScalarField*> fields;
+    fields.push_back(new cleaver::ConstantFloatField(1.0f, bounds));
+    fields.push_back(new cleaver::ConstantFloatField(3.0f, bounds));
+    cleaver::Volume volume(fields);
+
+    cleaver::vec3 x(1.5, 2.5, 0.5);
+    double all[2];
+    volume.valuesAt(x, all);
+    ASSERT_EQ(1.0, all[0]);
+    ASSERT_EQ(3.0, all[1]);
+    ASSERT_EQ(1, volume.argmaxAt(x));
+    ASSERT_EQ(1, volume.maxAt(x));
+
+    const cleaver::vec3 batch[5] = {
+        x, cleaver::vec3(0.5, 0.5, 0.5), cleaver::vec3(3.5, 3.5, 3.5),
+        cleaver::vec3(2, 1, 3), cleaver::vec3(0.2, 3.9, 1.1) };
+    int labels[5];
+    volume.argmaxAt(batch, 5, labels);
+    for (int i = 0; i < 5; i++)
+        ASSERT_EQ(1, labels[i]);
+
+    for (size_t m = 0; m < fields.size(); m++)
+        delete fields[m];
+}
+
+TEST(VolumeTests, SharedGridFollowsFieldChanges)
+{
+    const int n = 4;
+    std::vector<float> data[2];
+    std::vector<cleaver::AbstractScalarField*> fields;
+    for (int m = 0; m < 2; m++) {
+        for (int i = 0; i < n*n*n; i++)
+            data[m].push_back((float)((i*(m + 2)) % 5) - 2.0f);
+        fields.push_back(new cleaver::FloatField(&data[m][0], n, n, n));
+    }
+    cleaver::Volume volume(fields);
+
+    // rescaling a field after construction takes it off the shared grid
+    ((cleaver::FloatField*)fields[1])->setScale(cleaver::vec3(2, 2, 2));
+    const cleaver::vec3 samples[] = {
+        cleaver::vec3(0.5, 0.5, 0.5), cleaver::vec3(1.3, 2.7, 0.9),
+        cleaver::vec3(3.9, 0.1, 2.2) };
+    for (const cleaver::vec3 &x : samples) {
+        double all[2];
+        volume.valuesAt(x, all);
+        ASSERT_EQ(volume.valueAt(x, 0), all[0]);
+        ASSERT_EQ(volume.valueAt(x, 1), all[1]);
+    }
+
+    for (size_t m = 0; m < fields.size(); m++)
+        delete fields[m];
+}
+
+TEST(VolumeTests, InterleavedMatchesSeparateFields)
+{
+    const int n = 4;
+    std::vector<float> data[3];
+    std::vector<cleaver::AbstractScalarField*> fields;
+    for (int m = 0; m < 3; m++) {
+        for (int i = 0; i < n*n*n; i++)
+            data[m].push_back((float)((i*(m + 5)) % 9) - 4.0f);
+        fields.push_back(new cleaver::FloatField(&data[m][0], n, n, n));
+    }
+
+    cleaver::Volume volume(fields);
+    cleaver::InterleavedVolume interleaved(volume);
+    ASSERT_EQ(3, interleaved.numberOfMaterials());
+
+    const cleaver::vec3 samples[] = {
+        cleaver::vec3(0.5, 0.5, 0.5), cleaver::vec3(1.3, 2.7, 0.9),
+        cleaver::vec3(3.9, 0.1, 2.2), cleaver::vec3(-1.0, 5.0, 2.0) };
+    const int subset[2] = { 1, 2 };
+
+    for (const cleaver::vec3 &x : samples) {
+        double all[3], some[2];
+        interleaved.valuesAt(x, all);
+        interleaved.valuesAt(x, subset, 2, some);
+        for (int m = 0; m < 3; m++) {
+            ASSERT_EQ(volume.valueAt(x, m), interleaved.valueAt(x, m));
+            ASSERT_EQ(volume.valueAt(x, m), all[m]);
+        }
+        ASSERT_EQ(all[1], some[0]);
+        ASSERT_EQ(all[2], some[1]);
+        ASSERT_EQ(volume.argmaxAt(x), interleaved.argmaxAt(x));
+    }
+
+    // the packed materials can't be changed afterwards
+    ASSERT_THROW(interleaved.addMaterial(fields[0]), std::runtime_error);
+    ASSERT_THROW(interleaved.removeMaterial(fields[0]), std::runtime_error);
+    ASSERT_EQ(3, interleaved.numberOfMaterials());
+
+    // fields without data of their own can't be interleaved
+    cleaver::ConstantFloatField constant(1.0f, n, n, n);
+    std::vector<cleaver::AbstractScalarField*> constants(2, &constant);
+    cleaver::Volume constantVolume(constants);
+    ASSERT_THROW(cleaver::InterleavedVolume none(constantVolume), std::runtime_error);
+
+    // materials on different grids can't be interleaved
+    ((cleaver::FloatField*)fields[2])->setScale(cleaver::vec3(2, 2, 2));
+    cleaver::Volume mismatched(fields);
+    ASSERT_THROW(cleaver::InterleavedVolume bad(mismatched), std::runtime_error);
+
+    for (size_t m = 0; m < fields.size(); m++)
+        delete fields[m];
+}
+
+TEST(VolumeTests, LabelVolumeFromPlanarSegmentation)
+{
+    // material 0 below x = 8, material 1 above
+    const int n = 32;
+    std::vector<unsigned short> labels(n*n*n);
+    for (int k = 0; k < n; k++)
+        for (int j = 0; j < n; j++)
+            for (int i = 0; i < n; i++)
+                labels[i + j*n + k*n*n] = (i < 8) ? 0 : 1;
+
+    cleaver::vec3 spacing(1, 1, 1);
+    cleaver::LabelVolume volume(&labels[0], n, n, n, 2, spacing, 1.0);
+    ASSERT_EQ(2, volume.numberOfMaterials());
+    ASSERT_EQ(1, volume.labelAt(8, 3, 3));
+    ASSERT_DOUBLE_EQ(3.0, volume.band());
+
+    // only the two brick columns beside the boundary keep values
+    ASSERT_EQ(64u, volume.brickCount());
+    ASSERT_EQ(32u, volume.bandBrickCount());
+
+    // values approximate the signed distance, clamped to the band
+    for (double x = 6; x <= 10; x += 0.25) {
+        cleaver::vec3 p(x, 16.5, 16.5);
+        double expected = x - 8;
+        ASSERT_NEAR(expected, volume.valueAt(p, 1), 0.1);
+        ASSERT_NEAR(-expected, volume.valueAt(p, 0), 0.1);
+        if (std::fabs(x - 8) > 0.2) {
+            ASSERT_EQ(x < 8 ? 0 : 1, volume.argmaxAt(p));
+        }
+    }
+    ASSERT_EQ(3.0, volume.valueAt(cleaver::vec3(28.5, 5.5, 5.5), 1));
+    ASSERT_EQ(-3.0, volume.valueAt(cleaver::vec3(28.5, 5.5, 5.5), 0));
+
+    // each material has a named field sampling the volume
+    cleaver::vec3 q(7.7, 3.2, 9.9);
+    ASSERT_EQ("label 1", volume.getMaterial(1)->name());
+    ASSERT_EQ(volume.valueAt(q, 1), volume.getMaterial(1)->valueAt(q));
+    ASSERT_THROW(volume.addMaterial(volume.getMaterial(0)), std::runtime_error);
+    ASSERT_THROW(volume.removeMaterial(volume.getMaterial(0)), std::runtime_error);
+    ASSERT_EQ(2, volume.numberOfMaterials());
+
+    // a pooled build stores the same values
+    cleaver::ThreadPool pool(3);
+    cleaver::LabelVolume pooled(&labels[0], n, n, n, 2, spacing, 1.0, &pool);
+    for (double x = 0.5; x < n; x += 0.75) {
+        cleaver::vec3 p(x, 7.25, 20.5);
+        double values[2];
+        pooled.valuesAt(p, values);
+        ASSERT_EQ(volume.valueAt(p, 0), values[0]);
+        ASSERT_EQ(volume.valueAt(p, 1), values[1]);
+    }
+}
@@ -0,0 +1,102 @@
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+// Cleaver - A MultiMaterial Conforming Tetrahedral Meshing Library
+//
+// -- Cleaver-CLI Tests
+//
+//-------------------------------------------------------------------
+//-------------------------------------------------------------------
+//
+//  Copyright (C) 2026
+//  Scientific Computing & Imaging Institute
+//
+//  University of Utah
+//  //
+//  //  Permission is  hereby  granted, free  of charge, to any person
+//  //  obtaining a copy of this software and associated documentation
+//  //  files  ( the "Software" ),  to  deal in  the  Software without
+//  //  restriction, including  without limitation the rights to  use,
+//  //  copy, modify,  merge, publish, distribute, sublicense,  and/or
+//  //  sell copies of the Software, and to permit persons to whom the
+//  //  Software is  furnished  to do  so,  subject  to  the following
+//  //  conditions:
+//  //
+//  //  The above  copyright notice  and  this permission notice shall
+//  //  be included  in  all copies  or  substantial  portions  of the
+//  //  Software.
+//  //
+//  //  THE SOFTWARE IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY  OF ANY
+//  //  KIND,  EXPRESS OR IMPLIED, INCLUDING  BUT NOT  LIMITED  TO THE
+//  //  WARRANTIES   OF  MERCHANTABILITY,  FITNESS  FOR  A  PARTICULAR
+//  //  PURPOSE AND NONINFRINGEMENT. IN NO EVENT  SHALL THE AUTHORS OR
+//  //  COPYRIGHT HOLDERS  BE  LIABLE FOR  ANY CLAIM, DAMAGES OR OTHER
+//  //  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+//  //  ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+//  //  USE OR OTHER DEALINGS IN THE SOFTWARE.
+//  //-------------------------------------------------------------------
+//  //-------------------------------------------------------------------
+#include "cli_common.h"
+#include <iterator>
+
+namespace {
+
+std::string readFile(const std::string &file) {
+  std::ifstream stream(file.c_str(), std::ifstream::in | std::ifstream::binary);
+  return std::string((std::istreambuf_iterator<char>(stream)),
+                      std::istreambuf_iterator<char>());
+}
+
+// Runs the basic spheres at 1, 2 and all hardware threads and
+// expects byte for byte the same node and ele files from each.
+// Flags pick the path under test, with or without --deterministic.
+void compareThreadCounts(const std::string &flags) {
+  // Make sure there is a command interpreter.
+  ASSERT_EQ(0,(int)!(std::system(NULL)));
+
+  const std::string threads[] = { "1", "2", "0" };
+  const std::string log = "threads_output.txt";
+  for (size_t i = 0; i < 3; i++) {
+    std::string line = command + _NAME + "threads" + threads[i] + path + input +
+      " --threads " + threads[i] + flags +
+      " > " + data_dir + log + " 2>&1";
+    ASSERT_EQ(0, std::system(line.c_str()));
+  }
+
+  const std::string node = readFile(data_dir + "threads1.node");
+  const std::string ele  = readFile(data_dir + "threads1.ele");
+  ASSERT_FALSE(node.empty());
+  ASSERT_FALSE(ele.empty());
+  for (size_t i = 1; i < 3; i++) {
+    EXPECT_TRUE(node == readFile(data_dir + "threads" + threads[i] + ".node"))
+      << "node files differ at --threads " << threads[i];
+    EXPECT_TRUE(ele == readFile(data_dir + "threads" + threads[i] + ".ele"))
+      << "ele files differ at --threads " << threads[i];
+  }
+
+  // Delete the output files from this test.
+  for (size_t i = 0; i < 3; i++) {
+    system_execute(RM_CMMD,data_dir + "threads" + threads[i] + ".info");
+    system_execute(RM_CMMD,data_dir + "threads" + threads[i] + ".node");
+    system_execute(RM_CMMD,data_dir + "threads" + threads[i] + ".ele");
+  }
+  system_execute(RM_CMMD,data_dir + log);
+}
+
+}
+
+TEST(CLIRegressionTests, DeterministicThreads) {
+  EXPECT_NO_FATAL_FAILURE(compareThreadCounts(" --deterministic"));
+}
+
+TEST(CLIRegressionTests, DeterministicParallelWarp) {
+  EXPECT_NO_FATAL_FAILURE(compareThreadCounts(" --deterministic --parallel_warp"));
+}
+
+TEST(CLIRegressionTests, DefaultThreads) {
+  EXPECT_NO_FATAL_FAILURE(compareThreadCounts(""));
+}
+
+TEST(CLIRegressionTests, DefaultParallelWarp) {
+  EXPECT_NO_FATAL_FAILURE(compareThreadCounts(" --parallel_warp"));
+}